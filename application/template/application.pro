@@ -19,46 +19,12 @@ DEFINES += HAS_SERIALPORT
 # Bluetooth available
 #DEFINES += HAS_BLUETOOTH
 
-contains(DEFINES, HAS_SERIALPORT) {
-    QT += serialport
-}
-
-contains(DEFINES, HAS_BLUETOOTH) {
-    QT += bluetooth
-}
-
 SOURCES += main.cpp\
-    mainwindow.cpp \
-    commands.cpp \
-    configparam.cpp \
-    configparams.cpp \
-    packet.cpp \
-    openroadinterface.cpp \
-    vbytearray.cpp \
-    utility.cpp \
-    tcpserversimple.cpp
+    mainwindow.cpp
 
-HEADERS  += mainwindow.h \
-    commands.h \
-    configparam.h \
-    configparams.h \
-    datatypes.h \
-    packet.h \
-    openroadinterface.h \
-    vbytearray.h \
-    utility.h \
-    tcpserversimple.h
+HEADERS  += mainwindow.h
 
 FORMS += mainwindow.ui
-    
-contains(DEFINES, HAS_BLUETOOTH) {
-    SOURCES += bleuart.cpp
-    HEADERS += bleuart.h
-}
 
+include(core.pri)
 include(widgets/widgets.pri)
-include(lzokay/lzokay.pri)
-
-RESOURCES += \
-    res_config.qrc
-
@@ -20,43 +20,10 @@ DEFINES += HAS_SERIALPORT
 # Bluetooth available
 #DEFINES += HAS_BLUETOOTH
 
-contains(DEFINES, HAS_SERIALPORT) {
-    QT += serialport
-}
-
-contains(DEFINES, HAS_BLUETOOTH) {
-    QT += bluetooth
-}
-
-SOURCES += main.cpp\
-    commands.cpp \
-    configparam.cpp \
-    configparams.cpp \
-    packet.cpp \
-    openroadinterface.cpp \
-    vbytearray.cpp \
-    utility.cpp \
-    tcpserversimple.cpp
-
-HEADERS  += commands.h \
-    configparam.h \
-    configparams.h \
-    datatypes.h \
-    packet.h \
-    openroadinterface.h \
-    vbytearray.h \
-    utility.h \
-    tcpserversimple.h
-    
-contains(DEFINES, HAS_BLUETOOTH) {
-    SOURCES += bleuart.cpp
-    HEADERS += bleuart.h
-}
+SOURCES += main.cpp
 
+include(core.pri)
 include(widgets/widgets.pri)
-include(lzokay/lzokay.pri)
 
 RESOURCES += \
-    qml.qrc \
-    res_config.qrc
-
+    qml.qrc
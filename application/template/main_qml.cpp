@@ -26,7 +26,7 @@ QObject *openroadinterface_singletontype_provider(QQmlEngine *engine, QJSEngine
     (void)scriptEngine;
 
     OpenroadInterface *openroad = new OpenroadInterface();
-	openroad->fwConfig()->loadParamsXml("://res/config/fw.xml");
+	openroad->fwConfig()->loadParamsCached("://res/config/fw.xml");
     Utility::configLoadLatest(openroad);
 
     return openroad;
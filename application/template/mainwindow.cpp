@@ -26,7 +26,7 @@ MainWindow::MainWindow(QWidget *parent) :
     ui->setupUi(this);
 	
 	mOpenroad = new OpenroadInterface(this);
-    mOpenroad->fwConfig()->loadParamsXml("://res/config/fw.xml");
+    mOpenroad->fwConfig()->loadParamsCached("://res/config/fw.xml");
     Utility::configLoadLatest(mOpenroad);
 
     mTimer = new QTimer(this);
@@ -0,0 +1,367 @@
+/*
+    Copyright 2020 Benjamin Vedder	benjamin@vedder.se
+
+    This file is part of VESC Tool.
+
+    VESC Tool is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    VESC Tool is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+    */
+
+#include "clitool.h"
+#include "openroadinterface.h"
+#include "utility.h"
+#include "lzologdevice.h"
+#include "logbatchanalysis.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QtConcurrent>
+#include <QThreadPool>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QMutex>
+#include <QRegularExpression>
+#include <QDir>
+#include <QFile>
+#include <cstdio>
+
+namespace {
+const int fwRxTimeoutMs = 5000;
+const int fwSizeMax = 400000;
+
+// All interfaces share the same settings and store them when deleted.
+// The configuration backups are in a store that the interfaces share.
+QMutex settingsMutex;
+QMutex printMutex;
+}
+
+/**
+ * @brief CliTool::isCliArgs
+ * Check if VESC Tool was started in command line mode, before any
+ * application object is created.
+ */
+bool CliTool::isCliArgs(int argc, char *argv[])
+{
+    return argc > 1 && (QString(argv[1]) == "--cli" || QString(argv[1]) == "--log-report");
+}
+
+/**
+ * @brief CliTool::run
+ * Run the command line mode. A QCoreApplication has to exist.
+ *
+ * @param arguments
+ * The arguments of the application, starting with --cli.
+ *
+ * @return
+ * The exit code of the application.
+ */
+int CliTool::run(const QStringList &arguments)
+{
+    QStringList args = arguments;
+
+    if (args.size() > 1) {
+        // --log-report <dir> <report> is kept as a short form
+        if (args.at(1) == "--log-report") {
+            args[1] = "log-report";
+        } else {
+            args.removeAt(1);
+        }
+    }
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("VESC Tool command line mode. Commands:\n"
+                                     "  info                      Print firmware and UUID\n"
+                                     "  backup                    Store configuration backups\n"
+                                     "  restore                   Restore configuration backups\n"
+                                     "  fw-upload <file>          Upload firmware\n"
+                                     "  telemetry <dir> <seconds> Record realtime data logs\n"
+                                     "  log-convert <in> <out>    Convert between .csv and ." +
+                                     LzoLogDevice::fileSuffix() + " logs\n"
+                                     "  log-report <dir> <report> Write a .csv or .json report of all logs");
+    parser.addHelpOption();
+    parser.addPositionalArgument("command", "Command to run.");
+    parser.addPositionalArgument("args", "Arguments of the command.", "[args...]");
+
+    QCommandLineOption portOption("port", "Serial port or tcp://host:port to run the command "
+                                          "on. Can be given several times.", "port");
+    QCommandLineOption baudOption("baud", "Serial port baudrate.", "baud", "115200");
+    QCommandLineOption canOption("can", "Include the VESCs on the CAN-bus.");
+    QCommandLineOption bootloaderOption("bootloader", "Upload a bootloader instead of firmware.");
+    QCommandLineOption compressOption("compress", "Compress telemetry logs.");
+    QCommandLineOption nameOption("name", "Name of configuration backups.", "name");
+    QCommandLineOption rateOption("rate", "Telemetry sample rate in Hz.", "rate", "20");
+
+    parser.addOption(portOption);
+    parser.addOption(baudOption);
+    parser.addOption(canOption);
+    parser.addOption(bootloaderOption);
+    parser.addOption(compressOption);
+    parser.addOption(nameOption);
+    parser.addOption(rateOption);
+
+    parser.process(args);
+
+    QStringList pos = parser.positionalArguments();
+    if (pos.isEmpty()) {
+        parser.showHelp(1);
+    }
+
+    Job job;
+    job.command = pos.takeFirst();
+    job.args = pos;
+    job.can = parser.isSet(canOption);
+    job.bootloader = parser.isSet(bootloaderOption);
+    job.compress = parser.isSet(compressOption);
+    job.name = parser.value(nameOption);
+    job.baud = parser.value(baudOption).toInt();
+    job.rate = qBound(1, parser.value(rateOption).toInt(), 1000);
+
+    if (job.command == "log-convert" && job.args.size() == 2) {
+        return logConvert(job.args.at(0), job.args.at(1)) ? 0 : 1;
+    } else if (job.command == "log-report" && job.args.size() == 2) {
+        return logReport(job.args.at(0), job.args.at(1)) ? 0 : 1;
+    }
+
+    QStringList portCommands;
+    portCommands << "info" << "backup" << "restore" << "fw-upload" << "telemetry";
+    int argsNeeded = job.command == "fw-upload" ? 1 : (job.command == "telemetry" ? 2 : 0);
+
+    if (!portCommands.contains(job.command) || job.args.size() != argsNeeded) {
+        print("", "Invalid command or number of arguments");
+        parser.showHelp(1);
+    }
+
+    QStringList ports = parser.values(portOption);
+    if (ports.isEmpty()) {
+        print("", "No port given");
+        return 1;
+    }
+
+    // One thread per port, so that slow ports do not hold up the others
+    QThreadPool pool;
+    pool.setMaxThreadCount(ports.size());
+
+    QList<QFuture<bool> > futures;
+    for (const auto &p: ports) {
+        futures.append(QtConcurrent::run(&pool, &CliTool::runPort, p, job));
+    }
+
+    int failed = 0;
+    for (int i = 0;i < futures.size();i++) {
+        if (!futures[i].result()) {
+            failed++;
+        }
+    }
+
+    if (ports.size() > 1) {
+        print("", QString("%1 of %2 ports succeeded").
+              arg(ports.size() - failed).arg(ports.size()));
+    }
+
+    return failed == 0 ? 0 : 1;
+}
+
+bool CliTool::runPort(QString port, const Job &job)
+{
+    // Gives this pool thread an event dispatcher before the timers of the
+    // interface are started.
+    QEventLoop dispatcherInit;
+    (void)dispatcherInit;
+
+    OpenroadInterface *openroad = new OpenroadInterface;
+
+    QObject::connect(openroad, &OpenroadInterface::statusMessage,
+                     [port](const QString &msg, bool isGood) {
+        print(port, (isGood ? "" : "Warning: ") + msg);
+    });
+
+    QObject::connect(openroad, &OpenroadInterface::messageDialog,
+                     [port](const QString &title, const QString &msg, bool isGood, bool richText) {
+        QString text = msg;
+        if (richText) {
+            text.remove(QRegularExpression("<[^>]*>"));
+        }
+        print(port, title + (isGood ? ": " : " failed: ") + text);
+    });
+
+    bool res = connectPort(openroad, port, job.baud);
+
+    if (res) {
+        res = runCommand(openroad, port, job);
+        openroad->disconnectPort();
+    }
+
+    {
+        QMutexLocker locker(&settingsMutex);
+        delete openroad;
+    }
+
+    return res;
+}
+
+bool CliTool::connectPort(OpenroadInterface *openroad, QString port, int baud)
+{
+    if (port.startsWith("tcp://")) {
+        QString hostPort = port.mid(6);
+        int sep = hostPort.lastIndexOf(':');
+        if (sep < 0) {
+            openroad->connectTcp(hostPort, 65102);
+        } else {
+            openroad->connectTcp(hostPort.left(sep), hostPort.mid(sep + 1).toInt());
+        }
+    } else if (!openroad->connectSerial(port, baud)) {
+        print(port, "Could not open port");
+        return false;
+    }
+
+    QElapsedTimer t;
+    t.start();
+    while (!openroad->fwRx() && t.elapsed() < fwRxTimeoutMs) {
+        Utility::sleepWithEventLoop(20);
+    }
+
+    if (!openroad->fwRx()) {
+        print(port, "No response from VESC");
+        return false;
+    }
+
+    return true;
+}
+
+bool CliTool::runCommand(OpenroadInterface *openroad, QString port, const Job &job)
+{
+    bool res = false;
+
+    if (job.command == "info") {
+        print(port, QString("Firmware %1, UUID %2").
+              arg(openroad->getFirmwareNow()).arg(openroad->getConnectedUuid()));
+        res = true;
+    } else if (job.command == "backup") {
+        res = openroad->confStoreBackup(job.can, job.name);
+    } else if (job.command == "restore") {
+        res = openroad->confRestoreBackup(job.can);
+    } else if (job.command == "fw-upload") {
+        QFile file(job.args.at(0));
+        if (!file.open(QIODevice::ReadOnly)) {
+            print(port, "Could not open " + file.fileName());
+            return false;
+        }
+
+        if (file.size() > fwSizeMax) {
+            print(port, "The file is too large to be a firmware");
+            return false;
+        }
+
+        QString statusLast;
+        QObject::connect(openroad, &OpenroadInterface::fwUploadStatus,
+                         [port, &statusLast](const QString &status, double progress, bool isOngoing) {
+            (void)isOngoing;
+            if (status != statusLast) {
+                print(port, QString("%1 (%2 %)").arg(status).arg(progress * 100.0, 0, 'f', 0));
+                statusLast = status;
+            }
+        });
+
+        QByteArray data = file.readAll();
+        res = openroad->fwUpload(data, job.bootloader, job.can);
+        print(port, openroad->getFwUploadStatus());
+    } else if (job.command == "telemetry") {
+        // Every port logs to its own directory, as the log file names
+        // only contain the time.
+        QString portName = port;
+        portName.replace(QRegularExpression("[^A-Za-z0-9]+"), "_");
+        QString dir = QDir(job.args.at(0)).filePath(portName);
+
+        if (!openroad->openRtLogFile(dir, job.compress)) {
+            return false;
+        }
+
+        QTimer pollTimer;
+        QObject::connect(&pollTimer, &QTimer::timeout, [openroad]() {
+            openroad->commands()->getValuesSubscribed();
+            openroad->commands()->getValuesSetup();
+            openroad->commands()->getImuData(0xFFFF);
+        });
+        pollTimer.start(1000 / job.rate);
+
+        Utility::sleepWithEventLoop(int(job.args.at(1).toDouble() * 1000.0));
+
+        pollTimer.stop();
+        openroad->closeRtLogFile();
+        print(port, QString("Logged %1 samples to %2").arg(openroad->getRtLogSize()).arg(dir));
+        res = true;
+    }
+
+    return res;
+}
+
+bool CliTool::logConvert(QString inFile, QString outFile)
+{
+    QFile in(inFile);
+    if (!in.open(QIODevice::ReadOnly)) {
+        print("", "Could not open " + inFile);
+        return false;
+    }
+
+    QByteArray text;
+    if (LzoLogDevice::isCompressed(&in)) {
+        if (!LzoLogDevice::decompressAll(&in, text)) {
+            print("", "Compressed log is truncated, converting the readable part");
+        }
+    } else {
+        text = in.readAll();
+    }
+
+    QFile out(outFile);
+    if (!out.open(QIODevice::WriteOnly)) {
+        print("", "Could not write " + outFile);
+        return false;
+    }
+
+    bool res = false;
+    if (outFile.endsWith("." + LzoLogDevice::fileSuffix())) {
+        LzoLogDevice dev(&out);
+        res = dev.open(QIODevice::WriteOnly) && dev.write(text) == text.size();
+        dev.close();
+    } else {
+        res = out.write(text) == text.size();
+    }
+
+    out.close();
+    return res;
+}
+
+bool CliTool::logReport(QString dir, QString outFile)
+{
+    QStringList files = LogBatchAnalysis::findLogs(dir, true);
+    QVector<LogBatchAnalysis::Summary> logs = LogBatchAnalysis::run(files);
+
+    if (!LogBatchAnalysis::writeReport(outFile, logs)) {
+        print("", "Could not write " + outFile);
+        return false;
+    }
+
+    print("", QString("Analyzed %1 logs").arg(logs.size()));
+    return true;
+}
+
+void CliTool::print(QString port, QString msg)
+{
+    QMutexLocker locker(&printMutex);
+
+    if (!port.isEmpty()) {
+        msg = "[" + port + "] " + msg;
+    }
+
+    fprintf(stdout, "%s\n", msg.toLocal8Bit().constData());
+    fflush(stdout);
+}
@@ -0,0 +1,60 @@
+/*
+    Copyright 2020 Benjamin Vedder	benjamin@vedder.se
+
+    This file is part of VESC Tool.
+
+    VESC Tool is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    VESC Tool is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+    */
+
+#ifndef CLITOOL_H
+#define CLITOOL_H
+
+#include <QString>
+#include <QStringList>
+
+class OpenroadInterface;
+
+/*
+ * Command line mode that runs without any GUI, only a QCoreApplication.
+ * Commands that talk to a VESC run on every given port at the same time,
+ * each port with its own OpenroadInterface in its own thread.
+ */
+class CliTool
+{
+public:
+    static bool isCliArgs(int argc, char *argv[]);
+    static int run(const QStringList &arguments);
+
+private:
+    struct Job {
+        QString command;
+        QStringList args;
+        bool can;
+        bool bootloader;
+        bool compress;
+        QString name;
+        int baud;
+        int rate;
+    };
+
+    static bool runPort(QString port, const Job &job);
+    static bool connectPort(OpenroadInterface *openroad, QString port, int baud);
+    static bool runCommand(OpenroadInterface *openroad, QString port, const Job &job);
+    static bool logConvert(QString inFile, QString outFile);
+    static bool logReport(QString dir, QString outFile);
+    static void print(QString port, QString msg);
+
+};
+
+#endif // CLITOOL_H
@@ -18,6 +18,7 @@
     */
 
 #include "commands.h"
+#include "linkmetrics.h"
 #include <QDebug>
 
 Commands::Commands(QObject *parent) : QObject(parent)
@@ -28,6 +29,17 @@ Commands::Commands(QObject *parent) : QObject(parent)
     mLimitedSupportsFwdAllCan = false;
     mLimitedSupportsEraseBootloader = false;
     mCheckNextMcConfig = false;
+    mMcConfigPendingNode = -1;
+    mAppConfigPendingNode = -1;
+    mMcConfigWrites = 0;
+    mAppConfigWrites = 0;
+    mMcConfigCached = false;
+    mAppConfigCached = false;
+    mConfHold = false;
+    mMcconfHeldId = -1;
+    mAppconfHeldId = -1;
+    mDiscardMcconf = 0;
+    mDiscardAppconf = 0;
 
     mTimer = new QTimer(this);
     mTimer->setInterval(10);
@@ -35,11 +47,14 @@ Commands::Commands(QObject *parent) : QObject(parent)
 
     mMcConfig = nullptr;
     mAppConfig = nullptr;
+    mMetrics = nullptr;
 
     mTimeoutCount = 100;
     mTimeoutFwVer = 0;
     mTimeoutMcconf = 0;
     mTimeoutAppconf = 0;
+    mTimeoutMcconfWrite = 0;
+    mTimeoutAppconfWrite = 0;
     mTimeoutValues = 0;
     mTimeoutValuesSetup = 0;
     mTimeoutImuData = 0;
@@ -97,6 +112,10 @@ void Commands::processPacket(QByteArray data)
     VByteArray vb(data);
     COMM_PACKET_ID id = COMM_PACKET_ID(vb.vbPopFrontUint8());
 
+    if (mMetrics) {
+        mMetrics->responseReceived(id);
+    }
+
     switch (id) {
     case COMM_FW_VERSION: {
         mTimeoutFwVer = 0;
@@ -254,30 +273,31 @@ void Commands::processPacket(QByteArray data)
 
     case COMM_GET_MCCONF:
     case COMM_GET_MCCONF_DEFAULT:
-        mTimeoutMcconf = 0;
-        if (mMcConfig) {
-            if (mMcConfig->deSerialize(vb)) {
-                mMcConfig->updateDone();
-
-                if (mCheckNextMcConfig) {
-                    mCheckNextMcConfig = false;
-                    emit mcConfigCheckResult(mMcConfig->checkDifference(&mMcConfigLast));
-                }
-            } else {
-                emit deserializeConfigFailed(true, false);
-            }
+        if (mDiscardMcconf > 0) {
+            mDiscardMcconf = 0;
+        } else if (mConfHold) {
+            mTimeoutMcconf = 0;
+            mMcconfHeld = vb;
+            mMcconfHeldId = id;
+            emit confResponseHeld(true, false);
+        } else {
+            mTimeoutMcconf = 0;
+            mcconfReceived(id, vb);
         }
         break;
 
     case COMM_GET_APPCONF:
     case COMM_GET_APPCONF_DEFAULT:
-        mTimeoutAppconf = 0;
-        if (mAppConfig) {
-            if (mAppConfig->deSerialize(vb)) {
-                mAppConfig->updateDone();
-            } else {
-                emit deserializeConfigFailed(false, true);
-            }
+        if (mDiscardAppconf > 0) {
+            mDiscardAppconf = 0;
+        } else if (mConfHold) {
+            mTimeoutAppconf = 0;
+            mAppconfHeld = vb;
+            mAppconfHeldId = id;
+            emit confResponseHeld(false, true);
+        } else {
+            mTimeoutAppconf = 0;
+            appconfReceived(id, vb);
         }
         break;
 
@@ -358,10 +378,32 @@ void Commands::processPacket(QByteArray data)
     } break;
 
     case COMM_SET_MCCONF:
+        if (mMcConfigWrites > 0) {
+            mMcConfigWrites--;
+            if (mMcConfigWrites == 0) {
+                mTimeoutMcconfWrite = 0;
+                if (mMcConfigPending) {
+                    mMcConfigDevice.insert(mMcConfigPendingNode, mMcConfigPending);
+                }
+            }
+        }
+        mMcConfigPending.clear();
+        emit mcConfigWritten(true, true);
         emit ackReceived("MCCONF Write OK");
         break;
 
     case COMM_SET_APPCONF:
+        if (mAppConfigWrites > 0) {
+            mAppConfigWrites--;
+            if (mAppConfigWrites == 0) {
+                mTimeoutAppconfWrite = 0;
+                if (mAppConfigPending) {
+                    mAppConfigDevice.insert(mAppConfigPendingNode, mAppConfigPending);
+                }
+            }
+        }
+        mAppConfigPending.clear();
+        emit appConfigWritten(true, true);
         emit ackReceived("APPCONF Write OK");
         break;
 
@@ -612,6 +654,7 @@ void Commands::processPacket(QByteArray data)
 void Commands::getFwVersion()
 {
     if (mTimeoutFwVer > 0) {
+        requestDropped(COMM_FW_VERSION);
         return;
     }
 
@@ -671,6 +714,7 @@ void Commands::jumpToBootloader(bool fwdCan)
 void Commands::getValues()
 {
     if (mTimeoutValues > 0) {
+        requestDropped(COMM_GET_VALUES);
         return;
     }
 
@@ -681,8 +725,35 @@ void Commands::getValues()
     emitData(vb);
 }
 
+/**
+ * @brief Commands::getValuesSubscribed
+ * Request the values that at least one subscriber needs. All values are
+ * requested with COMM_GET_VALUES when the subscriptions cover everything,
+ * or when the firmware in limited mode does not support selective values.
+ * Nothing is requested when there are no subscribers. Fields outside of the
+ * subscription mask keep their default values in the received MC_VALUES.
+ */
+void Commands::getValuesSubscribed()
+{
+    unsigned int mask = getValuesSubscriptionMask();
+
+    if (mask == 0) {
+        return;
+    }
+
+    if (mask == VALUES_ALL || (mIsLimitedMode &&
+                               !mCompatibilityCommands.contains(COMM_GET_VALUES_SELECTIVE))) {
+        getValues();
+    } else {
+        getValuesSelective(mask);
+    }
+}
+
 void Commands::sendTerminalCmd(QString cmd)
 {
+    // Terminal commands can change the configuration
+    forgetConfState();
+
     VByteArray vb;
     vb.vbAppendInt8(COMM_TERMINAL_CMD);
     vb.append(cmd.toLatin1());
@@ -691,6 +762,8 @@ void Commands::sendTerminalCmd(QString cmd)
 
 void Commands::sendTerminalCmdSync(QString cmd)
 {
+    forgetConfState();
+
     VByteArray vb;
     vb.vbAppendInt8(COMM_TERMINAL_CMD_SYNC);
     vb.append(cmd.toLatin1());
@@ -766,6 +839,7 @@ void Commands::samplePrint(debug_sampling_mode mode, int sample_len, int dec)
 void Commands::getMcconf()
 {
     if (mTimeoutMcconf > 0) {
+        requestDropped(COMM_GET_MCCONF);
         return;
     }
 
@@ -780,6 +854,7 @@ void Commands::getMcconf()
 void Commands::getMcconfDefault()
 {
     if (mTimeoutMcconf > 0) {
+        requestDropped(COMM_GET_MCCONF_DEFAULT);
         return;
     }
 
@@ -794,7 +869,44 @@ void Commands::getMcconfDefault()
 void Commands::setMcconf(bool check)
 {
     if (mMcConfig) {
+        if (mMcConfigCached) {
+            // Nothing is sent, so callers waiting for the write get the
+            // failure instead
+            QTimer::singleShot(0, this, [this]() {
+                emit mcConfigWritten(false, false);
+            });
+            emit confWriteBlocked(true, false);
+            return;
+        }
+
         mMcConfigLast = *mMcConfig;
+
+        if (confUnchanged(mMcConfigDevice, mMcConfig)) {
+            // Callers wait for the ack after this returns
+            QTimer::singleShot(0, this, [this]() {
+                emit mcConfigWritten(true, false);
+                emit ackReceived("MCCONF Unchanged, write skipped");
+            });
+
+            if (check) {
+                checkMcConfig();
+            }
+            return;
+        }
+
+        // The ack cannot be told apart from the ack of a write that is
+        // still in flight, so nothing is recorded for either of them. The
+        // old state of the node is unknown from now on.
+        mMcConfigDevice.remove(confNode());
+        if (mMcConfigWrites == 0) {
+            mMcConfigPending = confSnapshot(mMcConfig);
+            mMcConfigPendingNode = confNode();
+        } else {
+            mMcConfigPending.clear();
+        }
+        mMcConfigWrites++;
+        mTimeoutMcconfWrite = mTimeoutCount;
+
         VByteArray vb;
         vb.vbAppendInt8(COMM_SET_MCCONF);
         mMcConfig->serialize(vb);
@@ -809,6 +921,7 @@ void Commands::setMcconf(bool check)
 void Commands::getAppConf()
 {
     if (mTimeoutAppconf > 0) {
+        requestDropped(COMM_GET_APPCONF);
         return;
     }
 
@@ -822,6 +935,7 @@ void Commands::getAppConf()
 void Commands::getAppConfDefault()
 {
     if (mTimeoutAppconf > 0) {
+        requestDropped(COMM_GET_APPCONF_DEFAULT);
         return;
     }
 
@@ -835,6 +949,32 @@ void Commands::getAppConfDefault()
 void Commands::setAppConf()
 {
     if (mAppConfig) {
+        if (mAppConfigCached) {
+            QTimer::singleShot(0, this, [this]() {
+                emit appConfigWritten(false, false);
+            });
+            emit confWriteBlocked(false, true);
+            return;
+        }
+
+        if (confUnchanged(mAppConfigDevice, mAppConfig)) {
+            QTimer::singleShot(0, this, [this]() {
+                emit appConfigWritten(true, false);
+                emit ackReceived("APPCONF Unchanged, write skipped");
+            });
+            return;
+        }
+
+        mAppConfigDevice.remove(confNode());
+        if (mAppConfigWrites == 0) {
+            mAppConfigPending = confSnapshot(mAppConfig);
+            mAppConfigPendingNode = confNode();
+        } else {
+            mAppConfigPending.clear();
+        }
+        mAppConfigWrites++;
+        mTimeoutAppconfWrite = mTimeoutCount;
+
         VByteArray vb;
         vb.vbAppendInt8(COMM_SET_APPCONF);
         mAppConfig->serialize(vb);
@@ -869,6 +1009,7 @@ void Commands::sendAlive()
 void Commands::getDecodedPpm()
 {
     if (mTimeoutDecPpm > 0) {
+        requestDropped(COMM_GET_DECODED_PPM);
         return;
     }
 
@@ -882,6 +1023,7 @@ void Commands::getDecodedPpm()
 void Commands::getDecodedAdc()
 {
     if (mTimeoutDecAdc > 0) {
+        requestDropped(COMM_GET_DECODED_ADC);
         return;
     }
 
@@ -895,6 +1037,7 @@ void Commands::getDecodedAdc()
 void Commands::getDecodedChuk()
 {
     if (mTimeoutDecChuk > 0) {
+        requestDropped(COMM_GET_DECODED_CHUK);
         return;
     }
 
@@ -908,6 +1051,7 @@ void Commands::getDecodedChuk()
 void Commands::getDecodedBalance()
 {
     if (mTimeoutDecBalance > 0) {
+        requestDropped(COMM_GET_DECODED_BALANCE);
         return;
     }
 
@@ -1101,6 +1245,7 @@ void Commands::gpdSetBufferIntScale(float scale)
 void Commands::getValuesSetup()
 {
     if (mTimeoutValuesSetup > 0) {
+        requestDropped(COMM_GET_VALUES_SETUP);
         return;
     }
 
@@ -1114,6 +1259,10 @@ void Commands::getValuesSetup()
 void Commands::setMcconfTemp(const MCCONF_TEMP &conf, bool is_setup, bool store,
                              bool forward_can, bool divide_by_controllers, bool ack)
 {
+    if (store) {
+        mMcConfigDevice.clear();
+    }
+
     VByteArray vb;
     vb.vbAppendInt8(is_setup ? COMM_SET_MCCONF_TEMP_SETUP : COMM_SET_MCCONF_TEMP);
     vb.vbAppendInt8(store);
@@ -1134,6 +1283,7 @@ void Commands::setMcconfTemp(const MCCONF_TEMP &conf, bool is_setup, bool store,
 void Commands::getValuesSelective(unsigned int mask)
 {
     if (mTimeoutValues > 0) {
+        requestDropped(COMM_GET_VALUES_SELECTIVE);
         return;
     }
 
@@ -1148,6 +1298,7 @@ void Commands::getValuesSelective(unsigned int mask)
 void Commands::getValuesSetupSelective(unsigned int mask)
 {
     if (mTimeoutValuesSetup > 0) {
+        requestDropped(COMM_GET_VALUES_SETUP_SELECTIVE);
         return;
     }
 
@@ -1173,6 +1324,8 @@ void Commands::measureLinkageOpenloop(double current, double erpm_per_sec, doubl
 void Commands::detectAllFoc(bool detect_can, double max_power_loss, double min_current_in,
                             double max_current_in, double openloop_rpm, double sl_erpm)
 {
+    mMcConfigDevice.clear();
+
     VByteArray vb;
     vb.vbAppendInt8(COMM_DETECT_APPLY_ALL_FOC);
     vb.vbAppendInt8(detect_can);
@@ -1187,6 +1340,7 @@ void Commands::detectAllFoc(bool detect_can, double max_power_loss, double min_c
 void Commands::pingCan()
 {
     if (mTimeoutPingCan > 0) {
+        requestDropped(COMM_PING_CAN);
         return;
     }
 
@@ -1222,6 +1376,7 @@ void Commands::disableAppOutput(int time_ms, bool fwdCan)
 void Commands::getImuData(unsigned int mask)
 {
     if (mTimeoutImuData > 0) {
+        requestDropped(COMM_GET_IMU_DATA);
         return;
     }
 
@@ -1331,6 +1486,23 @@ void Commands::timerSlot()
         }
     }
     if (mTimeoutAppconf > 0) mTimeoutAppconf--;
+    if (mTimeoutMcconfWrite > 0) {
+        mTimeoutMcconfWrite--;
+        if (mTimeoutMcconfWrite == 0) {
+            // Lost writes, do not record a late ack
+            mMcConfigWrites = 0;
+            mMcConfigPending.clear();
+        }
+    }
+    if (mTimeoutAppconfWrite > 0) {
+        mTimeoutAppconfWrite--;
+        if (mTimeoutAppconfWrite == 0) {
+            mAppConfigWrites = 0;
+            mAppConfigPending.clear();
+        }
+    }
+    if (mDiscardMcconf > 0) mDiscardMcconf--;
+    if (mDiscardAppconf > 0) mDiscardAppconf--;
     if (mTimeoutValues > 0) mTimeoutValues--;
     if (mTimeoutValuesSetup > 0) mTimeoutValuesSetup--;
     if (mTimeoutImuData > 0) mTimeoutImuData--;
@@ -1361,12 +1533,17 @@ void Commands::emitData(QByteArray data)
                      data.at(0) != COMM_ERASE_BOOTLOADER_ALL_CAN)) {
 
                 if (!mCompatibilityCommands.contains(int(data.at(0)))) {
+                    requestDropped(quint8(data.at(0)));
                     return;
                 }
             }
         }
     }
 
+    if (mMetrics) {
+        mMetrics->requestSent(quint8(data.at(0)));
+    }
+
     if (mSendCan) {
         data.prepend((char)mCanId);
         data.prepend((char)COMM_FORWARD_CAN);
@@ -1375,6 +1552,114 @@ void Commands::emitData(QByteArray data)
     emit dataToSend(data);
 }
 
+void Commands::requestDropped(int commId)
+{
+    if (mMetrics) {
+        mMetrics->requestDropped(commId);
+    }
+}
+
+int Commands::confNode()
+{
+    return mSendCan ? mCanId : -1;
+}
+
+QSharedPointer<ConfigParams> Commands::confSnapshot(ConfigParams *config)
+{
+    // Copies share the parameter definitions, so this only copies values
+    QSharedPointer<ConfigParams> res(new ConfigParams);
+    *res = *config;
+    return res;
+}
+
+void Commands::storeConfState(ConfStates &states, ConfigParams *config)
+{
+    // A read of a single parameter leaves the others as they were locally
+    if (config->getUpdatesEnabled() && config->getUpdateOnly().isEmpty()) {
+        states.insert(confNode(), confSnapshot(config));
+    }
+}
+
+QSharedPointer<ConfigParams> Commands::confState(const ConfStates &states, ConfigParams *config)
+{
+    auto state = states.value(confNode());
+
+    // The state is from other firmware if the definitions have changed
+    if (state && state->getSignature() != config->getSignature()) {
+        state.clear();
+    }
+
+    return state;
+}
+
+void Commands::mcconfReceived(int id, VByteArray &vb)
+{
+    if (!mMcConfig) {
+        return;
+    }
+
+    if (mMcConfig->deSerialize(vb)) {
+        mMcConfigCached = false;
+
+        if (id == COMM_GET_MCCONF) {
+            storeConfState(mMcConfigDevice, mMcConfig);
+        }
+
+        mMcConfig->updateDone();
+
+        if (id == COMM_GET_MCCONF) {
+            emit mcConfigRead();
+        }
+
+        if (mCheckNextMcConfig) {
+            mCheckNextMcConfig = false;
+            emit mcConfigCheckResult(mMcConfig->checkDifference(&mMcConfigLast));
+        }
+    } else {
+        emit deserializeConfigFailed(true, false);
+    }
+}
+
+void Commands::appconfReceived(int id, VByteArray &vb)
+{
+    if (!mAppConfig) {
+        return;
+    }
+
+    if (mAppConfig->deSerialize(vb)) {
+        mAppConfigCached = false;
+
+        if (id == COMM_GET_APPCONF) {
+            storeConfState(mAppConfigDevice, mAppConfig);
+        }
+
+        mAppConfig->updateDone();
+
+        if (id == COMM_GET_APPCONF) {
+            emit appConfigRead();
+        }
+    } else {
+        emit deserializeConfigFailed(false, true);
+    }
+}
+
+bool Commands::confUnchanged(const ConfStates &states, ConfigParams *config)
+{
+    auto state = confState(states, config);
+    if (!state) {
+        return false;
+    }
+
+    // Compared as sent, as checkDifference tolerates differences that
+    // are significant for small values, e.g. the motor inductance.
+    VByteArray vbNow;
+    VByteArray vbState;
+    config->serialize(vbNow);
+    state->serialize(vbState);
+
+    return vbNow == vbState;
+}
+
 bool Commands::getLimitedSupportsFwdAllCan() const
 {
     return mLimitedSupportsFwdAllCan;
@@ -1448,6 +1733,184 @@ void Commands::setMcConfig(ConfigParams *mcConfig)
     connect(mMcConfig, SIGNAL(updateRequestDefault()), this, SLOT(getMcconfDefault()));
 }
 
+/**
+ * @brief Commands::setMetrics
+ * Report requests, responses and suppressed requests to metrics.
+ */
+void Commands::setMetrics(LinkMetrics *metrics)
+{
+    mMetrics = metrics;
+}
+
+/**
+ * @brief Commands::subscribeValues
+ * Declare which MC_VALUES fields subscriber needs. getValuesSubscribed
+ * requests the union of the masks of all subscribers. Subscribing again
+ * replaces the previous mask of subscriber, and the subscription is removed
+ * when subscriber is destroyed.
+ *
+ * @param subscriber
+ * The object that uses the values, e.g. a page or a QML item.
+ *
+ * @param mask
+ * ValuesField bits of the needed fields. 0 removes the subscription.
+ */
+void Commands::subscribeValues(QObject *subscriber, unsigned int mask)
+{
+    if (!subscriber) {
+        return;
+    }
+
+    if (mask == 0) {
+        unsubscribeValues(subscriber);
+        return;
+    }
+
+    if (!mValuesSubscriptions.contains(subscriber)) {
+        connect(subscriber, &QObject::destroyed, this, [this](QObject *obj) {
+            mValuesSubscriptions.remove(obj);
+        });
+    }
+
+    mValuesSubscriptions.insert(subscriber, mask & VALUES_ALL);
+}
+
+void Commands::unsubscribeValues(QObject *subscriber)
+{
+    if (mValuesSubscriptions.remove(subscriber) > 0) {
+        disconnect(subscriber, SIGNAL(destroyed(QObject*)), this, nullptr);
+    }
+}
+
+unsigned int Commands::getValuesSubscriptionMask() const
+{
+    unsigned int mask = 0;
+    for (auto m: mValuesSubscriptions) {
+        mask |= m;
+    }
+    return mask;
+}
+
+/**
+ * @brief Commands::getMcconfDirty
+ * Get the motor configuration parameters that differ from the last
+ * configuration read from or written to the current node.
+ *
+ * @return
+ * The names of the changed parameters. All parameters when the
+ * configuration of the node is not known.
+ */
+QStringList Commands::getMcconfDirty()
+{
+    if (!mMcConfig) {
+        return QStringList();
+    }
+
+    auto state = confState(mMcConfigDevice, mMcConfig);
+    return state ? mMcConfig->checkDifference(state.data()) : mMcConfig->getParamOrder();
+}
+
+QStringList Commands::getAppconfDirty()
+{
+    if (!mAppConfig) {
+        return QStringList();
+    }
+
+    auto state = confState(mAppConfigDevice, mAppConfig);
+    return state ? mAppConfig->checkDifference(state.data()) : mAppConfig->getParamOrder();
+}
+
+/**
+ * @brief Commands::forgetConfState
+ * Forget the configurations that are known to be on the nodes, so that the
+ * next writes are sent in any case. Has to be called when the nodes can
+ * have changed their configuration in other ways, e.g. on reconnects.
+ */
+void Commands::forgetConfState()
+{
+    mMcConfigDevice.clear();
+    mAppConfigDevice.clear();
+    mMcConfigPending.clear();
+    mAppConfigPending.clear();
+}
+
+/**
+ * @brief Commands::holdConfResponses
+ * Keep the motor and app configurations that are received from now on
+ * without parsing them, and emit confResponseHeld instead. This allows
+ * reading them before it is known if the loaded definitions fit the
+ * firmware of the target.
+ */
+void Commands::holdConfResponses()
+{
+    mConfHold = true;
+    mMcconfHeldId = -1;
+    mAppconfHeldId = -1;
+}
+
+/**
+ * @brief Commands::releaseConfResponses
+ * Stop holding configuration responses.
+ *
+ * @param apply
+ * Parse the held configurations as if they were received now. Otherwise
+ * they are dropped, together with responses to requests that are still
+ * pending, so that they are never parsed with other definitions.
+ */
+void Commands::releaseConfResponses(bool apply)
+{
+    mConfHold = false;
+
+    if (apply) {
+        if (mMcconfHeldId >= 0) {
+            mcconfReceived(mMcconfHeldId, mMcconfHeld);
+        }
+
+        if (mAppconfHeldId >= 0) {
+            appconfReceived(mAppconfHeldId, mAppconfHeld);
+        }
+    } else {
+        if (mTimeoutMcconf > 0) {
+            mTimeoutMcconf = 0;
+            mDiscardMcconf = mTimeoutCount;
+        }
+
+        if (mTimeoutAppconf > 0) {
+            mTimeoutAppconf = 0;
+            mDiscardAppconf = mTimeoutCount;
+        }
+    }
+
+    mMcconfHeldId = -1;
+    mAppconfHeldId = -1;
+    mMcconfHeld.clear();
+    mAppconfHeld.clear();
+}
+
+/**
+ * @brief Commands::setConfCached
+ * Set which configurations hold values loaded from the cache. Writes of
+ * them are blocked until they have been read from the VESC. A blocked
+ * write emits confWriteBlocked, and mcConfigWritten or appConfigWritten
+ * with ok set to false. Both flags are replaced, so that the state of a
+ * previous VESC does not carry over.
+ */
+void Commands::setConfCached(bool isMc, bool isApp)
+{
+    mMcConfigCached = isMc;
+    mAppConfigCached = isApp;
+}
+
+bool Commands::isMcconfCached() const
+{
+    return mMcConfigCached;
+}
+
+bool Commands::isAppconfCached() const
+{
+    return mAppConfigCached;
+}
+
 void Commands::checkMcConfig()
 {
     mCheckNextMcConfig = true;
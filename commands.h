@@ -22,15 +22,46 @@
 
 #include <QObject>
 #include <QTimer>
+#include <QHash>
+#include <QSharedPointer>
 #include "vbytearray.h"
 #include "datatypes.h"
 #include "packet.h"
 #include "configparams.h"
 
+class LinkMetrics;
+
 class Commands : public QObject
 {
     Q_OBJECT
 public:
+    // Bits of the COMM_GET_VALUES_SELECTIVE mask
+    enum ValuesField {
+        VALUES_TEMP_MOS = 1 << 0,
+        VALUES_TEMP_MOTOR = 1 << 1,
+        VALUES_CURRENT_MOTOR = 1 << 2,
+        VALUES_CURRENT_IN = 1 << 3,
+        VALUES_ID = 1 << 4,
+        VALUES_IQ = 1 << 5,
+        VALUES_DUTY_NOW = 1 << 6,
+        VALUES_RPM = 1 << 7,
+        VALUES_V_IN = 1 << 8,
+        VALUES_AMP_HOURS = 1 << 9,
+        VALUES_AMP_HOURS_CHARGED = 1 << 10,
+        VALUES_WATT_HOURS = 1 << 11,
+        VALUES_WATT_HOURS_CHARGED = 1 << 12,
+        VALUES_TACHOMETER = 1 << 13,
+        VALUES_TACHOMETER_ABS = 1 << 14,
+        VALUES_FAULT_CODE = 1 << 15,
+        VALUES_POSITION = 1 << 16,
+        VALUES_OPENROAD_ID = 1 << 17,
+        VALUES_TEMP_MOS_123 = 1 << 18,
+        VALUES_VD = 1 << 19,
+        VALUES_VQ = 1 << 20,
+        VALUES_ALL = (1 << 21) - 1
+    };
+    Q_ENUM(ValuesField)
+
     explicit Commands(QObject *parent = nullptr);
 
     void setLimitedMode(bool is_limited);
@@ -41,6 +72,7 @@ public:
     Q_INVOKABLE int getCanSendId();
     void setMcConfig(ConfigParams *mcConfig);
     void setAppConfig(ConfigParams *appConfig);
+    void setMetrics(LinkMetrics *metrics);
     void checkMcConfig();
     Q_INVOKABLE void emitEmptyValues();
     Q_INVOKABLE void emitEmptySetupValues();
@@ -56,6 +88,19 @@ public:
 
     Q_INVOKABLE static QString faultToStr(mc_fault_code fault);
 
+    Q_INVOKABLE void subscribeValues(QObject *subscriber, unsigned int mask);
+    Q_INVOKABLE void unsubscribeValues(QObject *subscriber);
+    Q_INVOKABLE unsigned int getValuesSubscriptionMask() const;
+
+    Q_INVOKABLE QStringList getMcconfDirty();
+    Q_INVOKABLE QStringList getAppconfDirty();
+    Q_INVOKABLE void forgetConfState();
+    void holdConfResponses();
+    void releaseConfResponses(bool apply);
+    Q_INVOKABLE void setConfCached(bool isMc, bool isApp);
+    Q_INVOKABLE bool isMcconfCached() const;
+    Q_INVOKABLE bool isAppconfCached() const;
+
 signals:
     void dataToSend(QByteArray &data);
 
@@ -81,6 +126,12 @@ signals:
     void focHallTableReceived(QVector<int> hall_table, int res);
     void nrfPairingRes(int res);
     void mcConfigCheckResult(QStringList paramsNotSet);
+    void mcConfigWritten(bool ok, bool changed);
+    void appConfigWritten(bool ok, bool changed);
+    void confWriteBlocked(bool isMc, bool isApp);
+    void confResponseHeld(bool isMc, bool isApp);
+    void mcConfigRead();
+    void appConfigRead();
     void gpdBufferNotifyReceived();
     void gpdBufferSizeLeftReceived(int sizeLeft);
     void valuesSetupReceived(SETUP_VALUES values, unsigned int mask);
@@ -111,6 +162,7 @@ public slots:
     void writeNewAppDataLzo(QByteArray data, quint32 offset, quint16 decompressedLen, bool fwdCan);
     void jumpToBootloader(bool fwdCan);
     void getValues();
+    void getValuesSubscribed();
     void sendTerminalCmd(QString cmd);
     void sendTerminalCmdSync(QString cmd);
     void setDutyCycle(double dutyCycle);
@@ -179,6 +231,16 @@ private slots:
 
 private:
     void emitData(QByteArray data);
+    void requestDropped(int commId);
+
+    typedef QHash<int, QSharedPointer<ConfigParams> > ConfStates;
+    int confNode();
+    QSharedPointer<ConfigParams> confSnapshot(ConfigParams *config);
+    void storeConfState(ConfStates &states, ConfigParams *config);
+    QSharedPointer<ConfigParams> confState(const ConfStates &states, ConfigParams *config);
+    bool confUnchanged(const ConfStates &states, ConfigParams *config);
+    void mcconfReceived(int id, VByteArray &vb);
+    void appconfReceived(int id, VByteArray &vb);
 
     QTimer *mTimer;
     bool mSendCan;
@@ -187,16 +249,49 @@ private:
     bool mLimitedSupportsFwdAllCan;
     bool mLimitedSupportsEraseBootloader;
     QVector<int> mCompatibilityCommands; // int to be QML-compatible
+    QHash<QObject*, unsigned int> mValuesSubscriptions;
 
     ConfigParams *mMcConfig;
+    LinkMetrics *mMetrics;
     ConfigParams *mAppConfig;
     ConfigParams mMcConfigLast;
     bool mCheckNextMcConfig;
 
+    // Configurations last read from or written to each node, -1 for the
+    // VESC on the port. Writes without changes to them are skipped.
+    ConfStates mMcConfigDevice;
+    ConfStates mAppConfigDevice;
+    // The write acks carry no node, so the snapshot of a write is only
+    // kept while it is the only one in flight.
+    QSharedPointer<ConfigParams> mMcConfigPending;
+    QSharedPointer<ConfigParams> mAppConfigPending;
+    int mMcConfigPendingNode;
+    int mAppConfigPendingNode;
+    int mMcConfigWrites;
+    int mAppConfigWrites;
+
+    // The configurations hold values from the cache that have not been
+    // read from the VESC yet, so they must not be written.
+    bool mMcConfigCached;
+    bool mAppConfigCached;
+
+    // Configuration responses held while the definitions are not known
+    // to fit, and the number of timer ticks during which a late response
+    // to a dropped request is discarded.
+    bool mConfHold;
+    VByteArray mMcconfHeld;
+    VByteArray mAppconfHeld;
+    int mMcconfHeldId;
+    int mAppconfHeldId;
+    int mDiscardMcconf;
+    int mDiscardAppconf;
+
     int mTimeoutCount;
     int mTimeoutFwVer;
     int mTimeoutMcconf;
     int mTimeoutAppconf;
+    int mTimeoutMcconfWrite;
+    int mTimeoutAppconfWrite;
     int mTimeoutValues;
     int mTimeoutValuesSetup;
     int mTimeoutImuData;
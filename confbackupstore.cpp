@@ -0,0 +1,424 @@
+/*
+    Copyright 2020 Benjamin Vedder	benjamin@vedder.se
+
+    This file is part of VESC Tool.
+
+    VESC Tool is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    VESC Tool is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+    */
+
+#include "confbackupstore.h"
+#include <QtConcurrent>
+#include <QCryptographicHash>
+#include <QStandardPaths>
+#include <QDateTime>
+#include <QDataStream>
+#include <QSaveFile>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDebug>
+
+namespace {
+const char indexName[] = "index.bin";
+const char blobDirName[] = "blobs";
+const quint32 indexMagic = 0x56434249;
+const quint32 indexVersion = 1;
+
+QDataStream &operator<<(QDataStream &out, const ConfBackupStore::Version &v)
+{
+    out << v.name << v.time << v.mcHash << v.appHash;
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, ConfBackupStore::Version &v)
+{
+    in >> v.name >> v.time >> v.mcHash >> v.appHash;
+    return in;
+}
+}
+
+ConfBackupStore::ConfBackupStore(QString dir)
+{
+    mDir = dir;
+    mIndexGen = 0;
+    mWriteSeq = 0;
+    mFailedSeq = 0;
+
+    // One writer keeps the writes in the order they were made
+    mWritePool.setMaxThreadCount(1);
+
+    reload();
+}
+
+ConfBackupStore::~ConfBackupStore()
+{
+    waitForWrites();
+}
+
+/**
+ * @brief ConfBackupStore::shared
+ * The store in the default directory that all interfaces share, so that
+ * they see the backups of each other without reading them again. The
+ * store is deleted, and its writes finished, when the last interface
+ * releases it. Must not be used before the application object exists.
+ */
+QSharedPointer<ConfBackupStore> ConfBackupStore::shared()
+{
+    static QMutex sharedMutex;
+    static QWeakPointer<ConfBackupStore> sharedStore;
+
+    QMutexLocker locker(&sharedMutex);
+    QSharedPointer<ConfBackupStore> res = sharedStore.toStrongRef();
+    if (!res) {
+        res = QSharedPointer<ConfBackupStore>(new ConfBackupStore(defaultDir()));
+        sharedStore = res;
+    }
+
+    return res;
+}
+
+QString ConfBackupStore::defaultDir()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) +
+            "/config_backups";
+}
+
+/**
+ * @brief ConfBackupStore::reload
+ * Read the index again, e.g. after another process has added backups.
+ * Pending writes are finished first.
+ */
+void ConfBackupStore::reload()
+{
+    waitForWrites();
+
+    QMutexLocker locker(&mMutex);
+    mIndex.clear();
+    mStoredBlobs.clear();
+
+    QFile file(indexPath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    qint32 count = 0;
+    in >> magic >> version >> count;
+
+    if (magic != indexMagic || version != indexVersion || count < 0) {
+        qWarning() << "Unknown configuration backup index" << file.fileName();
+        return;
+    }
+
+    for (int i = 0;i < count;i++) {
+        QString uuid;
+        qint32 versionCount = 0;
+        in >> uuid >> versionCount;
+
+        QVector<Version> versions;
+        for (int j = 0;j < versionCount && in.status() == QDataStream::Ok;j++) {
+            Version v;
+            in >> v;
+            versions.append(v);
+        }
+
+        if (in.status() != QDataStream::Ok) {
+            qWarning() << "Configuration backup index" << file.fileName() << "is truncated";
+            break;
+        }
+
+        mIndex.insert(uuid, versions);
+    }
+}
+
+/**
+ * @brief ConfBackupStore::writeMark
+ * Mark the writes made so far, for waitForWrites.
+ */
+quint64 ConfBackupStore::writeMark() const
+{
+    QMutexLocker locker(&mMutex);
+    return mWriteSeq;
+}
+
+/**
+ * @brief ConfBackupStore::waitForWrites
+ * Block until everything that was changed is on disk.
+ *
+ * @param since
+ * Mark from writeMark. Only writes made after it are checked.
+ *
+ * @return
+ * false if one of the checked writes has failed.
+ */
+bool ConfBackupStore::waitForWrites(quint64 since)
+{
+    mWritePool.waitForDone();
+
+    QMutexLocker locker(&mMutex);
+    return mFailedSeq <= since;
+}
+
+QStringList ConfBackupStore::uuids() const
+{
+    QMutexLocker locker(&mMutex);
+    return mIndex.keys();
+}
+
+bool ConfBackupStore::contains(QString uuid) const
+{
+    QMutexLocker locker(&mMutex);
+    return mIndex.contains(uuid);
+}
+
+/**
+ * @brief ConfBackupStore::history
+ * All versions of the backup of uuid, the oldest first.
+ */
+QVector<ConfBackupStore::Version> ConfBackupStore::history(QString uuid) const
+{
+    QMutexLocker locker(&mMutex);
+    return mIndex.value(uuid);
+}
+
+/**
+ * @brief ConfBackupStore::backup
+ * Get a backup with the configurations compressed the same way as
+ * ConfigParams::saveCompressed.
+ *
+ * @param uuid
+ * UUID of the VESC.
+ *
+ * @param cfg
+ * The backup is written here.
+ *
+ * @param version
+ * Index in the history, or -1 for the latest version.
+ *
+ * @return
+ * true if the backup exists and its blobs could be read.
+ */
+bool ConfBackupStore::backup(QString uuid, CONFIG_BACKUP &cfg, int version) const
+{
+    QMutexLocker locker(&mMutex);
+
+    const QVector<Version> versions = mIndex.value(uuid);
+    if (version < 0) {
+        version = versions.size() - 1;
+    }
+
+    if (version < 0 || version >= versions.size()) {
+        return false;
+    }
+
+    const Version &v = versions.at(version);
+    QByteArray mc, app;
+    if (!readBlob(v.mcHash, mc) || !readBlob(v.appHash, app)) {
+        return false;
+    }
+
+    cfg.name = v.name;
+    cfg.openroad_uuid = uuid;
+    cfg.mcconf_xml_compressed = QString::fromLatin1(mc.toBase64());
+    cfg.appconf_xml_compressed = QString::fromLatin1(app.toBase64());
+
+    return true;
+}
+
+/**
+ * @brief ConfBackupStore::add
+ * Add a backup as the latest version of its UUID. The blobs and the index
+ * are written in the background.
+ *
+ * @return
+ * true if a version was added, false if the backup is the same as the
+ * latest version.
+ */
+bool ConfBackupStore::add(const CONFIG_BACKUP &cfg)
+{
+    QMutexLocker locker(&mMutex);
+
+    Version v;
+    v.name = cfg.name;
+    v.time = QDateTime::currentMSecsSinceEpoch();
+    v.mcHash = storeBlob(cfg.mcconf_xml_compressed);
+    v.appHash = storeBlob(cfg.appconf_xml_compressed);
+
+    QVector<Version> &versions = mIndex[cfg.openroad_uuid];
+    if (!versions.isEmpty()) {
+        const Version &last = versions.last();
+        if (last.name == v.name && last.mcHash == v.mcHash && last.appHash == v.appHash) {
+            return false;
+        }
+    }
+
+    versions.append(v);
+    scheduleIndexWrite();
+
+    return true;
+}
+
+/**
+ * @brief ConfBackupStore::clear
+ * Remove all backups, including their history and blobs.
+ */
+void ConfBackupStore::clear()
+{
+    // Removed right away, so that blobs added after this are not
+    // removed with the old ones.
+    waitForWrites();
+
+    QMutexLocker locker(&mMutex);
+    mIndex.clear();
+    mPendingBlobs.clear();
+    mStoredBlobs.clear();
+    QDir(QDir(mDir).filePath(blobDirName)).removeRecursively();
+
+    scheduleIndexWrite();
+}
+
+QString ConfBackupStore::blobPath(const QByteArray &hash) const
+{
+    return QDir(mDir).filePath(QString(blobDirName) + "/" +
+                               QString::fromLatin1(hash.toHex()) + ".lzo");
+}
+
+QString ConfBackupStore::indexPath() const
+{
+    return QDir(mDir).filePath(indexName);
+}
+
+bool ConfBackupStore::readBlob(const QByteArray &hash, QByteArray &data) const
+{
+    if (mPendingBlobs.contains(hash)) {
+        data = mPendingBlobs.value(hash);
+        return true;
+    }
+
+    QFile file(blobPath(hash));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    data = file.readAll();
+    if (QCryptographicHash::hash(data, QCryptographicHash::Sha1) != hash) {
+        qWarning() << "Configuration backup blob" << file.fileName() << "is corrupt";
+        // Written again when the same configuration is added
+        mStoredBlobs.remove(hash);
+        return false;
+    }
+
+    return true;
+}
+
+QByteArray ConfBackupStore::storeBlob(const QString &compressed)
+{
+    // The blobs hold the compressed data itself, without the base64
+    // encoding used in the settings.
+    QByteArray data = QByteArray::fromBase64(compressed.toLatin1());
+    QByteArray hash = QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+
+    if (mPendingBlobs.contains(hash) || mStoredBlobs.contains(hash)) {
+        return hash;
+    }
+
+    QString path = blobPath(hash);
+
+    mPendingBlobs.insert(hash, data);
+    quint64 seq = ++mWriteSeq;
+
+    QtConcurrent::run(&mWritePool, [this, path, hash, data, seq]() {
+        // A blob file that is there already is checked here instead of on
+        // the caller thread. One that is corrupt, e.g. after an interrupted
+        // write by another process, is written again.
+        QFile existing(path);
+        if (existing.open(QIODevice::ReadOnly) &&
+                QCryptographicHash::hash(existing.readAll(), QCryptographicHash::Sha1) == hash) {
+            QMutexLocker locker(&mMutex);
+            mPendingBlobs.remove(hash);
+            mStoredBlobs.insert(hash);
+            return;
+        }
+        existing.close();
+
+        QDir().mkpath(QFileInfo(path).absolutePath());
+
+        QSaveFile file(path);
+        if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+            qWarning() << "Could not write configuration backup blob" << path;
+            // Kept in memory, so that the backup works until the store is
+            // loaded again.
+            QMutexLocker locker(&mMutex);
+            mFailedSeq = qMax(mFailedSeq, seq);
+        } else {
+            QMutexLocker locker(&mMutex);
+            mPendingBlobs.remove(hash);
+            mStoredBlobs.insert(hash);
+        }
+    });
+
+    return hash;
+}
+
+void ConfBackupStore::scheduleIndexWrite()
+{
+    mIndexGen++;
+    mWriteSeq++;
+    QtConcurrent::run(&mWritePool, this, &ConfBackupStore::writeIndex,
+                      mIndex, mIndexGen, mWriteSeq);
+}
+
+void ConfBackupStore::writeIndex(QHash<QString, QVector<Version> > index, quint64 gen, quint64 seq)
+{
+    {
+        // A newer index is written after this one anyway
+        QMutexLocker locker(&mMutex);
+        if (gen != mIndexGen) {
+            return;
+        }
+    }
+
+    QDir().mkpath(mDir);
+
+    QSaveFile file(indexPath());
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Could not write configuration backup index" << file.fileName();
+        QMutexLocker locker(&mMutex);
+        mFailedSeq = qMax(mFailedSeq, seq);
+        return;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << indexMagic << indexVersion << qint32(index.size());
+
+    QHashIterator<QString, QVector<Version> > i(index);
+    while (i.hasNext()) {
+        i.next();
+        out << i.key() << qint32(i.value().size());
+        for (const auto &v: i.value()) {
+            out << v;
+        }
+    }
+
+    if (!file.commit()) {
+        qWarning() << "Could not write configuration backup index" << file.fileName();
+        QMutexLocker locker(&mMutex);
+        mFailedSeq = qMax(mFailedSeq, seq);
+    }
+}
@@ -0,0 +1,95 @@
+/*
+    Copyright 2020 Benjamin Vedder	benjamin@vedder.se
+
+    This file is part of VESC Tool.
+
+    VESC Tool is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    VESC Tool is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+    */
+
+#ifndef CONFBACKUPSTORE_H
+#define CONFBACKUPSTORE_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include <QMutex>
+#include <QThreadPool>
+#include <QSharedPointer>
+#include "datatypes.h"
+
+/*
+ * Configuration backups of all VESCs, with the history of every VESC.
+ * The compressed configurations are stored once per content in a blob
+ * file named after their hash, and a small index lists the versions of
+ * each UUID. Only the index is read when the store is loaded, the blobs
+ * are read when a backup is used. All writes are done in order in a
+ * worker thread. The store is shared by all interfaces of the process.
+ */
+class ConfBackupStore
+{
+public:
+    struct Version {
+        Version() {
+            time = 0;
+        }
+
+        QString name;
+        qint64 time;
+        QByteArray mcHash;
+        QByteArray appHash;
+    };
+
+    explicit ConfBackupStore(QString dir);
+    ~ConfBackupStore();
+
+    static QSharedPointer<ConfBackupStore> shared();
+    static QString defaultDir();
+
+    void reload();
+    quint64 writeMark() const;
+    bool waitForWrites(quint64 since = 0);
+
+    QStringList uuids() const;
+    bool contains(QString uuid) const;
+    QVector<Version> history(QString uuid) const;
+    bool backup(QString uuid, CONFIG_BACKUP &cfg, int version = -1) const;
+    bool add(const CONFIG_BACKUP &cfg);
+    void clear();
+
+private:
+    mutable QMutex mMutex;
+    QString mDir;
+    QHash<QString, QVector<Version> > mIndex;
+    QHash<QByteArray, QByteArray> mPendingBlobs;
+    // Blobs that have been written or checked since the store was loaded
+    mutable QSet<QByteArray> mStoredBlobs;
+    quint64 mIndexGen;
+    // Writes are numbered, so that callers can tell if their own writes
+    // failed without taking the failures of other callers.
+    quint64 mWriteSeq;
+    quint64 mFailedSeq;
+    QThreadPool mWritePool;
+
+    QString blobPath(const QByteArray &hash) const;
+    QString indexPath() const;
+    bool readBlob(const QByteArray &hash, QByteArray &data) const;
+    QByteArray storeBlob(const QString &compressed);
+    void scheduleIndexWrite();
+    void writeIndex(QHash<QString, QVector<Version> > index, quint64 gen, quint64 seq);
+
+};
+
+#endif // CONFBACKUPSTORE_H
@@ -19,38 +19,186 @@
 
 #include "configparams.h"
 #include <QDebug>
-#include "widgets/parameditdouble.h"
-#include "widgets/parameditint.h"
-#include "widgets/parameditstring.h"
-#include "widgets/parameditenum.h"
-#include "widgets/parameditbool.h"
 #include <QFile>
 #include <QFileInfo>
 #include <QBuffer>
+#include <QMutex>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QDir>
+#include <QStandardPaths>
+#include <QCryptographicHash>
 #include <cmath>
+#include <algorithm>
 #include "utility.h"
 #include "lzokay/lzokay.hpp"
 
+namespace {
+// Parameter names are interned process wide, so that an ID means the same
+// parameter in every ConfigParams and stays valid when definitions are
+// reloaded.
+QMutex internMutex;
+QHash<QString, int> internIds;
+QStringList internNames;
+
+// Binary parameter definition cache, see loadParamsCached. The format
+// must be increased whenever writeParamDef or the XML parsing changes.
+const quint32 paramsCacheMagic = 0x56504443; // VPDC
+const quint32 paramsCacheFormat = 1;
+
+void writeParamDef(QDataStream &out, const ConfigParam &p)
+{
+    out << qint32(p.type) << p.longName << p.description << p.cDefine <<
+           p.valDouble << qint32(p.valInt) << p.valString << p.enumNames <<
+           p.maxDouble << p.minDouble << p.stepDouble <<
+           qint32(p.editorDecimalsDouble) << qint32(p.maxInt) <<
+           qint32(p.minInt) << qint32(p.stepInt) << qint32(p.vTx) <<
+           p.vTxDoubleScale << p.suffix << p.editorScale <<
+           p.editAsPercentage << p.showDisplay << p.transmittable;
+}
+
+// When descPos is given, the description is skipped and its position in
+// the stream is stored there instead.
+void readParamDef(QDataStream &in, ConfigParam &p, qint64 *descPos = nullptr)
+{
+    qint32 type, valInt, decimals, maxInt, minInt, stepInt, vTx;
+    in >> type >> p.longName;
+
+    if (descPos) {
+        *descPos = in.device()->pos();
+        quint32 len = 0;
+        in >> len;
+        if (len != 0xFFFFFFFF) {
+            in.skipRawData(int(len));
+        }
+        p.description.clear();
+    } else {
+        in >> p.description;
+    }
+
+    in >> p.cDefine >> p.valDouble >> valInt >> p.valString >> p.enumNames >>
+          p.maxDouble >> p.minDouble >> p.stepDouble >>
+          decimals >> maxInt >> minInt >> stepInt >> vTx >>
+          p.vTxDoubleScale >> p.suffix >> p.editorScale >>
+          p.editAsPercentage >> p.showDisplay >> p.transmittable;
+
+    p.type = CFG_T(type);
+    p.valInt = valInt;
+    p.editorDecimalsDouble = decimals;
+    p.maxInt = maxInt;
+    p.minInt = minInt;
+    p.stepInt = stepInt;
+    p.vTx = VESC_TX_T(vTx);
+}
+
+bool paramDefEqual(const ConfigParam &a, const ConfigParam &b)
+{
+    return a.type == b.type && a.longName == b.longName &&
+            a.description == b.description && a.cDefine == b.cDefine &&
+            a.valDouble == b.valDouble && a.valInt == b.valInt &&
+            a.valString == b.valString && a.enumNames == b.enumNames &&
+            a.maxDouble == b.maxDouble && a.minDouble == b.minDouble &&
+            a.stepDouble == b.stepDouble &&
+            a.editorDecimalsDouble == b.editorDecimalsDouble &&
+            a.maxInt == b.maxInt && a.minInt == b.minInt &&
+            a.stepInt == b.stepInt && a.vTx == b.vTx &&
+            a.vTxDoubleScale == b.vTxDoubleScale && a.suffix == b.suffix &&
+            a.editorScale == b.editorScale &&
+            a.editAsPercentage == b.editAsPercentage &&
+            a.showDisplay == b.showDisplay &&
+            a.transmittable == b.transmittable;
+}
+}
+
+// Cache file that the descriptions are decoded from when they are needed.
+struct ConfigParams::DescriptionSource {
+    ~DescriptionSource() {
+        if (map) {
+            file.unmap(map);
+        }
+    }
+
+    QFile file;
+    uchar *map = nullptr;
+    QByteArray data; // The mapped file, or its content if it could not be mapped
+};
+
 ConfigParams::ConfigParams(QObject *parent) : QObject(parent)
 {
     mUpdateOnlyName.clear();
     mXmlStatus = tr("OK");
     mUpdatesEnabled = true;
+    mSerialPlanValid = false;
+    mSignature = 0;
+    mBatchDepth = 0;
 }
 
 void ConfigParams::addParam(const QString &name, ConfigParam param)
 {
-    if (!mParams.contains(name)) {
-        mParams.insert(name, param);
+    if (!mParamIndex.contains(name)) {
+        int slot = mParams.size();
+        int id = getParamId(name);
+
+        ParamValue v;
+        v.valDouble = param.valDouble;
+        v.valInt = param.valInt;
+        v.valString = param.valString;
+
+        mParams.append(param);
+        mValues.append(v);
+        mSlotNames.append(name);
+        mDescriptionPos.append(-1);
+        mParamIndex.insert(name, slot);
+        if (id >= mSlotOfId.size()) {
+            mSlotOfId.resize(id + 1);
+        }
+        mSlotOfId[id] = slot + 1;
+
         mParamList.append(name);
+        mSerialPlanValid = false;
     } else {
         qWarning() << name << "already present.";
     }
 }
 
+/**
+ * @brief ConfigParams::setParam
+ * Replace the definition and value of a parameter that already exists.
+ */
+void ConfigParams::setParam(const QString &name, const ConfigParam &param)
+{
+    int slot = slotOf(name);
+
+    if (slot >= 0) {
+        mParams[slot] = param;
+        mDescriptionPos[slot] = -1;
+
+        if (mParamViews.contains(slot)) {
+            mParamViews[slot] = param;
+        }
+        mValues[slot].valDouble = param.valDouble;
+        mValues[slot].valInt = param.valInt;
+        mValues[slot].valString = param.valString;
+        mSerialPlanValid = false;
+    } else {
+        qWarning() << name << "not found";
+    }
+}
+
 void ConfigParams::deleteParam(const QString &name)
 {
-    mParams.remove(name);
+    int slot = slotOf(name);
+    if (slot >= 0) {
+        mParams.remove(slot);
+        mValues.remove(slot);
+        mSlotNames.removeAt(slot);
+        mDescriptionPos.remove(slot);
+        mBatchSlots.clear();
+        mParamViews.clear();
+        rebuildIndex();
+        mSerialPlanValid = false;
+    }
+
     for (int i = 0;i < mParamList.size();i++) {
         if (mParamList.at(i) == name) {
             mParamList.removeAt(i);
@@ -89,7 +237,16 @@ void ConfigParams::setUpdatesEnabled(bool updatesEnabled)
 void ConfigParams::clearParams()
 {
     mParams.clear();
+    mValues.clear();
+    mSlotNames.clear();
+    mParamIndex.clear();
+    mSlotOfId.clear();
+    mDescriptionPos.clear();
+    mDescriptionSource.clear();
+    mBatchSlots.clear();
+    mParamViews.clear();
     mParamList.clear();
+    mSerialPlanValid = false;
 }
 
 void ConfigParams::clearAll()
@@ -100,15 +257,65 @@ void ConfigParams::clearAll()
 
 bool ConfigParams::hasParam(const QString &name)
 {
-    return mParams.contains(name);
+    return mParamIndex.contains(name);
+}
+
+bool ConfigParams::hasParam(int id)
+{
+    return slotOf(id) >= 0;
+}
+
+/**
+ * @brief ConfigParams::getParamId
+ * Get the ID of a parameter name. IDs are the same for all configurations
+ * and never change while VESC Tool runs, so they can be resolved once and
+ * used instead of the name to avoid hashing strings on every access.
+ */
+int ConfigParams::getParamId(const QString &name)
+{
+    QMutexLocker locker(&internMutex);
+
+    int id = internIds.value(name, -1);
+    if (id < 0) {
+        id = internNames.size();
+        internIds.insert(name, id);
+        internNames.append(name);
+    }
+
+    return id;
 }
 
-ConfigParam *ConfigParams::getParam(const QString &name)
+QString ConfigParams::getParamName(int id)
 {
-    ConfigParam *retVal = nullptr;
+    QMutexLocker locker(&internMutex);
+    return internNames.value(id);
+}
+
+/**
+ * @brief ConfigParams::getParam
+ * Get the definition of a parameter with its current value. The view stays
+ * valid until the parameter is deleted or the definitions are replaced, and
+ * is updated on every call. Use the updateParam functions or setParam to
+ * change the parameter.
+ */
+const ConfigParam *ConfigParams::getParam(const QString &name)
+{
+    const ConfigParam *retVal = nullptr;
+    int slot = slotOf(name);
+
+    if (slot >= 0) {
+        // The definitions are shared with the copies of this object, so
+        // the view is kept apart to not detach them.
+        auto it = mParamViews.find(slot);
+        if (it == mParamViews.end()) {
+            it = mParamViews.insert(slot, mParams.at(slot));
+            it->description = descriptionOf(slot);
+        }
 
-    if (mParams.contains(name)) {
-        retVal = &mParams[name];
+        it->valDouble = mValues.at(slot).valDouble;
+        it->valInt = mValues.at(slot).valInt;
+        it->valString = mValues.at(slot).valString;
+        retVal = &it.value();
     } else {
         qWarning() << name << "not found";
     }
@@ -119,9 +326,14 @@ ConfigParam *ConfigParams::getParam(const QString &name)
 ConfigParam ConfigParams::getParamCopy(const QString &name) const
 {
     ConfigParam retVal;
-
-    if (mParams.contains(name)) {
-        retVal = mParams.value(name);
+    int slot = slotOf(name);
+
+    if (slot >= 0) {
+        retVal = mParams.at(slot);
+        retVal.description = descriptionOf(slot);
+        retVal.valDouble = mValues.at(slot).valDouble;
+        retVal.valInt = mValues.at(slot).valInt;
+        retVal.valString = mValues.at(slot).valString;
     } else {
         qWarning() << name << "not found";
     }
@@ -131,150 +343,155 @@ ConfigParam ConfigParams::getParamCopy(const QString &name) const
 
 bool ConfigParams::isParamDouble(const QString &name)
 {
-    if (mParams.contains(name) && mParams[name].type == CFG_T_DOUBLE) {
-        return true;
-    } else {
-        return false;
-    }
+    int slot = slotOf(name);
+    return slot >= 0 && mParams.at(slot).type == CFG_T_DOUBLE;
 }
 
 bool ConfigParams::isParamInt(const QString &name)
 {
-    if (mParams.contains(name) && mParams[name].type == CFG_T_INT) {
-        return true;
-    } else {
-        return false;
-    }
+    int slot = slotOf(name);
+    return slot >= 0 && mParams.at(slot).type == CFG_T_INT;
 }
 
 bool ConfigParams::isParamEnum(const QString &name)
 {
-    if (mParams.contains(name) && mParams[name].type == CFG_T_ENUM) {
-        return true;
-    } else {
-        return false;
-    }
+    int slot = slotOf(name);
+    return slot >= 0 && mParams.at(slot).type == CFG_T_ENUM;
 }
 
 bool ConfigParams::isParamQString(const QString &name)
 {
-    if (mParams.contains(name) && mParams[name].type == CFG_T_QSTRING) {
-        return true;
-    } else {
-        return false;
-    }
+    int slot = slotOf(name);
+    return slot >= 0 && mParams.at(slot).type == CFG_T_QSTRING;
 }
 
 bool ConfigParams::isParamBool(const QString &name)
 {
-    if (mParams.contains(name) && mParams[name].type == CFG_T_BOOL) {
-        return true;
-    } else {
-        return false;
-    }
+    int slot = slotOf(name);
+    return slot >= 0 && mParams.at(slot).type == CFG_T_BOOL;
 }
 
 double ConfigParams::getParamDouble(const QString &name)
 {
-    double retVal = 0.0;
-
-    if (mParams.contains(name)) {
-        ConfigParam &p = mParams[name];
+    int slot = slotOf(name);
 
-        if (p.type == CFG_T_DOUBLE) {
-            retVal = p.valDouble;
-        } else {
-            qWarning() << name << "wrong type";
-        }
-    } else {
+    if (slot < 0) {
         qWarning() << name << "not found";
+        return 0.0;
     }
 
-    return retVal;
+    return valueDouble(slot);
 }
 
-int ConfigParams::getParamInt(const QString &name)
+double ConfigParams::getParamDouble(int id)
 {
-    int retVal = 0;
+    int slot = slotOf(id);
 
-    if (mParams.contains(name)) {
-        ConfigParam &p = mParams[name];
+    if (slot < 0) {
+        qWarning() << getParamName(id) << "not found";
+        return 0.0;
+    }
 
-        if (p.type == CFG_T_INT) {
-            retVal = p.valInt;
-        } else {
-            qWarning() << name << "wrong type";
-        }
-    } else {
+    return valueDouble(slot);
+}
+
+int ConfigParams::getParamInt(const QString &name)
+{
+    int slot = slotOf(name);
+
+    if (slot < 0) {
         qWarning() << name << "not found";
+        return 0;
     }
 
-    return retVal;
+    return valueInt(slot, CFG_T_INT);
 }
 
-int ConfigParams::getParamEnum(const QString &name)
+int ConfigParams::getParamInt(int id)
 {
-    int retVal = 0;
+    int slot = slotOf(id);
 
-    if (mParams.contains(name)) {
-        ConfigParam &p = mParams[name];
+    if (slot < 0) {
+        qWarning() << getParamName(id) << "not found";
+        return 0;
+    }
 
-        if (p.type == CFG_T_ENUM) {
-            retVal = p.valInt;
-        } else {
-            qWarning() << name << "wrong type";
-        }
-    } else {
+    return valueInt(slot, CFG_T_INT);
+}
+
+int ConfigParams::getParamEnum(const QString &name)
+{
+    int slot = slotOf(name);
+
+    if (slot < 0) {
         qWarning() << name << "not found";
+        return 0;
     }
 
-    return retVal;
+    return valueInt(slot, CFG_T_ENUM);
 }
 
-QString ConfigParams::getParamQString(const QString &name)
+int ConfigParams::getParamEnum(int id)
 {
-    QString retVal = "";
+    int slot = slotOf(id);
 
-    if (mParams.contains(name)) {
-        ConfigParam &p = mParams[name];
+    if (slot < 0) {
+        qWarning() << getParamName(id) << "not found";
+        return 0;
+    }
 
-        if (p.type == CFG_T_QSTRING) {
-            retVal = p.valString;
-        } else {
-            qWarning() << name << "wrong type";
-        }
-    } else {
+    return valueInt(slot, CFG_T_ENUM);
+}
+
+QString ConfigParams::getParamQString(const QString &name)
+{
+    int slot = slotOf(name);
+
+    if (slot < 0) {
         qWarning() << name << "not found";
+        return "";
     }
 
-    return retVal;
+    if (mParams.at(slot).type != CFG_T_QSTRING) {
+        qWarning() << name << "wrong type";
+        return "";
+    }
+
+    return mValues.at(slot).valString;
 }
 
 bool ConfigParams::getParamBool(const QString &name)
 {
-    bool retVal = false;
-
-    if (mParams.contains(name)) {
-        ConfigParam &p = mParams[name];
+    int slot = slotOf(name);
 
-        if (p.type == CFG_T_BOOL) {
-            retVal = p.valInt;
-        } else {
-            qWarning() << name << "wrong type";
-        }
-    } else {
+    if (slot < 0) {
         qWarning() << name << "not found";
+        return false;
     }
 
-    return retVal;
+    return valueInt(slot, CFG_T_BOOL);
+}
+
+bool ConfigParams::getParamBool(int id)
+{
+    int slot = slotOf(id);
+
+    if (slot < 0) {
+        qWarning() << getParamName(id) << "not found";
+        return false;
+    }
+
+    return valueInt(slot, CFG_T_BOOL);
 }
 
 QString ConfigParams::getLongName(const QString &name)
 {
     QString retVal = "";
 
-    if (mParams.contains(name)) {
-        retVal = mParams[name].longName;
+    int slot = slotOf(name);
+
+    if (slot >= 0) {
+        retVal = mParams.at(slot).longName;
     } else {
         qWarning() << name << "not found";
     }
@@ -286,8 +503,10 @@ QString ConfigParams::getDescription(const QString &name)
 {
     QString retVal = "";
 
-    if (mParams.contains(name)) {
-        retVal = mParams[name].description;
+    int slot = slotOf(name);
+
+    if (slot >= 0) {
+        retVal = descriptionOf(slot);
     } else {
         qWarning() << name << "not found";
     }
@@ -299,8 +518,10 @@ double ConfigParams::getParamMaxDouble(const QString &name)
 {
     double retVal = 0.0;
 
-    if (mParams.contains(name)) {
-        ConfigParam &p = mParams[name];
+    int slot = slotOf(name);
+
+    if (slot >= 0) {
+        const ConfigParam &p = mParams.at(slot);
 
         if (p.type == CFG_T_DOUBLE) {
             retVal = p.maxDouble;
@@ -318,8 +539,10 @@ double ConfigParams::getParamMinDouble(const QString &name)
 {
     double retVal = 0.0;
 
-    if (mParams.contains(name)) {
-        ConfigParam &p = mParams[name];
+    int slot = slotOf(name);
+
+    if (slot >= 0) {
+        const ConfigParam &p = mParams.at(slot);
 
         if (p.type == CFG_T_DOUBLE) {
             retVal = p.minDouble;
@@ -337,8 +560,10 @@ double ConfigParams::getParamStepDouble(const QString &name)
 {
     double retVal = 0.0;
 
-    if (mParams.contains(name)) {
-        ConfigParam &p = mParams[name];
+    int slot = slotOf(name);
+
+    if (slot >= 0) {
+        const ConfigParam &p = mParams.at(slot);
 
         if (p.type == CFG_T_DOUBLE) {
             retVal = p.stepDouble;
@@ -356,8 +581,10 @@ int ConfigParams::getParamDecimalsDouble(const QString &name)
 {
     int retVal = 0;
 
-    if (mParams.contains(name)) {
-        ConfigParam &p = mParams[name];
+    int slot = slotOf(name);
+
+    if (slot >= 0) {
+        const ConfigParam &p = mParams.at(slot);
 
         if (p.type == CFG_T_DOUBLE) {
             retVal = p.editorDecimalsDouble;
@@ -375,8 +602,10 @@ int ConfigParams::getParamMaxInt(const QString &name)
 {
     int retVal = 0;
 
-    if (mParams.contains(name)) {
-        ConfigParam &p = mParams[name];
+    int slot = slotOf(name);
+
+    if (slot >= 0) {
+        const ConfigParam &p = mParams.at(slot);
 
         if (p.type == CFG_T_INT) {
             retVal = p.maxInt;
@@ -394,8 +623,10 @@ int ConfigParams::getParamMinInt(const QString &name)
 {
     int retVal = 0;
 
-    if (mParams.contains(name)) {
-        ConfigParam &p = mParams[name];
+    int slot = slotOf(name);
+
+    if (slot >= 0) {
+        const ConfigParam &p = mParams.at(slot);
 
         if (p.type == CFG_T_INT) {
             retVal = p.minInt;
@@ -413,8 +644,10 @@ int ConfigParams::getParamStepInt(const QString &name)
 {
     int retVal = 0;
 
-    if (mParams.contains(name)) {
-        ConfigParam &p = mParams[name];
+    int slot = slotOf(name);
+
+    if (slot >= 0) {
+        const ConfigParam &p = mParams.at(slot);
 
         if (p.type == CFG_T_INT) {
             retVal = p.stepInt;
@@ -432,8 +665,10 @@ QStringList ConfigParams::getParamEnumNames(const QString &name)
 {
     QStringList retVal;
 
-    if (mParams.contains(name)) {
-        ConfigParam &p = mParams[name];
+    int slot = slotOf(name);
+
+    if (slot >= 0) {
+        const ConfigParam &p = mParams.at(slot);
 
         if (p.type == CFG_T_ENUM) {
             retVal = p.enumNames;
@@ -451,8 +686,10 @@ double ConfigParams::getParamEditorScale(const QString &name)
 {
     double retVal = 0.0;
 
-    if (mParams.contains(name)) {
-        retVal = mParams[name].editorScale;
+    int slot = slotOf(name);
+
+    if (slot >= 0) {
+        retVal = mParams.at(slot).editorScale;
     } else {
         qWarning() << name << "not found";
     }
@@ -464,8 +701,10 @@ QString ConfigParams::getParamSuffix(const QString &name)
 {
     QString retVal = "";
 
-    if (mParams.contains(name)) {
-        retVal = mParams[name].suffix;
+    int slot = slotOf(name);
+
+    if (slot >= 0) {
+        retVal = mParams.at(slot).suffix;
     } else {
         qWarning() << name << "not found";
     }
@@ -477,8 +716,10 @@ bool ConfigParams::getParamEditAsPercentage(const QString &name)
 {
     bool retVal = false;
 
-    if (mParams.contains(name)) {
-        retVal = mParams[name].editAsPercentage;
+    int slot = slotOf(name);
+
+    if (slot >= 0) {
+        retVal = mParams.at(slot).editAsPercentage;
     } else {
         qWarning() << name << "not found";
     }
@@ -490,8 +731,10 @@ bool ConfigParams::getParamShowDisplay(const QString &name)
 {
     bool retVal = false;
 
-    if (mParams.contains(name)) {
-        retVal = mParams[name].showDisplay;
+    int slot = slotOf(name);
+
+    if (slot >= 0) {
+        retVal = mParams.at(slot).showDisplay;
     } else {
         qWarning() << name << "not found";
     }
@@ -503,8 +746,10 @@ bool ConfigParams::getParamTransmittable(const QString &name)
 {
     bool retVal = false;
 
-    if (mParams.contains(name)) {
-        retVal = mParams[name].transmittable;
+    int slot = slotOf(name);
+
+    if (slot >= 0) {
+        retVal = mParams.at(slot).transmittable;
     } else {
         qWarning() << name << "not found";
     }
@@ -523,72 +768,13 @@ void ConfigParams::setParamOrder(const QStringList &order)
     mParamList = order;
 }
 
-QWidget *ConfigParams::getEditor(const QString &name, QWidget *parent)
-{
-    QWidget *retVal = 0;
-
-    if (mParams.contains(name)) {
-        ConfigParam &p = mParams[name];
-
-        switch (p.type) {
-        case CFG_T_DOUBLE: {
-            ParamEditDouble *edit = new ParamEditDouble(parent);
-            edit->setName(name);
-            edit->setSuffix(p.suffix);
-            edit->setDecimals(p.editorDecimalsDouble);
-            edit->setShowAsPercentage(p.editAsPercentage);
-            edit->showDisplay(p.showDisplay);
-            edit->setConfig(this);
-            retVal = edit;
-        } break;
-
-        case CFG_T_INT: {
-            ParamEditInt *edit = new ParamEditInt(parent);
-            edit->setName(name);
-            edit->setSuffix(p.suffix);
-            edit->setShowAsPercentage(p.editAsPercentage);
-            edit->showDisplay(p.showDisplay);
-            edit->setConfig(this);
-            retVal = edit;
-        } break;
-
-        case CFG_T_QSTRING: {
-            ParamEditString *edit = new ParamEditString(parent);
-            edit->setName(name);
-            edit->setConfig(this);
-            retVal = edit;
-        } break;
-
-        case CFG_T_ENUM: {
-            ParamEditEnum *edit = new ParamEditEnum(parent);
-            edit->setName(name);
-            edit->setConfig(this);
-            retVal = edit;
-        } break;
-
-        case CFG_T_BOOL: {
-            ParamEditBool *edit = new ParamEditBool(parent);
-            edit->setName(name);
-            edit->setConfig(this);
-            retVal = edit;
-        } break;
-
-        default:
-            qWarning() << "no editor for" << name << "could be created";
-            break;
-        }
-
-    } else {
-        qWarning() << name << "not found";
-    }
-
-    return retVal;
-}
-
 void ConfigParams::getParamSerial(VByteArray &vb, const QString &name)
 {
-    if (mParams.contains(name)) {
-        ConfigParam &p = mParams[name];
+    int slot = slotOf(name);
+
+    if (slot >= 0) {
+        const ConfigParam &p = mParams.at(slot);
+        const ParamValue &v = mValues.at(slot);
 
         switch (p.type) {
         case CFG_T_UNDEFINED:
@@ -597,11 +783,11 @@ void ConfigParams::getParamSerial(VByteArray &vb, const QString &name)
 
         case CFG_T_DOUBLE:
             if (p.vTx == VESC_TX_DOUBLE16) {
-                vb.vbAppendDouble16(p.valDouble, p.vTxDoubleScale);
+                vb.vbAppendDouble16(v.valDouble, p.vTxDoubleScale);
             } else if (p.vTx == VESC_TX_DOUBLE32) {
-                vb.vbAppendDouble32(p.valDouble, p.vTxDoubleScale);
+                vb.vbAppendDouble32(v.valDouble, p.vTxDoubleScale);
             } else if (p.vTx == VESC_TX_DOUBLE32_AUTO) {
-                vb.vbAppendDouble32Auto(p.valDouble);
+                vb.vbAppendDouble32Auto(v.valDouble);
             } else {
                 qWarning() << name << ": wrong tx type set.";
             }
@@ -609,17 +795,17 @@ void ConfigParams::getParamSerial(VByteArray &vb, const QString &name)
 
         case CFG_T_INT:
             if (p.vTx == VESC_TX_UINT8) {
-                vb.vbAppendUint8(p.valInt);
+                vb.vbAppendUint8(v.valInt);
             } else if (p.vTx == VESC_TX_INT8) {
-                vb.vbAppendInt8(p.valInt);
+                vb.vbAppendInt8(v.valInt);
             } else if (p.vTx == VESC_TX_UINT16) {
-                vb.vbAppendUint16(p.valInt);
+                vb.vbAppendUint16(v.valInt);
             } else if (p.vTx == VESC_TX_INT16) {
-                vb.vbAppendInt16(p.valInt);
+                vb.vbAppendInt16(v.valInt);
             } else if (p.vTx == VESC_TX_UINT32) {
-                vb.vbAppendUint32(p.valInt);
+                vb.vbAppendUint32(v.valInt);
             } else if (p.vTx == VESC_TX_INT32) {
-                vb.vbAppendInt32(p.valInt);
+                vb.vbAppendInt32(v.valInt);
             } else {
                 qWarning() << name << ": wrong tx type set.";
             }
@@ -631,7 +817,7 @@ void ConfigParams::getParamSerial(VByteArray &vb, const QString &name)
 
         case CFG_T_ENUM:
         case CFG_T_BOOL:
-            vb.vbAppendInt8(p.valInt);
+            vb.vbAppendInt8(v.valInt);
             break;
         }
     } else {
@@ -641,8 +827,10 @@ void ConfigParams::getParamSerial(VByteArray &vb, const QString &name)
 
 void ConfigParams::setParamSerial(VByteArray &vb, const QString &name, QObject *src)
 {
-    if (mParams.contains(name)) {
-        ConfigParam &p = mParams[name];
+    int slot = slotOf(name);
+
+    if (slot >= 0) {
+        const ConfigParam &p = mParams.at(slot);
 
         switch (p.type) {
         case CFG_T_UNDEFINED:
@@ -661,12 +849,7 @@ void ConfigParams::setParamSerial(VByteArray &vb, const QString &name, QObject *
                 qWarning() << name << ": wrong tx type set.";
             }
 
-            if (mUpdatesEnabled && (mUpdateOnlyName.isEmpty() || mUpdateOnlyName == name)) {
-                if (p.valDouble != val) {
-                    p.valDouble = val;
-                    emit paramChangedDouble(src, name, val);
-                }
-            }
+            setValueDouble(slot, name, val, src);
         } break;
 
         case CFG_T_INT: {
@@ -688,12 +871,7 @@ void ConfigParams::setParamSerial(VByteArray &vb, const QString &name, QObject *
                 qWarning() << name << ": wrong tx type set.";
             }
 
-            if (mUpdatesEnabled && (mUpdateOnlyName.isEmpty() || mUpdateOnlyName == name)) {
-                if (p.valInt != val) {
-                    p.valInt = val;
-                    emit paramChangedInt(src, name, val);
-                }
-            }
+            setValueInt(slot, name, CFG_T_INT, val, src);
         } break;
 
         case CFG_T_QSTRING:
@@ -701,20 +879,9 @@ void ConfigParams::setParamSerial(VByteArray &vb, const QString &name, QObject *
             break;
 
         case CFG_T_ENUM:
-        case CFG_T_BOOL: {
-            int val = vb.vbPopFrontInt8();
-
-            if (mUpdatesEnabled && (mUpdateOnlyName.isEmpty() || mUpdateOnlyName == name)) {
-                if (p.valInt != val) {
-                    p.valInt = val;
-                    if (p.type == CFG_T_BOOL) {
-                        emit paramChangedBool(src, name, val);
-                    } else {
-                        emit paramChangedEnum(src, name, val);
-                    }
-                }
-            }
-        } break;
+        case CFG_T_BOOL:
+            setValueInt(slot, name, p.type, vb.vbPopFrontInt8(), src);
+            break;
         }
     } else {
         qWarning() << name << "not found";
@@ -723,65 +890,35 @@ void ConfigParams::setParamSerial(VByteArray &vb, const QString &name, QObject *
 
 void ConfigParams::updateParamDouble(QString name, double param, QObject *src)
 {
-    if (!mUpdatesEnabled || (!mUpdateOnlyName.isEmpty() && mUpdateOnlyName != name)) {
-        return;
-    }
+    setValueDouble(slotOf(name), name, param, src);
+}
 
-    if (mParams.contains(name)) {
-        ConfigParam &p = mParams[name];
-        if (p.type == CFG_T_DOUBLE) {
-            if (p.valDouble != param) {
-                p.valDouble = param;
-                emit paramChangedDouble(src, name, param);
-            }
-        } else {
-            qWarning() << name << "wrong type";
-        }
-    } else {
-        qWarning() << name << "not found";
-    }
+void ConfigParams::updateParamDouble(int id, double param, QObject *src)
+{
+    int slot = slotOf(id);
+    setValueDouble(slot, slot >= 0 ? mSlotNames.at(slot) : getParamName(id), param, src);
 }
 
 void ConfigParams::updateParamInt(QString name, int param, QObject *src)
 {
-    if (!mUpdatesEnabled || (!mUpdateOnlyName.isEmpty() && mUpdateOnlyName != name)) {
-        return;
-    }
+    setValueInt(slotOf(name), name, CFG_T_INT, param, src);
+}
 
-    if (mParams.contains(name)) {
-        ConfigParam &p = mParams[name];
-        if (p.type == CFG_T_INT) {
-            if (p.valInt != param) {
-                p.valInt = param;
-                emit paramChangedInt(src, name, param);
-            }
-        } else {
-            qWarning() << name << "wrong type";
-        }
-    } else {
-        qWarning() << name << "not found";
-    }
+void ConfigParams::updateParamInt(int id, int param, QObject *src)
+{
+    int slot = slotOf(id);
+    setValueInt(slot, slot >= 0 ? mSlotNames.at(slot) : getParamName(id), CFG_T_INT, param, src);
 }
 
 void ConfigParams::updateParamEnum(QString name, int param, QObject *src)
 {
-    if (!mUpdatesEnabled || (!mUpdateOnlyName.isEmpty() && mUpdateOnlyName != name)) {
-        return;
-    }
+    setValueInt(slotOf(name), name, CFG_T_ENUM, param, src);
+}
 
-    if (mParams.contains(name)) {
-        ConfigParam &p = mParams[name];
-        if (p.type == CFG_T_ENUM) {
-            if (p.valInt != param) {
-                p.valInt = param;
-                emit paramChangedEnum(src, name, param);
-            }
-        } else {
-            qWarning() << name << "wrong type";
-        }
-    } else {
-        qWarning() << name << "not found";
-    }
+void ConfigParams::updateParamEnum(int id, int param, QObject *src)
+{
+    int slot = slotOf(id);
+    setValueInt(slot, slot >= 0 ? mSlotNames.at(slot) : getParamName(id), CFG_T_ENUM, param, src);
 }
 
 void ConfigParams::updateParamString(QString name, QString param, QObject *src)
@@ -790,12 +927,13 @@ void ConfigParams::updateParamString(QString name, QString param, QObject *src)
         return;
     }
 
-    if (mParams.contains(name)) {
-        ConfigParam &p = mParams[name];
-        if (p.type == CFG_T_QSTRING) {
-            if (p.valString != param) {
-                p.valString = param;
-                emit paramChangedQString(src, name, param);
+    int slot = slotOf(name);
+
+    if (slot >= 0) {
+        if (mParams.at(slot).type == CFG_T_QSTRING) {
+            if (mValues.at(slot).valString != param) {
+                mValues[slot].valString = param;
+                emitParamChanged(slot, src);
             }
         } else {
             qWarning() << name << "wrong type";
@@ -807,22 +945,55 @@ void ConfigParams::updateParamString(QString name, QString param, QObject *src)
 
 void ConfigParams::updateParamBool(QString name, bool param, QObject *src)
 {
-    if (!mUpdatesEnabled || (!mUpdateOnlyName.isEmpty() && mUpdateOnlyName != name)) {
+    setValueInt(slotOf(name), name, CFG_T_BOOL, param, src);
+}
+
+void ConfigParams::updateParamBool(int id, bool param, QObject *src)
+{
+    int slot = slotOf(id);
+    setValueInt(slot, slot >= 0 ? mSlotNames.at(slot) : getParamName(id), CFG_T_BOOL, param, src);
+}
+
+/**
+ * @brief ConfigParams::beginUpdateBatch
+ * Collect the changed parameters instead of emitting a paramChanged signal
+ * for each of them, until endUpdateBatch is called. Batches can be nested.
+ */
+void ConfigParams::beginUpdateBatch()
+{
+    mBatchDepth++;
+}
+
+/**
+ * @brief ConfigParams::endUpdateBatch
+ * End a batch started with beginUpdateBatch. When the outermost batch ends,
+ * the parameters that changed in it are emitted with one paramsChanged
+ * signal.
+ *
+ * @param src
+ * The source that is passed with paramsChanged.
+ */
+void ConfigParams::endUpdateBatch(QObject *src)
+{
+    if (mBatchDepth <= 0) {
+        qWarning() << "No update batch to end";
         return;
     }
 
-    if (mParams.contains(name)) {
-        ConfigParam &p = mParams[name];
-        if (p.type == CFG_T_BOOL) {
-            if (p.valInt != param) {
-                p.valInt = param;
-                emit paramChangedBool(src, name, param);
-            }
-        } else {
-            qWarning() << name << "wrong type";
+    mBatchDepth--;
+
+    if (mBatchDepth == 0 && !mBatchSlots.isEmpty()) {
+        QList<int> slotList = mBatchSlots.values();
+        std::sort(slotList.begin(), slotList.end());
+        mBatchSlots.clear();
+
+        QStringList names;
+        names.reserve(slotList.size());
+        for (int slot: slotList) {
+            names.append(mSlotNames.at(slot));
         }
-    } else {
-        qWarning() << name << "not found";
+
+        emit paramsChanged(src, names);
     }
 }
 
@@ -849,6 +1020,132 @@ bool ConfigParams::almostEqual(float A, float B, float eps)
     return fabsf(A - B) <= eps * fmaxf(1.0f, fmaxf(fabsf(A), fabsf(B)));
 }
 
+int ConfigParams::slotOf(const QString &name) const
+{
+    return mParamIndex.value(name, -1);
+}
+
+int ConfigParams::slotOf(int id) const
+{
+    // Slots are stored with an offset of one, so that 0 means not present
+    if (id >= 0 && id < mSlotOfId.size()) {
+        return mSlotOfId.at(id) - 1;
+    }
+    return -1;
+}
+
+void ConfigParams::rebuildIndex()
+{
+    mParamIndex.clear();
+    mSlotOfId.clear();
+
+    for (int i = 0;i < mSlotNames.size();i++) {
+        int id = getParamId(mSlotNames.at(i));
+        mParamIndex.insert(mSlotNames.at(i), i);
+        if (id >= mSlotOfId.size()) {
+            mSlotOfId.resize(id + 1);
+        }
+        mSlotOfId[id] = i + 1;
+    }
+}
+
+void ConfigParams::emitParamChanged(int slot, QObject *src)
+{
+    if (mBatchDepth > 0) {
+        mBatchSlots.insert(slot);
+        return;
+    }
+
+    const QString &name = mSlotNames.at(slot);
+    const ParamValue &v = mValues.at(slot);
+
+    switch (mParams.at(slot).type) {
+    case CFG_T_DOUBLE: emit paramChangedDouble(src, name, v.valDouble); break;
+    case CFG_T_INT: emit paramChangedInt(src, name, v.valInt); break;
+    case CFG_T_ENUM: emit paramChangedEnum(src, name, v.valInt); break;
+    case CFG_T_BOOL: emit paramChangedBool(src, name, v.valInt); break;
+    case CFG_T_QSTRING: emit paramChangedQString(src, name, v.valString); break;
+    default: break;
+    }
+}
+
+QString ConfigParams::descriptionOf(int slot) const
+{
+    qint64 pos = mDescriptionPos.at(slot);
+
+    if (pos < 0 || !mDescriptionSource) {
+        return mParams.at(slot).description;
+    }
+
+    QString res;
+    QDataStream in(mDescriptionSource->data);
+    in.setVersion(QDataStream::Qt_5_0);
+    in.device()->seek(pos);
+    in >> res;
+    return res;
+}
+
+
+double ConfigParams::valueDouble(int slot) const
+{
+    if (mParams.at(slot).type != CFG_T_DOUBLE) {
+        qWarning() << mSlotNames.at(slot) << "wrong type";
+        return 0.0;
+    }
+
+    return mValues.at(slot).valDouble;
+}
+
+int ConfigParams::valueInt(int slot, CFG_T type) const
+{
+    if (mParams.at(slot).type != type) {
+        qWarning() << mSlotNames.at(slot) << "wrong type";
+        return 0;
+    }
+
+    return mValues.at(slot).valInt;
+}
+
+void ConfigParams::setValueDouble(int slot, const QString &name, double param, QObject *src)
+{
+    if (!mUpdatesEnabled || (!mUpdateOnlyName.isEmpty() && mUpdateOnlyName != name)) {
+        return;
+    }
+
+    if (slot >= 0) {
+        if (mParams.at(slot).type == CFG_T_DOUBLE) {
+            if (mValues.at(slot).valDouble != param) {
+                mValues[slot].valDouble = param;
+                emitParamChanged(slot, src);
+            }
+        } else {
+            qWarning() << name << "wrong type";
+        }
+    } else {
+        qWarning() << name << "not found";
+    }
+}
+
+void ConfigParams::setValueInt(int slot, const QString &name, CFG_T type, int param, QObject *src)
+{
+    if (!mUpdatesEnabled || (!mUpdateOnlyName.isEmpty() && mUpdateOnlyName != name)) {
+        return;
+    }
+
+    if (slot >= 0) {
+        if (mParams.at(slot).type == type) {
+            if (mValues.at(slot).valInt != param) {
+                mValues[slot].valInt = param;
+                emitParamChanged(slot, src);
+            }
+        } else {
+            qWarning() << name << "wrong type";
+        }
+    } else {
+        qWarning() << name << "not found";
+    }
+}
+
 QStringList ConfigParams::getSerializeOrder() const
 {
     return mSerializeOrder;
@@ -857,35 +1154,103 @@ QStringList ConfigParams::getSerializeOrder() const
 void ConfigParams::setSerializeOrder(const QStringList &serializeOrder)
 {
     mSerializeOrder = serializeOrder;
+    mSerialPlanValid = false;
 }
 
 void ConfigParams::clearSerializeOrder()
 {
     mSerializeOrder.clear();
+    mSerialPlanValid = false;
 }
 
+/**
+ * @brief ConfigParams::serialize
+ * Append the signature and all transmittable parameters in the format
+ * that the firmware uses.
+ */
 void ConfigParams::serialize(VByteArray &vb)
 {
-    vb.vbAppendUint32(getSignature());
+    if (!mSerialPlanValid) {
+        compileSerialPlan();
+    }
 
-    for (int i = 0;i < mSerializeOrder.size();i++) {
-        getParamSerial(vb, mSerializeOrder.at(i));
+    vb.vbAppendUint32(mSignature);
+
+    for (const auto &op: mSerialPlan) {
+        const ParamValue &p = mValues.at(op.slot);
+
+        switch (op.tx) {
+        case VESC_TX_UINT8: vb.vbAppendUint8(p.valInt); break;
+        case VESC_TX_INT8: vb.vbAppendInt8(p.valInt); break;
+        case VESC_TX_UINT16: vb.vbAppendUint16(p.valInt); break;
+        case VESC_TX_INT16: vb.vbAppendInt16(p.valInt); break;
+        case VESC_TX_UINT32: vb.vbAppendUint32(p.valInt); break;
+        case VESC_TX_INT32: vb.vbAppendInt32(p.valInt); break;
+        case VESC_TX_DOUBLE16: vb.vbAppendDouble16(p.valDouble, op.scale); break;
+        case VESC_TX_DOUBLE32: vb.vbAppendDouble32(p.valDouble, op.scale); break;
+        case VESC_TX_DOUBLE32_AUTO: vb.vbAppendDouble32Auto(p.valDouble); break;
+        default: break;
+        }
     }
 }
 
+/**
+ * @brief ConfigParams::deSerialize
+ * Update the parameters from data in the format of serialize. Nothing is
+ * updated if the signature does not match the loaded parameters.
+ */
 bool ConfigParams::deSerialize(VByteArray &vb)
 {
+    if (!mSerialPlanValid) {
+        compileSerialPlan();
+    }
+
     auto signature = vb.vbPopFrontUint32();
 
-    if (signature != getSignature()) {
+    if (signature != mSignature) {
         qWarning() << "Invalid signature";
         return false;
     }
 
-    for (int i = 0;i < mSerializeOrder.size();i++) {
-        setParamSerial(vb, mSerializeOrder.at(i));
+    beginUpdateBatch();
+
+    for (const auto &op: mSerialPlan) {
+        int valInt = 0;
+        double valDouble = 0.0;
+
+        switch (op.tx) {
+        case VESC_TX_UINT8: valInt = vb.vbPopFrontUint8(); break;
+        case VESC_TX_INT8: valInt = vb.vbPopFrontInt8(); break;
+        case VESC_TX_UINT16: valInt = vb.vbPopFrontUint16(); break;
+        case VESC_TX_INT16: valInt = vb.vbPopFrontInt16(); break;
+        case VESC_TX_UINT32: valInt = vb.vbPopFrontUint32(); break;
+        case VESC_TX_INT32: valInt = vb.vbPopFrontInt32(); break;
+        case VESC_TX_DOUBLE16: valDouble = vb.vbPopFrontDouble16(op.scale); break;
+        case VESC_TX_DOUBLE32: valDouble = vb.vbPopFrontDouble32(op.scale); break;
+        case VESC_TX_DOUBLE32_AUTO: valDouble = vb.vbPopFrontDouble32Auto(); break;
+        default: break;
+        }
+
+        if (!mUpdatesEnabled || (!mUpdateOnlyName.isEmpty() &&
+                                 mUpdateOnlyName != mSerializeOrder.at(op.order))) {
+            continue;
+        }
+
+        ParamValue &p = mValues[op.slot];
+
+        if (op.type == CFG_T_DOUBLE) {
+            if (p.valDouble != valDouble) {
+                p.valDouble = valDouble;
+                emitParamChanged(op.slot, nullptr);
+            }
+        } else if (p.valInt != valInt) {
+            p.valInt = valInt;
+            emitParamChanged(op.slot, nullptr);
+        }
     }
 
+    endUpdateBatch();
+
     return true;
 }
 
@@ -895,22 +1260,29 @@ void ConfigParams::getXML(QXmlStreamWriter &stream, QString configName)
     stream.writeStartElement(configName);
 
     for (QString s: mParamList) {
-        const ConfigParam p = mParams[s];
+        int slot = slotOf(s);
+        if (slot < 0) {
+            qWarning() << s << "not found";
+            continue;
+        }
+
+        const ConfigParam &p = mParams.at(slot);
+        const ParamValue &v = mValues.at(slot);
         QString name = s;
 
         switch (p.type) {
         case CFG_T_BOOL:
         case CFG_T_ENUM:
         case CFG_T_INT:
-            stream.writeTextElement(name, QString::number(p.valInt));
+            stream.writeTextElement(name, QString::number(v.valInt));
             break;
 
         case CFG_T_DOUBLE:
-            stream.writeTextElement(name, QString::number(p.valDouble));
+            stream.writeTextElement(name, QString::number(v.valDouble));
             break;
 
         case CFG_T_QSTRING:
-            stream.writeTextElement(name, p.valString);
+            stream.writeTextElement(name, v.valString);
             break;
 
         case CFG_T_UNDEFINED:
@@ -933,48 +1305,52 @@ bool ConfigParams::setXML(QXmlStreamReader &stream, QString configName)
     }
 
     if (nameFound) {
+        beginUpdateBatch();
+
         while (stream.readNextStartElement()) {
             QString name = stream.name().toString();
 
-            if (mParams.contains(name)) {
-                ConfigParam &p = mParams[name];
+            int slot = slotOf(name);
+            if (slot >= 0) {
+                const ConfigParam &p = mParams.at(slot);
+                ParamValue &v = mValues[slot];
                 QString text = stream.readElementText();
                 int valInt = text.toInt();
                 double valDouble = text.toDouble();
 
                 switch (p.type) {
                 case CFG_T_BOOL:
-                    if (valInt != p.valInt) {
-                        p.valInt = valInt;
-                        emit paramChangedBool(nullptr, name, valInt);
+                    if (valInt != v.valInt) {
+                        v.valInt = valInt;
+                        emitParamChanged(slot, nullptr);
                     }
                     break;
 
                 case CFG_T_ENUM:
-                    if (valInt != p.valInt) {
-                        p.valInt = valInt;
-                        emit paramChangedEnum(nullptr, name, valInt);
+                    if (valInt != v.valInt) {
+                        v.valInt = valInt;
+                        emitParamChanged(slot, nullptr);
                     }
                     break;
 
                 case CFG_T_INT:
-                    if (valInt != p.valInt) {
-                        p.valInt = valInt;
-                        emit paramChangedInt(nullptr, name, valInt);
+                    if (valInt != v.valInt) {
+                        v.valInt = valInt;
+                        emitParamChanged(slot, nullptr);
                     }
                     break;
 
                 case CFG_T_DOUBLE:
-                    if (valDouble != p.valDouble) {
-                        p.valDouble = valDouble;
-                        emit paramChangedDouble(nullptr, name, valDouble);
+                    if (valDouble != v.valDouble) {
+                        v.valDouble = valDouble;
+                        emitParamChanged(slot, nullptr);
                     }
                     break;
 
                 case CFG_T_QSTRING:
-                    if (text != p.valString) {
-                        p.valString = text;
-                        emit paramChangedQString(nullptr, name, text);
+                    if (text != v.valString) {
+                        v.valString = text;
+                        emitParamChanged(slot, nullptr);
                     }
                     break;
 
@@ -993,6 +1369,8 @@ bool ConfigParams::setXML(QXmlStreamReader &stream, QString configName)
             }
         }
 
+        endUpdateBatch();
+
         mXmlStatus = tr("OK");
         emit updated();
         return true;
@@ -1103,56 +1481,56 @@ void ConfigParams::getParamsXML(QXmlStreamWriter &stream)
 
     for (int i = 0;i < mParamList.size();i++) {
         QString paramName = mParamList.at(i);
-        ConfigParam *p = getParam(paramName);
+        const ConfigParam p = getParamCopy(paramName);
 
         stream.writeStartElement(paramName);
 
-        stream.writeTextElement("longName", p->longName);
-        stream.writeTextElement("type", QString::number(p->type));
-        stream.writeTextElement("transmittable", QString::number(p->transmittable));
-        stream.writeTextElement("description", p->description);
-        stream.writeTextElement("cDefine", p->cDefine);
+        stream.writeTextElement("longName", p.longName);
+        stream.writeTextElement("type", QString::number(p.type));
+        stream.writeTextElement("transmittable", QString::number(p.transmittable));
+        stream.writeTextElement("description", p.description);
+        stream.writeTextElement("cDefine", p.cDefine);
 
-        switch (p->type) {
+        switch (p.type) {
         case CFG_T_DOUBLE:
-            stream.writeTextElement("editorDecimalsDouble", QString::number(p->editorDecimalsDouble));
-            stream.writeTextElement("editorScale", QString::number(p->editorScale));
-            stream.writeTextElement("editAsPercentage", QString::number(p->editAsPercentage));
-            stream.writeTextElement("maxDouble", QString::number(p->maxDouble));
-            stream.writeTextElement("minDouble", QString::number(p->minDouble));
-            stream.writeTextElement("showDisplay", QString::number(p->showDisplay));
-            stream.writeTextElement("stepDouble", QString::number(p->stepDouble));
-            stream.writeTextElement("valDouble", QString::number(p->valDouble));
-            stream.writeTextElement("vTxDoubleScale", QString::number(p->vTxDoubleScale));
-            stream.writeTextElement("suffix", p->suffix);
-            stream.writeTextElement("vTx", QString::number(p->vTx));
+            stream.writeTextElement("editorDecimalsDouble", QString::number(p.editorDecimalsDouble));
+            stream.writeTextElement("editorScale", QString::number(p.editorScale));
+            stream.writeTextElement("editAsPercentage", QString::number(p.editAsPercentage));
+            stream.writeTextElement("maxDouble", QString::number(p.maxDouble));
+            stream.writeTextElement("minDouble", QString::number(p.minDouble));
+            stream.writeTextElement("showDisplay", QString::number(p.showDisplay));
+            stream.writeTextElement("stepDouble", QString::number(p.stepDouble));
+            stream.writeTextElement("valDouble", QString::number(p.valDouble));
+            stream.writeTextElement("vTxDoubleScale", QString::number(p.vTxDoubleScale));
+            stream.writeTextElement("suffix", p.suffix);
+            stream.writeTextElement("vTx", QString::number(p.vTx));
             break;
 
         case CFG_T_INT:
-            stream.writeTextElement("editorScale", QString::number(p->editorScale));
-            stream.writeTextElement("editAsPercentage", QString::number(p->editAsPercentage));
-            stream.writeTextElement("maxInt", QString::number(p->maxInt));
-            stream.writeTextElement("minInt", QString::number(p->minInt));
-            stream.writeTextElement("showDisplay", QString::number(p->showDisplay));
-            stream.writeTextElement("stepInt", QString::number(p->stepInt));
-            stream.writeTextElement("valInt", QString::number(p->valInt));
-            stream.writeTextElement("suffix", p->suffix);
-            stream.writeTextElement("vTx", QString::number(p->vTx));
+            stream.writeTextElement("editorScale", QString::number(p.editorScale));
+            stream.writeTextElement("editAsPercentage", QString::number(p.editAsPercentage));
+            stream.writeTextElement("maxInt", QString::number(p.maxInt));
+            stream.writeTextElement("minInt", QString::number(p.minInt));
+            stream.writeTextElement("showDisplay", QString::number(p.showDisplay));
+            stream.writeTextElement("stepInt", QString::number(p.stepInt));
+            stream.writeTextElement("valInt", QString::number(p.valInt));
+            stream.writeTextElement("suffix", p.suffix);
+            stream.writeTextElement("vTx", QString::number(p.vTx));
             break;
 
         case CFG_T_QSTRING:
-            stream.writeTextElement("valString", p->valString);
+            stream.writeTextElement("valString", p.valString);
             break;
 
         case CFG_T_ENUM:
-            stream.writeTextElement("valInt", QString::number(p->valInt));
-            for (int j = 0;j < p->enumNames.size();j++) {
-                stream.writeTextElement("enumNames", p->enumNames.at(j));
+            stream.writeTextElement("valInt", QString::number(p.valInt));
+            for (int j = 0;j < p.enumNames.size();j++) {
+                stream.writeTextElement("enumNames", p.enumNames.at(j));
             }
             break;
 
         case CFG_T_BOOL:
-            stream.writeTextElement("valInt", QString::number(p->valInt));
+            stream.writeTextElement("valInt", QString::number(p.valInt));
             break;
 
         default:
@@ -1274,7 +1652,7 @@ bool ConfigParams::setParamsXML(QXmlStreamReader &stream)
                     addParam(paramName, p);
                 }
             } else if (nameFirst == "SerOrder") {
-                mSerializeOrder.clear();
+                clearSerializeOrder();
                 while (stream.readNextStartElement()) {
                     QString name = stream.name().toString();
 
@@ -1382,6 +1760,259 @@ bool ConfigParams::loadParamsXml(QString fileName)
     return res;
 }
 
+/**
+ * @brief ConfigParams::loadParamsCached
+ * Same as loadParamsXml, but the definitions are read from a binary cache
+ * that is created from the XML file the first time it is loaded. The XML
+ * file stays the source of truth: the cache is only used while the size
+ * and modification time of the XML file, the cache format and, in builds
+ * that define VT_VERSION, the VESC Tool version match the ones it was
+ * created from. A new cache is only kept when loading it back gives
+ * exactly the same definitions as the XML file.
+ *
+ * @param fileName
+ * The XML file with the parameter definitions.
+ *
+ * @return
+ * true for success, false otherwise.
+ */
+bool ConfigParams::loadParamsCached(QString fileName)
+{
+    QString key = paramsCacheKey(fileName);
+    QString cachePath = paramsCachePath(fileName);
+
+    // The cache stays mapped, as the descriptions are only decoded from it
+    // when they are asked for.
+    QSharedPointer<DescriptionSource> source(new DescriptionSource);
+    source->file.setFileName(cachePath);
+
+    if (source->file.open(QIODevice::ReadOnly)) {
+        qint64 size = source->file.size();
+        source->map = source->file.map(0, size);
+
+        if (source->map) {
+            source->data = QByteArray::fromRawData(reinterpret_cast<const char*>(source->map), int(size));
+        } else {
+            source->data = source->file.readAll();
+            source->file.close();
+        }
+
+        if (setParamsBinary(source->data, key, source)) {
+            return true;
+        }
+    }
+
+    source.clear();
+
+    if (!loadParamsXml(fileName)) {
+        return false;
+    }
+
+    QByteArray data = getParamsBinary(key);
+
+    ConfigParams check;
+    if (!check.setParamsBinary(data, key) || !check.isDefinitionEqual(*this)) {
+        qWarning() << "Binary parameter cache does not match" << fileName;
+        return true;
+    }
+
+    QDir().mkpath(QFileInfo(cachePath).absolutePath());
+    QSaveFile file(cachePath);
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(data);
+        file.commit();
+    }
+
+    return true;
+}
+
+/**
+ * @brief ConfigParams::verifyParamsCache
+ * Load fileName both from XML and from the binary cache, and check that
+ * they give the same definitions.
+ *
+ * @return
+ * true if the cache exists and matches the XML file.
+ */
+bool ConfigParams::verifyParamsCache(QString fileName)
+{
+    QFile cache(paramsCachePath(fileName));
+    if (!cache.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    ConfigParams fromXml;
+    ConfigParams fromCache;
+
+    return fromXml.loadParamsXml(fileName) &&
+            fromCache.setParamsBinary(cache.readAll(), paramsCacheKey(fileName)) &&
+            fromCache.isDefinitionEqual(fromXml);
+}
+
+/**
+ * @brief ConfigParams::clearParamsCache
+ * Remove all binary parameter caches.
+ */
+void ConfigParams::clearParamsCache()
+{
+    QDir(QFileInfo(paramsCachePath("")).absolutePath()).removeRecursively();
+}
+
+/**
+ * @brief ConfigParams::isDefinitionEqual
+ * Check if the parameters, including their default values, the
+ * serialization order and the grouping are the same as in other.
+ */
+bool ConfigParams::isDefinitionEqual(const ConfigParams &other) const
+{
+    if (mParamList != other.mParamList ||
+            mSerializeOrder != other.mSerializeOrder ||
+            mParamGrouping != other.mParamGrouping) {
+        return false;
+    }
+
+    for (const auto &name: mParamList) {
+        if (!paramDefEqual(getParamCopy(name), other.getParamCopy(name))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+QByteArray ConfigParams::getParamsBinary(const QString &key)
+{
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_0);
+
+    out << paramsCacheMagic << paramsCacheFormat << key;
+
+    out << qint32(mParamList.size());
+    for (const auto &name: mParamList) {
+        out << name;
+        writeParamDef(out, getParamCopy(name));
+    }
+
+    out << mSerializeOrder;
+
+    out << qint32(mParamGrouping.size());
+    for (const auto &g: mParamGrouping) {
+        out << g.first << qint32(g.second.size());
+        for (const auto &sg: g.second) {
+            out << sg.first << sg.second;
+        }
+    }
+
+    return data;
+}
+
+bool ConfigParams::setParamsBinary(const QByteArray &data, const QString &key,
+                                   QSharedPointer<DescriptionSource> source)
+{
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic = 0, format = 0;
+    QString keyCache;
+    in >> magic >> format >> keyCache;
+
+    if (in.status() != QDataStream::Ok || magic != paramsCacheMagic ||
+            format != paramsCacheFormat || keyCache != key) {
+        return false;
+    }
+
+    qint32 paramNum = 0;
+    in >> paramNum;
+    if (in.status() != QDataStream::Ok || paramNum < 0) {
+        return false;
+    }
+
+    QVector<QPair<QString, ConfigParam> > params;
+    QVector<qint64> descPos;
+    params.reserve(paramNum);
+    descPos.reserve(paramNum);
+    for (int i = 0;i < paramNum && in.status() == QDataStream::Ok;i++) {
+        QPair<QString, ConfigParam> p;
+        qint64 pos = -1;
+        in >> p.first;
+        readParamDef(in, p.second, source ? &pos : nullptr);
+        params.append(p);
+        descPos.append(pos);
+    }
+
+    QStringList serOrder;
+    in >> serOrder;
+
+    QList<QPair<QString, QList<QPair<QString, QStringList>>>> grouping;
+    qint32 groupNum = 0;
+    in >> groupNum;
+    for (int i = 0;i < groupNum && in.status() == QDataStream::Ok;i++) {
+        QPair<QString, QList<QPair<QString, QStringList>>> g;
+        qint32 subgroupNum = 0;
+        in >> g.first >> subgroupNum;
+        for (int j = 0;j < subgroupNum && in.status() == QDataStream::Ok;j++) {
+            QPair<QString, QStringList> sg;
+            in >> sg.first >> sg.second;
+            g.second.append(sg);
+        }
+        grouping.append(g);
+    }
+
+    if (in.status() != QDataStream::Ok || !in.atEnd()) {
+        return false;
+    }
+
+    clearParams();
+    mParams.reserve(params.size());
+    mValues.reserve(params.size());
+    for (const auto &p: params) {
+        addParam(p.first, p.second);
+    }
+
+    if (source) {
+        mDescriptionPos = descPos;
+        mDescriptionSource = source;
+    }
+
+    setSerializeOrder(serOrder);
+    mParamGrouping = grouping;
+    mXmlStatus = tr("OK");
+
+    return true;
+}
+
+QString ConfigParams::paramsCachePath(const QString &fileName)
+{
+    QString hash = QCryptographicHash::hash(QFileInfo(fileName).absoluteFilePath().toUtf8(),
+                                            QCryptographicHash::Sha1).toHex();
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) +
+            "/param_defs/" + hash + ".bin";
+}
+
+QString ConfigParams::paramsCacheKey(const QString &fileName)
+{
+    QFileInfo fi(fileName);
+    QString key = QString("%1;%2;%3;%4").arg(fi.absoluteFilePath()).arg(fi.size()).
+            arg(fi.lastModified().toMSecsSinceEpoch()).arg(paramsCacheFormat);
+
+#ifdef VT_VERSION
+    // Parser changes between releases that forgot to increase the format
+    key += ";" + QString::number(VT_VERSION, 'f', 2);
+#endif
+
+    // Without a modification time the content has to be compared. That is
+    // still much faster than parsing it.
+    if (!fi.lastModified().isValid()) {
+        QFile file(fileName);
+        if (file.open(QIODevice::ReadOnly)) {
+            key += ";" + QCryptographicHash::hash(file.readAll(), QCryptographicHash::Md5).toHex();
+        }
+    }
+
+    return key;
+}
+
 bool ConfigParams::saveCDefines(const QString &fileName, bool wrapIfdef)
 {
     QFile file(fileName);
@@ -1403,8 +2034,10 @@ bool ConfigParams::saveCDefines(const QString &fileName, bool wrapIfdef)
     for (int i = 0;i < mSerializeOrder.size();i++) {
         QString name = mSerializeOrder.at(i);
 
-        if (mParams.contains(name)) {
-            ConfigParam &p = mParams[name];
+        int slot = slotOf(name);
+        if (slot >= 0) {
+            const ConfigParam &p = mParams.at(slot);
+            const ParamValue &v = mValues.at(slot);
 
             if (!p.cDefine.isEmpty()) {
                 out << "// " + p.longName + "\n";
@@ -1416,15 +2049,15 @@ bool ConfigParams::saveCDefines(const QString &fileName, bool wrapIfdef)
                 case CFG_T_BOOL:
                 case CFG_T_ENUM:
                 case CFG_T_INT:
-                    out << "#define " + p.cDefine + " " + QString::number(p.valInt) + "\n";
+                    out << "#define " + p.cDefine + " " + QString::number(v.valInt) + "\n";
                     break;
 
                 case CFG_T_DOUBLE:
-                    out << "#define " + p.cDefine + " " + QString::number(p.valDouble) + "\n";
+                    out << "#define " + p.cDefine + " " + QString::number(v.valDouble) + "\n";
                     break;
 
                 case CFG_T_QSTRING:
-                    out << "#define " + p.cDefine + " " + p.valString + "\n";
+                    out << "#define " + p.cDefine + " " + v.valString + "\n";
                     break;
 
                 default:
@@ -1467,28 +2100,32 @@ QStringList ConfigParams::checkDifference(ConfigParams *config)
     QStringList res;
 
     for(QString p: mParamList) {
-        ConfigParam *thisParam = this->getParam(p);
-        ConfigParam *otherParam = config->getParam(p);
+        int thisSlot = slotOf(p);
+        int otherSlot = config->slotOf(p);
+
+        if (thisSlot >= 0 && otherSlot >= 0) {
+            const ConfigParam &thisParam = mParams.at(thisSlot);
+            const ParamValue &thisVal = mValues.at(thisSlot);
+            const ParamValue &otherVal = config->mValues.at(otherSlot);
 
-        if (thisParam && otherParam) {
-            if (thisParam->type == otherParam->type) {
-                switch (thisParam->type) {
+            if (thisParam.type == config->mParams.at(otherSlot).type) {
+                switch (thisParam.type) {
                 case CFG_T_BOOL:
                 case CFG_T_ENUM:
                 case CFG_T_INT:
-                    if (thisParam->valInt != otherParam->valInt) {
+                    if (thisVal.valInt != otherVal.valInt) {
                         res.append(p);
                     }
                     break;
 
                 case CFG_T_DOUBLE:
-                    if (!almostEqual(thisParam->valDouble, otherParam->valDouble, 0.0001)) {
+                    if (!almostEqual(thisVal.valDouble, otherVal.valDouble, 0.0001)) {
                         res.append(p);
                     }
                     break;
 
                 case CFG_T_QSTRING:
-                    if (thisParam->valString != otherParam->valString) {
+                    if (thisVal.valString != otherVal.valString) {
                         res.append(p);
                     }
                     break;
@@ -1505,22 +2142,89 @@ QStringList ConfigParams::checkDifference(ConfigParams *config)
 
 quint32 ConfigParams::getSignature()
 {
+    if (!mSerialPlanValid) {
+        compileSerialPlan();
+    }
+
+    return mSignature;
+}
+
+/**
+ * @brief ConfigParams::compileSerialPlan
+ * Resolve the serialization order to one operation per transmitted
+ * parameter and calculate the signature, so that serialize and deSerialize
+ * run without looking up any names. Has to be done again when parameters
+ * or the serialization order change.
+ */
+void ConfigParams::compileSerialPlan()
+{
+    mSerialPlan.clear();
+    mSerialPlan.reserve(mSerializeOrder.size());
+
     QString sigStr;
-    for (QString s: mSerializeOrder) {
-        sigStr.append(s);
-        ConfigParam *p = getParam(s);
-
-        if (p) {
-            sigStr.append(QString("%1").arg(int(p->type)));
-            sigStr.append(QString("%1").arg(int(p->vTx)));
-            for (auto n: p->enumNames) {
-                sigStr.append(n);
+
+    for (int i = 0;i < mSerializeOrder.size();i++) {
+        const QString &name = mSerializeOrder.at(i);
+        sigStr.append(name);
+
+        int slot = slotOf(name);
+        if (slot < 0) {
+            qWarning() << name << "not found";
+            continue;
+        }
+
+        const ConfigParam &p = mParams.at(slot);
+        sigStr.append(QString("%1").arg(int(p.type)));
+        sigStr.append(QString("%1").arg(int(p.vTx)));
+        for (auto n: p.enumNames) {
+            sigStr.append(n);
+        }
+
+        SerialOp op;
+        op.type = p.type;
+        op.tx = p.vTx;
+        op.scale = p.vTxDoubleScale;
+        op.slot = slot;
+        op.order = i;
+
+        switch (p.type) {
+        case CFG_T_DOUBLE:
+            if (op.tx != VESC_TX_DOUBLE16 && op.tx != VESC_TX_DOUBLE32 &&
+                    op.tx != VESC_TX_DOUBLE32_AUTO) {
+                qWarning() << name << ": wrong tx type set.";
+                op.tx = VESC_TX_UNDEFINED;
             }
+            break;
+
+        case CFG_T_INT:
+            if (op.tx != VESC_TX_UINT8 && op.tx != VESC_TX_INT8 &&
+                    op.tx != VESC_TX_UINT16 && op.tx != VESC_TX_INT16 &&
+                    op.tx != VESC_TX_UINT32 && op.tx != VESC_TX_INT32) {
+                qWarning() << name << ": wrong tx type set.";
+                op.tx = VESC_TX_UNDEFINED;
+            }
+            break;
+
+        case CFG_T_ENUM:
+        case CFG_T_BOOL:
+            op.tx = VESC_TX_INT8;
+            break;
+
+        case CFG_T_QSTRING:
+            qWarning() << name << ": QString not supported.";
+            continue;
+
+        case CFG_T_UNDEFINED:
+            qWarning() << name << ": type not defined.";
+            continue;
         }
+
+        mSerialPlan.append(op);
     }
 
     QByteArray bytes = sigStr.toUtf8();
-    return Utility::crc32c((uint8_t*)bytes.data(), bytes.size());
+    mSignature = Utility::crc32c((uint8_t*)bytes.data(), bytes.size());
+    mSerialPlanValid = true;
 }
 
 void ConfigParams::setGrouping(QList<QPair<QString, QList<QPair<QString, QStringList>>>> grouping)
@@ -1853,11 +2557,19 @@ bool ConfigParams::renameSubgroupParam(QString group, QString subgroup, QString
 ConfigParams &ConfigParams::operator=(const ConfigParams &other)
 {
     this->mParams = other.mParams;
+    this->mValues = other.mValues;
+    this->mParamIndex = other.mParamIndex;
+    this->mSlotNames = other.mSlotNames;
+    this->mSlotOfId = other.mSlotOfId;
+    this->mDescriptionPos = other.mDescriptionPos;
+    this->mDescriptionSource = other.mDescriptionSource;
+    this->mParamViews.clear();
     this->mParamList = other.mParamList;
     this->mUpdateOnlyName = other.mUpdateOnlyName;
     this->mUpdatesEnabled = other.mUpdatesEnabled;
     this->mSerializeOrder = other.mSerializeOrder;
     this->mXmlStatus = other.mXmlStatus;
+    this->mSerialPlanValid = false;
 
     return *this;
 }
@@ -22,17 +22,24 @@
 
 #include <QObject>
 #include <QHash>
+#include <QMap>
+#include <QSet>
+#include <QVector>
+#include <QSharedPointer>
 #include <QXmlStreamWriter>
 #include <QXmlStreamReader>
 #include "configparam.h"
 #include "vbytearray.h"
 
+class QWidget;
+
 class ConfigParams : public QObject
 {
     Q_OBJECT
 public:
     explicit ConfigParams(QObject *parent = nullptr);
     void addParam(const QString &name, ConfigParam param);
+    void setParam(const QString &name, const ConfigParam &param);
     void deleteParam(const QString &name);
     Q_INVOKABLE void setUpdateOnly(const QString &name);
     Q_INVOKABLE QString getUpdateOnly();
@@ -42,7 +49,10 @@ public:
     void clearAll();
 
     Q_INVOKABLE bool hasParam(const QString &name);
-    ConfigParam *getParam(const QString &name);
+    Q_INVOKABLE bool hasParam(int id);
+    Q_INVOKABLE static int getParamId(const QString &name);
+    Q_INVOKABLE static QString getParamName(int id);
+    const ConfigParam *getParam(const QString &name);
     ConfigParam getParamCopy(const QString &name) const;
 
     Q_INVOKABLE bool isParamDouble(const QString &name);
@@ -56,6 +66,10 @@ public:
     Q_INVOKABLE int getParamEnum(const QString &name);
     Q_INVOKABLE QString getParamQString(const QString &name);
     Q_INVOKABLE bool getParamBool(const QString &name);
+    Q_INVOKABLE double getParamDouble(int id);
+    Q_INVOKABLE int getParamInt(int id);
+    Q_INVOKABLE int getParamEnum(int id);
+    Q_INVOKABLE bool getParamBool(int id);
     Q_INVOKABLE QString getLongName(const QString &name);
     Q_INVOKABLE QString getDescription(const QString &name);
 
@@ -100,6 +114,10 @@ public:
     bool setParamsXML(QXmlStreamReader &stream);
     bool saveParamsXml(QString fileName);
     bool loadParamsXml(QString fileName);
+    bool loadParamsCached(QString fileName);
+    static bool verifyParamsCache(QString fileName);
+    static void clearParamsCache();
+    bool isDefinitionEqual(const ConfigParams &other) const;
 
     bool saveCDefines(const QString &fileName, bool wrapIfdef = false);
 
@@ -132,6 +150,10 @@ public:
     bool renameSubgroup(QString group, QString subgroup, QString newName);
     bool renameSubgroupParam(QString group, QString subgroup, QString param, QString newName);
 
+    // Batched change notifications
+    Q_INVOKABLE void beginUpdateBatch();
+    Q_INVOKABLE void endUpdateBatch(QObject *src = nullptr);
+
     // Operators
     ConfigParams& operator=(const ConfigParams &other);
 
@@ -141,6 +163,7 @@ signals:
     void paramChangedEnum(QObject *src, QString name, int newParam);
     void paramChangedQString(QObject *src, QString name, QString newParam);
     void paramChangedBool(QObject *src, QString name, bool newParam);
+    void paramsChanged(QObject *src, QStringList names);
     void updateRequested();
     void updateRequestDefault();
     void updated();
@@ -152,20 +175,72 @@ public slots:
     void updateParamEnum(QString name, int param, QObject *src = nullptr);
     void updateParamString(QString name, QString param, QObject *src = nullptr);
     void updateParamBool(QString name, bool param, QObject *src = nullptr);
+    void updateParamDouble(int id, double param, QObject *src = nullptr);
+    void updateParamInt(int id, int param, QObject *src = nullptr);
+    void updateParamEnum(int id, int param, QObject *src = nullptr);
+    void updateParamBool(int id, bool param, QObject *src = nullptr);
     void requestUpdate();
     void requestUpdateDefault();
     void updateDone();
 
 private:
-    QHash<QString, ConfigParam> mParams;
+    // One operation of the compiled serialization plan. Enums and bools
+    // are resolved to VESC_TX_INT8 and unusable transmit types to
+    // VESC_TX_UNDEFINED.
+    struct SerialOp {
+        VESC_TX_T tx;
+        CFG_T type;
+        double scale;
+        int slot;
+        int order;
+    };
+
+    // The values are kept apart from the definitions, so that copies of a
+    // configuration share the definitions and only detach the values.
+    struct ParamValue {
+        double valDouble;
+        int valInt;
+        QString valString;
+    };
+
+    QVector<ConfigParam> mParams;
+    QVector<ParamValue> mValues;
+    QStringList mSlotNames;
+    QHash<QString, int> mParamIndex;
+    QVector<int> mSlotOfId; // Slot + 1 for every interned id, 0 if absent
+    // Descriptions that are still in the binary cache, see loadParamsCached
+    struct DescriptionSource;
+    QSharedPointer<DescriptionSource> mDescriptionSource;
+    QVector<qint64> mDescriptionPos; // -1 when in mParams
+    int mBatchDepth;
+    QSet<int> mBatchSlots;
+    QMap<int, ConfigParam> mParamViews;
     QStringList mParamList;
     QString mUpdateOnlyName;
     bool mUpdatesEnabled;
     QStringList mSerializeOrder;
     QString mXmlStatus;
     QList<QPair<QString, QList<QPair<QString, QStringList>>>> mParamGrouping;
+    QVector<SerialOp> mSerialPlan;
+    quint32 mSignature;
+    bool mSerialPlanValid;
 
     bool almostEqual(float A, float B, float eps);
+    void compileSerialPlan();
+    QByteArray getParamsBinary(const QString &key);
+    bool setParamsBinary(const QByteArray &data, const QString &key,
+                         QSharedPointer<DescriptionSource> source = QSharedPointer<DescriptionSource>());
+    static QString paramsCachePath(const QString &fileName);
+    static QString paramsCacheKey(const QString &fileName);
+    int slotOf(const QString &name) const;
+    int slotOf(int id) const;
+    void rebuildIndex();
+    void emitParamChanged(int slot, QObject *src);
+    QString descriptionOf(int slot) const;
+    double valueDouble(int slot) const;
+    int valueInt(int slot, CFG_T type) const;
+    void setValueDouble(int slot, const QString &name, double param, QObject *src);
+    void setValueInt(int slot, const QString &name, CFG_T type, int param, QObject *src);
 
 };
 
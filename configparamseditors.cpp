@@ -0,0 +1,93 @@
+/*
+    Copyright 2016 - 2020 Benjamin Vedder	benjamin@vedder.se
+
+    This file is part of VESC Tool.
+
+    VESC Tool is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    VESC Tool is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+    */
+
+#include "configparams.h"
+#include "widgets/parameditdouble.h"
+#include "widgets/parameditint.h"
+#include "widgets/parameditstring.h"
+#include "widgets/parameditenum.h"
+#include "widgets/parameditbool.h"
+#include <QDebug>
+
+/*
+ * Editor widgets for ConfigParams. Only built into the application, so
+ * that the core library does not depend on QtWidgets.
+ */
+
+QWidget *ConfigParams::getEditor(const QString &name, QWidget *parent)
+{
+    QWidget *retVal = 0;
+
+    if (mParams.contains(name)) {
+        ConfigParam &p = mParams[name];
+
+        switch (p.type) {
+        case CFG_T_DOUBLE: {
+            ParamEditDouble *edit = new ParamEditDouble(parent);
+            edit->setName(name);
+            edit->setSuffix(p.suffix);
+            edit->setDecimals(p.editorDecimalsDouble);
+            edit->setShowAsPercentage(p.editAsPercentage);
+            edit->showDisplay(p.showDisplay);
+            edit->setConfig(this);
+            retVal = edit;
+        } break;
+
+        case CFG_T_INT: {
+            ParamEditInt *edit = new ParamEditInt(parent);
+            edit->setName(name);
+            edit->setSuffix(p.suffix);
+            edit->setShowAsPercentage(p.editAsPercentage);
+            edit->showDisplay(p.showDisplay);
+            edit->setConfig(this);
+            retVal = edit;
+        } break;
+
+        case CFG_T_QSTRING: {
+            ParamEditString *edit = new ParamEditString(parent);
+            edit->setName(name);
+            edit->setConfig(this);
+            retVal = edit;
+        } break;
+
+        case CFG_T_ENUM: {
+            ParamEditEnum *edit = new ParamEditEnum(parent);
+            edit->setName(name);
+            edit->setConfig(this);
+            retVal = edit;
+        } break;
+
+        case CFG_T_BOOL: {
+            ParamEditBool *edit = new ParamEditBool(parent);
+            edit->setName(name);
+            edit->setConfig(this);
+            retVal = edit;
+        } break;
+
+        default:
+            qWarning() << "no editor for" << name << "could be created";
+            break;
+        }
+
+    } else {
+        qWarning() << name << "not found";
+    }
+
+    return retVal;
+}
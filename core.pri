@@ -0,0 +1,89 @@
+# Core of VESC Tool: communication, configuration and log handling, without
+# any dependency on QtWidgets.
+#
+# The application compiles these files directly. core/lib builds them into
+# the static library vesc_core, and the other projects in core/ link that
+# library by adding CONFIG += vt_core_link before including this file.
+# Include features.pri first.
+
+QT       += core gui
+QT       += network
+QT       += concurrent
+
+contains(DEFINES, HAS_SERIALPORT) {
+    QT       += serialport
+}
+
+contains(DEFINES, HAS_CANBUS) {
+    QT       += serialbus
+}
+
+contains(DEFINES, HAS_BLUETOOTH) {
+    QT       += bluetooth
+}
+
+contains(DEFINES, HAS_POS) {
+    QT       += positioning
+}
+
+INCLUDEPATH += $$PWD
+
+vt_core_link {
+    LIBS += -L$$OUT_PWD/../lib -lvesc_core
+
+    win32-msvc* {
+        PRE_TARGETDEPS += $$OUT_PWD/../lib/vesc_core.lib
+    } else {
+        PRE_TARGETDEPS += $$OUT_PWD/../lib/libvesc_core.a
+    }
+} else {
+    SOURCES += \
+        $$PWD/packet.cpp \
+        $$PWD/vbytearray.cpp \
+        $$PWD/commands.cpp \
+        $$PWD/configparams.cpp \
+        $$PWD/configparam.cpp \
+        $$PWD/openroadinterface.cpp \
+        $$PWD/digitalfiltering.cpp \
+        $$PWD/utility.cpp \
+        $$PWD/tcpserversimple.cpp \
+        $$PWD/logindex.cpp \
+        $$PWD/logplotpyramid.cpp \
+        $$PWD/lzologdevice.cpp \
+        $$PWD/logdirindex.cpp \
+        $$PWD/logbatchanalysis.cpp \
+        $$PWD/clitool.cpp \
+        $$PWD/linkmetrics.cpp \
+        $$PWD/eventtrace.cpp \
+        $$PWD/confbackupstore.cpp
+
+    HEADERS += \
+        $$PWD/packet.h \
+        $$PWD/vbytearray.h \
+        $$PWD/commands.h \
+        $$PWD/datatypes.h \
+        $$PWD/configparams.h \
+        $$PWD/configparam.h \
+        $$PWD/openroadinterface.h \
+        $$PWD/digitalfiltering.h \
+        $$PWD/utility.h \
+        $$PWD/tcpserversimple.h \
+        $$PWD/logindex.h \
+        $$PWD/logplotpyramid.h \
+        $$PWD/lzologdevice.h \
+        $$PWD/logdirindex.h \
+        $$PWD/logbatchanalysis.h \
+        $$PWD/clitool.h \
+        $$PWD/linkmetrics.h \
+        $$PWD/eventtrace.h \
+        $$PWD/confbackupstore.h
+
+    contains(DEFINES, HAS_BLUETOOTH) {
+        SOURCES += $$PWD/bleuart.cpp
+        HEADERS += $$PWD/bleuart.h
+    }
+
+    include($$PWD/lzokay/lzokay.pri)
+
+    RESOURCES += $$PWD/res_config.qrc
+}
@@ -0,0 +1,494 @@
+/*
+    Copyright 2020 Benjamin Vedder	benjamin@vedder.se
+
+    This file is part of VESC Tool.
+
+    VESC Tool is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    VESC Tool is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+    */
+
+#include <QtTest>
+#include <QTemporaryDir>
+#include <cmath>
+#include "packet.h"
+#include "vbytearray.h"
+#include "configparams.h"
+#include "openroadinterface.h"
+#include "digitalfiltering.h"
+#include "lzologdevice.h"
+#include "utility.h"
+#include "osmclient.h"
+
+namespace {
+const int logSamples = 20000;
+const int packetsPerRun = 1000;
+const int rxChunkSize = 64;
+
+QByteArray logLine(int i)
+{
+    // Same columns as the logs written by openRtLogFile
+    QStringList t;
+    double s = double(i);
+    t << QString::number(i * 50) << QString::number(48.0 - s * 1e-4, 'f', 2);
+
+    for (int j = 0;j < 4;j++) {
+        t << QString::number(35.0 + (i % 100) * 0.1, 'f', 2);
+    }
+
+    t << QString::number(60.0, 'f', 2);
+    t << QString::number(20.0 + (i % 37), 'f', 2) << QString::number(10.0 + (i % 23), 'f', 2);
+    t << QString::number(1.5, 'f', 2) << QString::number(19.5, 'f', 2);
+    t << QString::number(10000 + (i % 500)) << QString::number(0.45, 'f', 3);
+    t << QString::number(s * 1e-4, 'f', 4) << "0.0000";
+    t << QString::number(s * 4e-3, 'f', 4) << "0.0000";
+    t << QString::number(i * 3) << QString::number(i * 3);
+    t << QString::number(i % 360) << "0" << "0";
+    t << QString::number(1.2, 'f', 2) << QString::number(12.8, 'f', 2);
+
+    t << QString::number(i * 50) << QString::number(s * 1e-4, 'f', 4) << "0.0000";
+    t << QString::number(s * 4e-3, 'f', 4) << "0.0000";
+    t << QString::number(0.9 - s * 1e-6, 'f', 4) << "1000.0";
+    t << QString::number(10.0 + (i % 23), 'f', 2) << QString::number(20.0 + (i % 37), 'f', 2);
+    t << QString::number(8.0, 'f', 2) << QString::number(s * 0.4, 'f', 2);
+    t << QString::number(s * 0.4, 'f', 2) << "1";
+
+    t << QString::number(i * 50);
+    for (int j = 0;j < 9;j++) {
+        t << QString::number(0.01 * j, 'f', 4);
+    }
+
+    t << QString::number(i * 50) << QString::number(57.7 + s * 1e-7, 'f', 7);
+    t << QString::number(11.9 + s * 1e-7, 'f', 7) << "50.0" << "8.0" << "0.0" << "2.0" << "3.0";
+
+    return t.join(";").toLocal8Bit() + "\n";
+}
+}
+
+class Benchmarks : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void packetSend();
+    void packetProcess();
+
+    void vbyteArrayEncode();
+    void vbyteArrayDecode();
+
+    void configSerialize();
+    void configDeSerialize();
+    void configLoadParamsXml();
+    void configLoadParamsCached();
+    void configSaveCompressed();
+    void configLoadCompressed();
+
+    void loadRtLogFile_data();
+    void loadRtLogFile();
+
+    void fft_data();
+    void fft();
+    void filterSignal_data();
+    void filterSignal();
+    void fftWithShift_data();
+    void fftWithShift();
+
+    void osmGetTile_data();
+    void osmGetTile();
+
+private:
+    QTemporaryDir mDir;
+    OpenroadInterface *mOpenroad = nullptr;
+    QByteArray mPacketStream;
+    QVector<QByteArray> mPayloads;
+    QString mParamsXml;
+
+};
+
+void Benchmarks::initTestCase()
+{
+    QVERIFY(mDir.isValid());
+
+    // Separate settings, so that backups of VESC Tool are not touched
+    QCoreApplication::setOrganizationName("VESC");
+    QCoreApplication::setApplicationName("VESC Tool Benchmarks");
+
+    mOpenroad = new OpenroadInterface;
+    QVERIFY(Utility::configLoadLatest(mOpenroad));
+
+    mParamsXml = mDir.filePath("parameters_mcconf.xml");
+    QVERIFY(mOpenroad->mcConfig()->saveParamsXml(mParamsXml));
+
+    // Payloads of the sizes seen in practice, from short commands to
+    // full configurations.
+    for (int i = 0;i < packetsPerRun;i++) {
+        int len = (i % 10) == 0 ? 500 : 10 + (i * 7) % 80;
+        QByteArray p(len, 0);
+        for (int j = 0;j < len;j++) {
+            p[j] = char((i + j * 13) & 0xFF);
+        }
+        mPayloads.append(p);
+    }
+
+    Packet packet;
+    connect(&packet, &Packet::dataToSend, [this](QByteArray &data) {
+        mPacketStream.append(data);
+    });
+
+    for (const auto &p: mPayloads) {
+        packet.sendPacket(p);
+    }
+
+    QFile csv(mDir.filePath("log.csv"));
+    QVERIFY(csv.open(QIODevice::WriteOnly));
+    QFile lzo(mDir.filePath("log." + LzoLogDevice::fileSuffix()));
+    QVERIFY(lzo.open(QIODevice::WriteOnly));
+    LzoLogDevice lzoDev(&lzo);
+    QVERIFY(lzoDev.open(QIODevice::WriteOnly));
+
+    QByteArray header = "ms_today;input_voltage;temp_mos_max;temp_mos_1;temp_mos_2;"
+                        "temp_mos_3;temp_motor;current_motor;current_in;d_axis_current;"
+                        "q_axis_current;erpm;duty_cycle;amp_hours_used;amp_hours_charged;"
+                        "watt_hours_used;watt_hours_charged;tachometer;tachometer_abs;"
+                        "encoder_position;fault_code;vesc_id\n";
+    csv.write(header);
+    lzoDev.write(header);
+
+    for (int i = 0;i < logSamples;i++) {
+        QByteArray line = logLine(i);
+        csv.write(line);
+        lzoDev.write(line);
+    }
+
+    lzoDev.close();
+    lzo.close();
+    csv.close();
+
+    // Tiles on disk, laid out like the tile cache of the map
+    for (int x = 0;x < 4;x++) {
+        for (int y = 0;y < 4;y++) {
+            QString path = mDir.filePath(QString("tiles/10/%1").arg(x));
+            QDir().mkpath(path);
+            QImage img(256, 256, QImage::Format_RGB32);
+            img.fill(QColor(20 * x, 20 * y, 128));
+            QVERIFY(img.save(QString("%1/%2.png").arg(path).arg(y)));
+        }
+    }
+}
+
+void Benchmarks::cleanupTestCase()
+{
+    delete mOpenroad;
+    mOpenroad = nullptr;
+}
+
+void Benchmarks::packetSend()
+{
+    Packet packet;
+    int bytes = 0;
+    connect(&packet, &Packet::dataToSend, [&bytes](QByteArray &data) {
+        bytes += data.size();
+    });
+
+    QBENCHMARK {
+        for (const auto &p: mPayloads) {
+            packet.sendPacket(p);
+        }
+    }
+
+    QVERIFY(bytes > 0);
+}
+
+void Benchmarks::packetProcess()
+{
+    Packet packet;
+    int received = 0;
+    connect(&packet, &Packet::packetReceived, [&received](QByteArray &data) {
+        (void)data;
+        received++;
+    });
+
+    // Fed in small chunks, like the data arrives from a serial port
+    QBENCHMARK {
+        packet.resetState();
+        for (int i = 0;i < mPacketStream.size();i += rxChunkSize) {
+            packet.processData(mPacketStream.mid(i, rxChunkSize));
+        }
+    }
+
+    QVERIFY(received >= packetsPerRun);
+}
+
+void Benchmarks::vbyteArrayEncode()
+{
+    QBENCHMARK {
+        VByteArray vb;
+        for (int i = 0;i < 1000;i++) {
+            vb.vbAppendInt32(i * 1000);
+            vb.vbAppendUint16(quint16(i));
+            vb.vbAppendUint8(quint8(i));
+            vb.vbAppendDouble32(double(i) * 0.1, 1e3);
+            vb.vbAppendDouble16(double(i % 100) * 0.1, 1e2);
+            vb.vbAppendDouble32Auto(double(i) * 1.2345);
+        }
+        vb.vbAppendString("Benchmark");
+    }
+}
+
+void Benchmarks::vbyteArrayDecode()
+{
+    VByteArray data;
+    for (int i = 0;i < 1000;i++) {
+        data.vbAppendInt32(i * 1000);
+        data.vbAppendUint16(quint16(i));
+        data.vbAppendUint8(quint8(i));
+        data.vbAppendDouble32(double(i) * 0.1, 1e3);
+        data.vbAppendDouble16(double(i % 100) * 0.1, 1e2);
+        data.vbAppendDouble32Auto(double(i) * 1.2345);
+    }
+    data.vbAppendString("Benchmark");
+
+    double sum = 0.0;
+    QBENCHMARK {
+        VByteArray vb = data;
+        for (int i = 0;i < 1000;i++) {
+            sum += vb.vbPopFrontInt32();
+            sum += vb.vbPopFrontUint16();
+            sum += vb.vbPopFrontUint8();
+            sum += vb.vbPopFrontDouble32(1e3);
+            sum += vb.vbPopFrontDouble16(1e2);
+            sum += vb.vbPopFrontDouble32Auto();
+        }
+        QCOMPARE(vb.vbPopFrontString(), QString("Benchmark"));
+    }
+
+    QVERIFY(sum > 0.0);
+}
+
+void Benchmarks::configSerialize()
+{
+    ConfigParams *conf = mOpenroad->mcConfig();
+
+    QBENCHMARK {
+        VByteArray vb;
+        conf->serialize(vb);
+    }
+}
+
+void Benchmarks::configDeSerialize()
+{
+    ConfigParams *conf = mOpenroad->mcConfig();
+    VByteArray data;
+    conf->serialize(data);
+
+    QBENCHMARK {
+        VByteArray vb = data;
+        QVERIFY(conf->deSerialize(vb));
+    }
+}
+
+void Benchmarks::configLoadParamsXml()
+{
+    ConfigParams conf;
+
+    QBENCHMARK {
+        QVERIFY(conf.loadParamsXml(mParamsXml));
+    }
+}
+
+void Benchmarks::configLoadParamsCached()
+{
+    ConfigParams conf;
+
+    // The first load creates the cache
+    QVERIFY(conf.loadParamsCached(mParamsXml));
+    QVERIFY(ConfigParams::verifyParamsCache(mParamsXml));
+
+    QBENCHMARK {
+        QVERIFY(conf.loadParamsCached(mParamsXml));
+    }
+}
+
+void Benchmarks::configSaveCompressed()
+{
+    ConfigParams *conf = mOpenroad->mcConfig();
+    QString res;
+
+    QBENCHMARK {
+        res = conf->saveCompressed("mcconf");
+    }
+
+    QVERIFY(!res.isEmpty());
+}
+
+void Benchmarks::configLoadCompressed()
+{
+    ConfigParams *conf = mOpenroad->mcConfig();
+    QString data = conf->saveCompressed("mcconf");
+
+    QBENCHMARK {
+        QVERIFY(conf->loadCompressed(data, "mcconf"));
+    }
+}
+
+void Benchmarks::loadRtLogFile_data()
+{
+    QTest::addColumn<QString>("file");
+    QTest::newRow("csv") << mDir.filePath("log.csv");
+    QTest::newRow("lzo") << mDir.filePath("log." + LzoLogDevice::fileSuffix());
+}
+
+void Benchmarks::loadRtLogFile()
+{
+    QFETCH(QString, file);
+
+    QBENCHMARK {
+        QVERIFY(mOpenroad->loadRtLogFile(file));
+    }
+
+    QCOMPARE(mOpenroad->getRtLogSize(), logSamples);
+}
+
+void Benchmarks::fft_data()
+{
+    QTest::addColumn<int>("bits");
+    QTest::newRow("256") << 8;
+    QTest::newRow("4096") << 12;
+    QTest::newRow("65536") << 16;
+}
+
+void Benchmarks::fft()
+{
+    QFETCH(int, bits);
+    int len = 1 << bits;
+    QVector<double> real(len);
+    QVector<double> imag(len);
+
+    QBENCHMARK {
+        for (int i = 0;i < len;i++) {
+            real[i] = sin(double(i) * 0.1) + 0.5 * sin(double(i) * 0.37);
+            imag[i] = 0.0;
+        }
+        DigitalFiltering::fft(0, bits, real.data(), imag.data());
+    }
+}
+
+void Benchmarks::filterSignal_data()
+{
+    QTest::addColumn<int>("len");
+    QTest::addColumn<int>("bits");
+    QTest::newRow("1000_fir64") << 1000 << 6;
+    QTest::newRow("20000_fir256") << 20000 << 8;
+}
+
+void Benchmarks::filterSignal()
+{
+    QFETCH(int, len);
+    QFETCH(int, bits);
+
+    QVector<double> signal(len);
+    for (int i = 0;i < len;i++) {
+        signal[i] = sin(double(i) * 0.05) + 0.2 * sin(double(i) * 2.1);
+    }
+
+    QVector<double> filter = DigitalFiltering::generateFirFilter(0.05, bits, true);
+    QVector<double> res;
+
+    QBENCHMARK {
+        res = DigitalFiltering::filterSignal(signal, filter, true);
+    }
+
+    QCOMPARE(res.size(), len);
+}
+
+void Benchmarks::fftWithShift_data()
+{
+    QTest::addColumn<int>("len");
+    QTest::addColumn<int>("bits");
+    QTest::newRow("1000_1024") << 1000 << 10;
+    QTest::newRow("20000_32768") << 20000 << 15;
+}
+
+void Benchmarks::fftWithShift()
+{
+    QFETCH(int, len);
+    QFETCH(int, bits);
+
+    QVector<double> signal(len);
+    for (int i = 0;i < len;i++) {
+        signal[i] = sin(double(i) * 0.05) + 0.2 * sin(double(i) * 2.1);
+    }
+
+    QVector<double> res;
+
+    QBENCHMARK {
+        QVector<double> s = signal;
+        res = DigitalFiltering::fftWithShift(s, bits, true);
+    }
+
+    QVERIFY(!res.isEmpty());
+}
+
+void Benchmarks::osmGetTile_data()
+{
+    QTest::addColumn<bool>("fromDisk");
+    QTest::newRow("memory") << false;
+    QTest::newRow("disk") << true;
+}
+
+void Benchmarks::osmGetTile()
+{
+    QFETCH(bool, fromDisk);
+
+    OsmClient client;
+    QVERIFY(client.setCacheDir(mDir.filePath("tiles")));
+
+    int res = 0;
+    int hits = 0;
+
+    QBENCHMARK {
+        if (fromDisk) {
+            client.clearCacheMemory();
+        }
+
+        for (int x = 0;x < 4;x++) {
+            for (int y = 0;y < 4;y++) {
+                client.getTile(10, x, y, res);
+                hits += res > 0 ? 1 : 0;
+            }
+        }
+    }
+
+    QVERIFY(hits > 0);
+}
+
+int main(int argc, char *argv[])
+{
+    // The map client loads the tiles into QPixmaps, which need a platform
+    // plugin. Without a display, e.g. on build servers, none is available
+    // unless it is chosen here.
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QGuiApplication app(argc, argv);
+    app.setAttribute(Qt::AA_Use96Dpi, true);
+
+    Benchmarks tc;
+    QTEST_SET_MAIN_SOURCE_PATH
+    return QTest::qExec(&tc, argc, argv);
+}
+
+#include "benchmarks.moc"
@@ -0,0 +1,38 @@
+# Benchmarks of the hot paths in the core, using QtTest. The results can be
+# written in a machine-readable format with the QtTest output options, e.g.
+#
+# ./vesc_tool_benchmarks -o results.xml,xml -o -,txt
+#
+# make benchmark runs all benchmarks and writes results.csv and results.xml
+# in the build directory, so that runs can be compared.
+
+include(../../features.pri)
+
+CONFIG += c++11
+CONFIG += console
+CONFIG -= app_bundle
+CONFIG -= debug_and_release
+CONFIG += vt_core_link
+
+QT += testlib
+
+TEMPLATE = app
+TARGET = vesc_tool_benchmarks
+
+include(../../core.pri)
+
+# The tile client does not need any widgets, so it is compiled directly
+INCLUDEPATH += $$PWD/../../map
+
+SOURCES += \
+    benchmarks.cpp \
+    $$PWD/../../map/osmclient.cpp \
+    $$PWD/../../map/osmtile.cpp
+
+HEADERS += \
+    $$PWD/../../map/osmclient.h \
+    $$PWD/../../map/osmtile.h
+
+benchmark.commands = ./$$TARGET -o results.csv,csv -o results.xml,xml -o -,txt
+benchmark.depends = $$TARGET
+QMAKE_EXTRA_TARGETS += benchmark
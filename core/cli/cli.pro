@@ -0,0 +1,17 @@
+# VESC Tool command line mode as its own small binary, linked against the
+# core library only. See clitool.h
+
+include(../../features.pri)
+
+CONFIG += c++11
+CONFIG += console
+CONFIG -= app_bundle
+CONFIG -= debug_and_release
+CONFIG += vt_core_link
+
+TEMPLATE = app
+TARGET = vesc_tool_cli
+
+include(../../core.pri)
+
+SOURCES += main.cpp
@@ -0,0 +1,39 @@
+/*
+    Copyright 2020 Benjamin Vedder	benjamin@vedder.se
+
+    This file is part of VESC Tool.
+
+    VESC Tool is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    VESC Tool is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+    */
+
+#include "clitool.h"
+#include <QCoreApplication>
+
+int main(int argc, char *argv[])
+{
+    // Same settings as VESC Tool, so that configuration backups are shared
+    QCoreApplication::setOrganizationName("VESC");
+    QCoreApplication::setOrganizationDomain("openroad-project.com");
+    QCoreApplication::setApplicationName("VESC Tool");
+
+    // The configurations are in the static core library
+    Q_INIT_RESOURCE(res_config);
+
+    QCoreApplication a(argc, argv);
+    QStringList args = a.arguments();
+
+    // The arguments are the same as for vesc_tool --cli
+    args.insert(1, "--cli");
+    return CliTool::run(args);
+}
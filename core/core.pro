@@ -0,0 +1,16 @@
+# The core library and the tools that only need the core, without
+# QtWidgets. Build with e.g.
+#
+# qmake core/core.pro && make
+
+TEMPLATE = subdirs
+
+SUBDIRS = \
+    lib \
+    cli \
+    benchmarks \
+    tests
+
+cli.depends = lib
+benchmarks.depends = lib
+tests.depends = lib
@@ -0,0 +1,13 @@
+# Static library with the core of VESC Tool, see core.pri
+
+include(../../features.pri)
+
+CONFIG += c++11
+CONFIG += staticlib
+CONFIG -= debug_and_release
+
+TEMPLATE = lib
+TARGET = vesc_core
+DESTDIR = $$OUT_PWD
+
+include(../../core.pri)
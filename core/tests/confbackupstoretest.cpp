@@ -0,0 +1,212 @@
+/*
+    Copyright 2020 Benjamin Vedder	benjamin@vedder.se
+
+    This file is part of VESC Tool.
+
+    VESC Tool is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    VESC Tool is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+    */
+
+#include <QtTest>
+#include <QTemporaryDir>
+#include "confbackupstore.h"
+
+namespace {
+CONFIG_BACKUP makeBackup(QString uuid, QString name, QByteArray mc, QByteArray app)
+{
+    CONFIG_BACKUP cfg;
+    cfg.openroad_uuid = uuid;
+    cfg.name = name;
+    cfg.mcconf_xml_compressed = QString::fromLatin1(mc.toBase64());
+    cfg.appconf_xml_compressed = QString::fromLatin1(app.toBase64());
+    return cfg;
+}
+
+int blobCount(const QTemporaryDir &dir)
+{
+    return QDir(dir.filePath("blobs")).entryList(QDir::Files).size();
+}
+}
+
+class ConfBackupStoreTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void addAndRead();
+    void dedupe();
+    void history();
+    void reload();
+    void clear();
+    void corruptBlob();
+
+};
+
+void ConfBackupStoreTest::addAndRead()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    ConfBackupStore store(dir.path());
+
+    CONFIG_BACKUP in = makeBackup("uuid1", "Board", "mc data", "app data");
+    QVERIFY(store.add(in));
+    QVERIFY(store.contains("uuid1"));
+    QVERIFY(!store.contains("uuid2"));
+    QCOMPARE(store.uuids(), QStringList() << "uuid1");
+
+    // Readable before the writes are done
+    CONFIG_BACKUP out;
+    QVERIFY(store.backup("uuid1", out));
+    QCOMPARE(out.openroad_uuid, in.openroad_uuid);
+    QCOMPARE(out.name, in.name);
+    QCOMPARE(out.mcconf_xml_compressed, in.mcconf_xml_compressed);
+    QCOMPARE(out.appconf_xml_compressed, in.appconf_xml_compressed);
+
+    QVERIFY(store.waitForWrites());
+    QVERIFY(store.backup("uuid1", out));
+    QCOMPARE(out.mcconf_xml_compressed, in.mcconf_xml_compressed);
+
+    QVERIFY(!store.backup("uuid2", out));
+}
+
+void ConfBackupStoreTest::dedupe()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    ConfBackupStore store(dir.path());
+
+    QVERIFY(store.add(makeBackup("uuid1", "Board", "mc data", "app data")));
+    QVERIFY(!store.add(makeBackup("uuid1", "Board", "mc data", "app data")));
+    QCOMPARE(store.history("uuid1").size(), 1);
+
+    // Same content on another VESC, and a new name only
+    QVERIFY(store.add(makeBackup("uuid2", "Board", "mc data", "app data")));
+    QVERIFY(store.add(makeBackup("uuid1", "Renamed", "mc data", "app data")));
+    QCOMPARE(store.history("uuid1").size(), 2);
+
+    QVERIFY(store.waitForWrites());
+    QCOMPARE(blobCount(dir), 2);
+}
+
+void ConfBackupStoreTest::history()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    ConfBackupStore store(dir.path());
+
+    QVERIFY(store.add(makeBackup("uuid1", "Board", "mc 1", "app 1")));
+    QVERIFY(store.add(makeBackup("uuid1", "Board", "mc 2", "app 1")));
+    QVERIFY(store.add(makeBackup("uuid1", "Board", "mc 3", "app 2")));
+
+    auto versions = store.history("uuid1");
+    QCOMPARE(versions.size(), 3);
+    QVERIFY(versions.at(0).time <= versions.at(2).time);
+
+    CONFIG_BACKUP out;
+    QVERIFY(store.backup("uuid1", out, 0));
+    QCOMPARE(QByteArray::fromBase64(out.mcconf_xml_compressed.toLatin1()), QByteArray("mc 1"));
+    QVERIFY(store.backup("uuid1", out, 1));
+    QCOMPARE(QByteArray::fromBase64(out.mcconf_xml_compressed.toLatin1()), QByteArray("mc 2"));
+    QVERIFY(store.backup("uuid1", out));
+    QCOMPARE(QByteArray::fromBase64(out.mcconf_xml_compressed.toLatin1()), QByteArray("mc 3"));
+    QCOMPARE(QByteArray::fromBase64(out.appconf_xml_compressed.toLatin1()), QByteArray("app 2"));
+
+    QVERIFY(!store.backup("uuid1", out, 3));
+}
+
+void ConfBackupStoreTest::reload()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    {
+        ConfBackupStore store(dir.path());
+        QVERIFY(store.add(makeBackup("uuid1", "Board 1", "mc 1", "app 1")));
+        QVERIFY(store.add(makeBackup("uuid1", "Board 1", "mc 2", "app 1")));
+        QVERIFY(store.add(makeBackup("uuid2", "Board 2", "mc 3", "app 3")));
+    }
+
+    ConfBackupStore store(dir.path());
+    QCOMPARE(store.uuids().size(), 2);
+    QCOMPARE(store.history("uuid1").size(), 2);
+    QCOMPARE(store.history("uuid2").size(), 1);
+
+    CONFIG_BACKUP out;
+    QVERIFY(store.backup("uuid1", out, 0));
+    QCOMPARE(out.name, QString("Board 1"));
+    QCOMPARE(QByteArray::fromBase64(out.mcconf_xml_compressed.toLatin1()), QByteArray("mc 1"));
+    QVERIFY(store.backup("uuid2", out));
+    QCOMPARE(QByteArray::fromBase64(out.appconf_xml_compressed.toLatin1()), QByteArray("app 3"));
+
+    // A version added by another store is seen after reloading
+    ConfBackupStore other(dir.path());
+    QVERIFY(other.add(makeBackup("uuid3", "Board 3", "mc 4", "app 4")));
+    QVERIFY(other.waitForWrites());
+    QVERIFY(!store.contains("uuid3"));
+    store.reload();
+    QVERIFY(store.contains("uuid3"));
+}
+
+void ConfBackupStoreTest::clear()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    ConfBackupStore store(dir.path());
+
+    QVERIFY(store.add(makeBackup("uuid1", "Board", "mc data", "app data")));
+    store.clear();
+    QVERIFY(store.uuids().isEmpty());
+    QVERIFY(store.waitForWrites());
+    QCOMPARE(blobCount(dir), 0);
+
+    store.reload();
+    QVERIFY(store.uuids().isEmpty());
+
+    // Blobs that were removed are written again
+    QVERIFY(store.add(makeBackup("uuid1", "Board", "mc data", "app data")));
+    QVERIFY(store.waitForWrites());
+    QCOMPARE(blobCount(dir), 2);
+}
+
+void ConfBackupStoreTest::corruptBlob()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    CONFIG_BACKUP in = makeBackup("uuid1", "Board", "mc data", "app data");
+
+    {
+        ConfBackupStore store(dir.path());
+        QVERIFY(store.add(in));
+    }
+
+    QByteArray hash = QCryptographicHash::hash("mc data", QCryptographicHash::Sha1);
+    QFile blob(dir.filePath("blobs/" + QString::fromLatin1(hash.toHex()) + ".lzo"));
+    QVERIFY(blob.open(QIODevice::WriteOnly));
+    blob.write("corrupt");
+    blob.close();
+
+    ConfBackupStore store(dir.path());
+    CONFIG_BACKUP out;
+    QVERIFY(!store.backup("uuid1", out));
+
+    // Adding the same configuration again repairs the blob
+    in.name = "Repaired";
+    QVERIFY(store.add(in));
+    QVERIFY(store.waitForWrites());
+    QVERIFY(store.backup("uuid1", out, 0));
+    QCOMPARE(out.mcconf_xml_compressed, in.mcconf_xml_compressed);
+}
+
+QTEST_GUILESS_MAIN(ConfBackupStoreTest)
+
+#include "confbackupstoretest.moc"
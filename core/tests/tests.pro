@@ -0,0 +1,20 @@
+# Unit tests of the core, using QtTest. Run them with make check.
+
+include(../../features.pri)
+
+CONFIG += c++11
+CONFIG += console
+CONFIG += testcase
+CONFIG -= app_bundle
+CONFIG -= debug_and_release
+CONFIG += vt_core_link
+
+QT += testlib
+
+TEMPLATE = app
+TARGET = vesc_tool_tests
+
+include(../../core.pri)
+
+SOURCES += \
+    confbackupstoretest.cpp
@@ -18,6 +18,7 @@
     */
 
 #include "digitalfiltering.h"
+#include "eventtrace.h"
 #include <cmath>
 #include <QDebug>
 
@@ -32,6 +33,7 @@ DigitalFiltering::DigitalFiltering()
 // imag: Imaginary part
 void DigitalFiltering::fft(int dir, int m, double *real, double *imag)
 {
+    VT_TRACE_SCOPE("DigitalFiltering::fft");
     long n,i,i1,j,k,i2,l,l1,l2;
     double c1,c2,tx,ty,t1,t2,u1,u2,z;
 
@@ -196,6 +198,7 @@ int DigitalFiltering::whichPowerOfTwo(unsigned int number)
 
 QVector<double> DigitalFiltering::filterSignal(const QVector<double> &signal, const QVector<double> &filter, bool padAfter)
 {
+    VT_TRACE_SCOPE("DigitalFiltering::filterSignal");
     QVector<double> result;
     int taps = filter.size();
 
@@ -262,6 +265,7 @@ QVector<double> DigitalFiltering::generateFirFilter(double f_break, int bits, bo
 
 QVector<double> DigitalFiltering::fftWithShift(QVector<double> &signal, int resultBits, bool scaleByLen)
 {
+    VT_TRACE_SCOPE("DigitalFiltering::fftWithShift");
     QVector<double> result;
     int taps = signal.size();
     int resultLen = 1 << resultBits;
@@ -0,0 +1,220 @@
+/*
+    Copyright 2020 Benjamin Vedder	benjamin@vedder.se
+
+    This file is part of VESC Tool.
+
+    VESC Tool is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    VESC Tool is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+    */
+
+#include "eventtrace.h"
+#include <QMutex>
+#include <QVector>
+#include <QHash>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QCoreApplication>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QSaveFile>
+
+namespace {
+const int defaultCapacity = 200000;
+
+QMutex traceMutex;
+QVector<EventTrace::Event> traceBuffer;
+int traceCapacity = defaultCapacity;
+int traceNext = 0;
+int traceCount = 0;
+
+QElapsedTimer &traceClock()
+{
+    static QElapsedTimer clock;
+    if (!clock.isValid()) {
+        clock.start();
+    }
+    return clock;
+}
+}
+
+std::atomic<bool> EventTrace::mEnabled(false);
+
+/**
+ * @brief EventTrace::setEnabled
+ * Start or stop recording. The buffer is allocated the first time tracing
+ * is enabled and the recorded events are kept when it is disabled, so that
+ * they can be exported afterwards.
+ */
+void EventTrace::setEnabled(bool enabled)
+{
+    QMutexLocker locker(&traceMutex);
+
+    if (enabled && traceBuffer.size() != traceCapacity) {
+        traceBuffer.resize(traceCapacity);
+        traceNext = 0;
+        traceCount = 0;
+    }
+
+    traceClock();
+    mEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+void EventTrace::setCapacity(int events)
+{
+    QMutexLocker locker(&traceMutex);
+
+    traceCapacity = qMax(1000, events);
+    if (!traceBuffer.isEmpty()) {
+        traceBuffer.resize(traceCapacity);
+        traceBuffer.squeeze();
+    }
+    traceNext = 0;
+    traceCount = 0;
+}
+
+int EventTrace::capacity()
+{
+    QMutexLocker locker(&traceMutex);
+    return traceCapacity;
+}
+
+int EventTrace::count()
+{
+    QMutexLocker locker(&traceMutex);
+    return traceCount;
+}
+
+void EventTrace::clear()
+{
+    QMutexLocker locker(&traceMutex);
+    traceNext = 0;
+    traceCount = 0;
+}
+
+qint64 EventTrace::nowUs()
+{
+    return traceClock().nsecsElapsed() / 1000;
+}
+
+/**
+ * @brief EventTrace::record
+ * Add a finished scope to the ring buffer. When the buffer is full the
+ * oldest events are overwritten.
+ */
+void EventTrace::record(const char *name, const char *category,
+                        qint64 startUs, qint64 durUs, int arg)
+{
+    quintptr thread = quintptr(QThread::currentThreadId());
+
+    QMutexLocker locker(&traceMutex);
+
+    if (traceBuffer.isEmpty()) {
+        return;
+    }
+
+    Event &e = traceBuffer[traceNext];
+    e.name = name;
+    e.category = category;
+    e.startUs = startUs;
+    e.durUs = durUs;
+    e.thread = thread;
+    e.arg = arg;
+
+    traceNext = (traceNext + 1) % traceBuffer.size();
+    traceCount = qMin(traceCount + 1, traceBuffer.size());
+}
+
+/**
+ * @brief EventTrace::toChromeJson
+ * The recorded events, oldest first, in the Chrome trace-event format.
+ * Every scope is a complete ("X") event. Threads are numbered in the
+ * order they appear, and the exporting thread is named GUI.
+ */
+QByteArray EventTrace::toChromeJson()
+{
+    QVector<Event> events;
+
+    // Exports are made from the GUI, so that thread is named in the trace
+    quintptr mainThread = quintptr(QThread::currentThreadId());
+
+    {
+        QMutexLocker locker(&traceMutex);
+        events.reserve(traceCount);
+        int first = (traceNext - traceCount + traceBuffer.size()) % qMax(1, traceBuffer.size());
+        for (int i = 0;i < traceCount;i++) {
+            events.append(traceBuffer.at((first + i) % traceBuffer.size()));
+        }
+    }
+
+    QHash<quintptr, int> threadIds;
+    QJsonArray arr;
+    qint64 pid = QCoreApplication::applicationPid();
+
+    for (const auto &e: events) {
+        int tid = threadIds.value(e.thread, -1);
+        if (tid < 0) {
+            tid = threadIds.size() + 1;
+            threadIds.insert(e.thread, tid);
+
+            QJsonObject meta;
+            meta.insert("name", "thread_name");
+            meta.insert("ph", "M");
+            meta.insert("pid", pid);
+            meta.insert("tid", tid);
+            QJsonObject args;
+            args.insert("name", e.thread == mainThread ?
+                            QString("GUI") : QString("Thread %1").arg(tid));
+            meta.insert("args", args);
+            arr.append(meta);
+        }
+
+        QJsonObject obj;
+        obj.insert("name", QString::fromLatin1(e.name));
+        obj.insert("cat", QString::fromLatin1(e.category));
+        obj.insert("ph", "X");
+        obj.insert("ts", e.startUs);
+        obj.insert("dur", e.durUs);
+        obj.insert("pid", pid);
+        obj.insert("tid", tid);
+
+        if (e.arg >= 0) {
+            QJsonObject args;
+            args.insert("type", e.arg);
+            obj.insert("args", args);
+        }
+
+        arr.append(obj);
+    }
+
+    QJsonObject root;
+    root.insert("traceEvents", arr);
+    root.insert("displayTimeUnit", "ms");
+
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+bool EventTrace::exportChromeJson(QString fileName)
+{
+    if (fileName.startsWith("file:/")) {
+        fileName.remove(0, 6);
+    }
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    file.write(toChromeJson());
+    return file.commit();
+}
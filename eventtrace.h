@@ -0,0 +1,133 @@
+/*
+    Copyright 2020 Benjamin Vedder	benjamin@vedder.se
+
+    This file is part of VESC Tool.
+
+    VESC Tool is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    VESC Tool is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+    */
+
+#ifndef EVENTTRACE_H
+#define EVENTTRACE_H
+
+#include <QByteArray>
+#include <QString>
+#include <QObject>
+#include <QEvent>
+#include <atomic>
+
+/*
+ * Lightweight tracing of where the time in the event loop goes. Scopes are
+ * recorded in a ring buffer while tracing is enabled, and the buffer can be
+ * exported as Chrome trace-event JSON, which chrome://tracing and Perfetto
+ * open. When tracing is disabled a scope costs one relaxed atomic load.
+ *
+ * Names and categories are not copied, so they must be string literals or
+ * other strings that live as long as the application.
+ */
+class EventTrace
+{
+public:
+    struct Event {
+        const char *name;
+        const char *category;
+        qint64 startUs;
+        qint64 durUs;
+        quintptr thread;
+        int arg;
+    };
+
+    static inline bool isEnabled() {
+        return mEnabled.load(std::memory_order_relaxed);
+    }
+
+    static void setEnabled(bool enabled);
+    static void setCapacity(int events);
+    static int capacity();
+    static int count();
+    static void clear();
+
+    static qint64 nowUs();
+    static void record(const char *name, const char *category,
+                       qint64 startUs, qint64 durUs, int arg = -1);
+
+    static QByteArray toChromeJson();
+    static bool exportChromeJson(QString fileName);
+
+private:
+    static std::atomic<bool> mEnabled;
+
+};
+
+class EventTraceScope
+{
+public:
+    inline EventTraceScope(const char *name, const char *category = "vt", int arg = -1) {
+        if (EventTrace::isEnabled()) {
+            mName = name;
+            mCategory = category;
+            mArg = arg;
+            mStartUs = EventTrace::nowUs();
+        } else {
+            mStartUs = -1;
+        }
+    }
+
+    inline ~EventTraceScope() {
+        if (mStartUs >= 0) {
+            EventTrace::record(mName, mCategory, mStartUs,
+                               EventTrace::nowUs() - mStartUs, mArg);
+        }
+    }
+
+private:
+    const char *mName;
+    const char *mCategory;
+    int mArg;
+    qint64 mStartUs;
+
+};
+
+/*
+ * Application that traces the dispatch of every event, e.g.
+ * EventTraceApplication<QApplication> a(argc, argv);
+ */
+template <class T>
+class EventTraceApplication : public T
+{
+public:
+    using T::T;
+
+    bool notify(QObject *receiver, QEvent *event) override {
+        if (!EventTrace::isEnabled()) {
+            return T::notify(receiver, event);
+        }
+
+        EventTraceScope scope(receiver->metaObject()->className(), "event", int(event->type()));
+        return T::notify(receiver, event);
+    }
+};
+
+#ifdef VT_NO_TRACE
+#define VT_TRACE_SCOPE(name)
+#define VT_TRACE_SCOPE_CAT(name, category)
+#else
+#define VT_TRACE_CONCAT2(a, b) a##b
+#define VT_TRACE_CONCAT(a, b) VT_TRACE_CONCAT2(a, b)
+#define VT_TRACE_SCOPE(name) \
+    EventTraceScope VT_TRACE_CONCAT(vtTraceScope, __LINE__)(name)
+#define VT_TRACE_SCOPE_CAT(name, category) \
+    EventTraceScope VT_TRACE_CONCAT(vtTraceScope, __LINE__)(name, category)
+#endif
+
+#endif // EVENTTRACE_H
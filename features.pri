@@ -0,0 +1,17 @@
+# Optional features. Shared by the application and the core library, which
+# have to be built with the same features as they share class layouts.
+
+# Bluetooth available
+DEFINES += HAS_BLUETOOTH
+
+# CAN bus available
+# Adding serialbus to Qt seems to break the serial port on static builds. TODO: Figure out why.
+#DEFINES += HAS_CANBUS
+
+# Positioning
+DEFINES += HAS_POS
+
+!android: {
+    # Serial port available
+    DEFINES += HAS_SERIALPORT
+}
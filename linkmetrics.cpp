@@ -0,0 +1,484 @@
+/*
+    Copyright 2020 Benjamin Vedder	benjamin@vedder.se
+
+    This file is part of VESC Tool.
+
+    VESC Tool is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    VESC Tool is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+    */
+
+#include "linkmetrics.h"
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDateTime>
+#include <algorithm>
+
+namespace {
+const int rateIntervalMs = 1000;
+
+// Requests that were not answered within this time are most likely lost,
+// so a late response is not counted as a round trip.
+const qint64 pendingTimeoutUs = 10000000;
+
+// Names of COMM_PACKET_ID, in the same order as in datatypes.h
+const char *const commNames[] = {
+    "FW_VERSION", "JUMP_TO_BOOTLOADER", "ERASE_NEW_APP", "WRITE_NEW_APP_DATA",
+    "GET_VALUES", "SET_DUTY", "SET_CURRENT", "SET_CURRENT_BRAKE", "SET_RPM",
+    "SET_POS", "SET_HANDBRAKE", "SET_DETECT", "SET_SERVO_POS", "SET_MCCONF",
+    "GET_MCCONF", "GET_MCCONF_DEFAULT", "SET_APPCONF", "GET_APPCONF",
+    "GET_APPCONF_DEFAULT", "SAMPLE_PRINT", "TERMINAL_CMD", "PRINT",
+    "ROTOR_POSITION", "EXPERIMENT_SAMPLE", "DETECT_MOTOR_PARAM",
+    "DETECT_MOTOR_R_L", "DETECT_MOTOR_FLUX_LINKAGE", "DETECT_ENCODER",
+    "DETECT_HALL_FOC", "REBOOT", "ALIVE", "GET_DECODED_PPM", "GET_DECODED_ADC",
+    "GET_DECODED_CHUK", "FORWARD_CAN", "SET_CHUCK_DATA", "CUSTOM_APP_DATA",
+    "NRF_START_PAIRING", "GPD_SET_FSW", "GPD_BUFFER_NOTIFY",
+    "GPD_BUFFER_SIZE_LEFT", "GPD_FILL_BUFFER", "GPD_OUTPUT_SAMPLE",
+    "GPD_SET_MODE", "GPD_FILL_BUFFER_INT8", "GPD_FILL_BUFFER_INT16",
+    "GPD_SET_BUFFER_INT_SCALE", "GET_VALUES_SETUP", "SET_MCCONF_TEMP",
+    "SET_MCCONF_TEMP_SETUP", "GET_VALUES_SELECTIVE",
+    "GET_VALUES_SETUP_SELECTIVE", "EXT_NRF_PRESENT", "EXT_NRF_ESB_SET_CH_ADDR",
+    "EXT_NRF_ESB_SEND_DATA", "EXT_NRF_ESB_RX_DATA", "EXT_NRF_SET_ENABLED",
+    "DETECT_MOTOR_FLUX_LINKAGE_OPENLOOP", "DETECT_APPLY_ALL_FOC",
+    "JUMP_TO_BOOTLOADER_ALL_CAN", "ERASE_NEW_APP_ALL_CAN",
+    "WRITE_NEW_APP_DATA_ALL_CAN", "PING_CAN", "APP_DISABLE_OUTPUT",
+    "TERMINAL_CMD_SYNC", "GET_IMU_DATA", "BM_CONNECT", "BM_ERASE_FLASH_ALL",
+    "BM_WRITE_FLASH", "BM_REBOOT", "BM_DISCONNECT", "BM_MAP_PINS_DEFAULT",
+    "BM_MAP_PINS_NRF5X", "ERASE_BOOTLOADER", "ERASE_BOOTLOADER_ALL_CAN",
+    "PLOT_INIT", "PLOT_DATA", "PLOT_ADD_GRAPH", "PLOT_SET_GRAPH",
+    "GET_DECODED_BALANCE", "BM_MEM_READ", "WRITE_NEW_APP_DATA_LZO",
+    "WRITE_NEW_APP_DATA_ALL_CAN_LZO", "BM_WRITE_FLASH_LZO", "SET_CURRENT_REL",
+    "CAN_FWD_FRAME"
+};
+}
+
+LinkMetrics::CommandStats::CommandStats()
+{
+    requests = 0;
+    responses = 0;
+    dropped = 0;
+    rttCount = 0;
+    rttMinUs = 0;
+    rttMaxUs = 0;
+    rttSumUs = 0;
+
+    for (int i = 0;i < RTT_BUCKETS;i++) {
+        rttHist[i] = 0;
+    }
+}
+
+void LinkMetrics::CommandStats::addRtt(qint64 us)
+{
+    if (rttCount == 0 || us < rttMinUs) {
+        rttMinUs = us;
+    }
+
+    if (rttCount == 0 || us > rttMaxUs) {
+        rttMaxUs = us;
+    }
+
+    rttCount++;
+    rttSumUs += us;
+
+    int bucket = 0;
+    while (bucket < (RTT_BUCKETS - 1) &&
+           double(us) >= rttBucketLimitMs(bucket) * 1000.0) {
+        bucket++;
+    }
+
+    rttHist[bucket]++;
+}
+
+/**
+ * @brief LinkMetrics::CommandStats::rttPercentileMs
+ * Estimate a percentile of the round trip time from the histogram. The
+ * result is the upper limit of the bucket the percentile falls in, which
+ * is exact enough to tell a slow link from a lossy one.
+ *
+ * @param p
+ * Percentile, 0.0 to 1.0.
+ */
+double LinkMetrics::CommandStats::rttPercentileMs(double p) const
+{
+    if (rttCount == 0) {
+        return 0.0;
+    }
+
+    quint64 target = quint64(p * double(rttCount) + 0.5);
+    quint64 sum = 0;
+
+    for (int i = 0;i < (RTT_BUCKETS - 1);i++) {
+        sum += rttHist[i];
+        if (sum >= target) {
+            return qMin(rttBucketLimitMs(i), double(rttMaxUs) / 1000.0);
+        }
+    }
+
+    return double(rttMaxUs) / 1000.0;
+}
+
+LinkMetrics::LinkMetrics(QObject *parent) : QObject(parent)
+{
+    mClock.start();
+
+    mRateTimer = new QTimer(this);
+    mRateTimer->setInterval(rateIntervalMs);
+    mRateTimer->start();
+
+    mDumpTimer = new QTimer(this);
+
+    reset();
+
+    connect(mRateTimer, SIGNAL(timeout()), this, SLOT(rateTimerSlot()));
+    connect(mDumpTimer, SIGNAL(timeout()), this, SLOT(dumpTimerSlot()));
+}
+
+LinkMetrics::~LinkMetrics()
+{
+    stopDump();
+}
+
+void LinkMetrics::bytesReceived(int bytes)
+{
+    mBytesIn += quint64(bytes);
+}
+
+void LinkMetrics::bytesSent(int bytes)
+{
+    mBytesOut += quint64(bytes);
+}
+
+void LinkMetrics::packetReceived()
+{
+    mPacketsIn++;
+}
+
+void LinkMetrics::packetSent()
+{
+    mPacketsOut++;
+}
+
+void LinkMetrics::decodeFailed()
+{
+    mDecodeFailures++;
+}
+
+void LinkMetrics::resynced()
+{
+    mResyncs++;
+}
+
+void LinkMetrics::requestSent(int commId)
+{
+    mCommands[commId].requests++;
+    mPending.insert(commId, mClock.nsecsElapsed() / 1000);
+}
+
+void LinkMetrics::responseReceived(int commId)
+{
+    CommandStats &s = mCommands[commId];
+    s.responses++;
+
+    auto it = mPending.find(commId);
+    if (it != mPending.end()) {
+        qint64 rtt = mClock.nsecsElapsed() / 1000 - it.value();
+        if (rtt < pendingTimeoutUs) {
+            s.addRtt(rtt);
+        }
+        mPending.erase(it);
+    }
+}
+
+/**
+ * @brief LinkMetrics::requestDropped
+ * A request was not sent, because the previous request of the same kind
+ * has not been answered yet or because the firmware does not support it.
+ */
+void LinkMetrics::requestDropped(int commId)
+{
+    mCommands[commId].dropped++;
+}
+
+void LinkMetrics::txQueueDepth(qint64 bytes)
+{
+    mTxQueueDepth = bytes;
+    mTxQueueDepthMax = qMax(mTxQueueDepthMax, bytes);
+}
+
+/**
+ * @brief LinkMetrics::clearPending
+ * Forget requests that are waiting for a response, e.g. when the port is
+ * closed.
+ */
+void LinkMetrics::clearPending()
+{
+    mPending.clear();
+    mTxQueueDepth = 0;
+}
+
+quint64 LinkMetrics::getBytesIn() const
+{
+    return mBytesIn;
+}
+
+quint64 LinkMetrics::getBytesOut() const
+{
+    return mBytesOut;
+}
+
+quint64 LinkMetrics::getPacketsIn() const
+{
+    return mPacketsIn;
+}
+
+quint64 LinkMetrics::getPacketsOut() const
+{
+    return mPacketsOut;
+}
+
+double LinkMetrics::getBytesInPerSec() const
+{
+    return mBytesInRate;
+}
+
+double LinkMetrics::getBytesOutPerSec() const
+{
+    return mBytesOutRate;
+}
+
+double LinkMetrics::getPacketsInPerSec() const
+{
+    return mPacketsInRate;
+}
+
+double LinkMetrics::getPacketsOutPerSec() const
+{
+    return mPacketsOutRate;
+}
+
+quint64 LinkMetrics::getDecodeFailures() const
+{
+    return mDecodeFailures;
+}
+
+quint64 LinkMetrics::getResyncs() const
+{
+    return mResyncs;
+}
+
+qint64 LinkMetrics::getTxQueueDepth() const
+{
+    return mTxQueueDepth;
+}
+
+qint64 LinkMetrics::getTxQueueDepthMax() const
+{
+    return mTxQueueDepthMax;
+}
+
+QList<int> LinkMetrics::getCommandIds() const
+{
+    QList<int> res = mCommands.keys();
+    std::sort(res.begin(), res.end());
+    return res;
+}
+
+LinkMetrics::CommandStats LinkMetrics::getCommandStats(int commId) const
+{
+    return mCommands.value(commId);
+}
+
+/**
+ * @brief LinkMetrics::getSnapshot
+ * All metrics in a map, so that they can be used from QML and written
+ * as JSON.
+ */
+QVariantMap LinkMetrics::getSnapshot() const
+{
+    QVariantMap res;
+    res.insert("time", QDateTime::currentDateTime().toString(Qt::ISODateWithMs));
+    res.insert("bytes_in", mBytesIn);
+    res.insert("bytes_out", mBytesOut);
+    res.insert("packets_in", mPacketsIn);
+    res.insert("packets_out", mPacketsOut);
+    res.insert("bytes_in_per_sec", mBytesInRate);
+    res.insert("bytes_out_per_sec", mBytesOutRate);
+    res.insert("packets_in_per_sec", mPacketsInRate);
+    res.insert("packets_out_per_sec", mPacketsOutRate);
+    res.insert("decode_failures", mDecodeFailures);
+    res.insert("resyncs", mResyncs);
+    res.insert("tx_queue_depth", mTxQueueDepth);
+    res.insert("tx_queue_depth_max", mTxQueueDepthMax);
+
+    QVariantList commands;
+    for (int id: getCommandIds()) {
+        const CommandStats &s = mCommands[id];
+        QVariantMap c;
+        c.insert("id", id);
+        c.insert("name", commName(id));
+        c.insert("requests", s.requests);
+        c.insert("responses", s.responses);
+        c.insert("dropped", s.dropped);
+        c.insert("rtt_count", s.rttCount);
+
+        if (s.rttCount > 0) {
+            c.insert("rtt_min_ms", double(s.rttMinUs) / 1000.0);
+            c.insert("rtt_avg_ms", double(s.rttSumUs) / double(s.rttCount) / 1000.0);
+            c.insert("rtt_max_ms", double(s.rttMaxUs) / 1000.0);
+            c.insert("rtt_p50_ms", s.rttPercentileMs(0.5));
+            c.insert("rtt_p95_ms", s.rttPercentileMs(0.95));
+
+            QVariantList hist;
+            for (int i = 0;i < RTT_BUCKETS;i++) {
+                hist.append(s.rttHist[i]);
+            }
+            c.insert("rtt_hist", hist);
+        }
+
+        commands.append(c);
+    }
+
+    res.insert("commands", commands);
+    return res;
+}
+
+QByteArray LinkMetrics::toJson() const
+{
+    return QJsonDocument(QJsonObject::fromVariantMap(getSnapshot())).toJson(QJsonDocument::Compact);
+}
+
+void LinkMetrics::reset()
+{
+    mBytesIn = 0;
+    mBytesOut = 0;
+    mPacketsIn = 0;
+    mPacketsOut = 0;
+    mDecodeFailures = 0;
+    mResyncs = 0;
+    mTxQueueDepth = 0;
+    mTxQueueDepthMax = 0;
+
+    mBytesInLast = 0;
+    mBytesOutLast = 0;
+    mPacketsInLast = 0;
+    mPacketsOutLast = 0;
+    mRateTimeLast = mClock.elapsed();
+    mBytesInRate = 0.0;
+    mBytesOutRate = 0.0;
+    mPacketsInRate = 0.0;
+    mPacketsOutRate = 0.0;
+
+    mCommands.clear();
+    mPending.clear();
+}
+
+/**
+ * @brief LinkMetrics::startDump
+ * Append a snapshot of the metrics to a file periodically, one JSON object
+ * per line.
+ *
+ * @return
+ * false if the file could not be opened.
+ */
+bool LinkMetrics::startDump(QString fileName, int intervalMs)
+{
+    stopDump();
+
+    if (fileName.startsWith("file:/")) {
+        fileName.remove(0, 6);
+    }
+
+    mDumpFile.setFileName(fileName);
+    if (!mDumpFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        return false;
+    }
+
+    mDumpTimer->start(qMax(100, intervalMs));
+    return true;
+}
+
+void LinkMetrics::stopDump()
+{
+    mDumpTimer->stop();
+
+    if (mDumpFile.isOpen()) {
+        dumpTimerSlot();
+        mDumpFile.close();
+    }
+}
+
+bool LinkMetrics::isDumping() const
+{
+    return mDumpFile.isOpen();
+}
+
+QString LinkMetrics::getDumpFileName() const
+{
+    return mDumpFile.fileName();
+}
+
+QString LinkMetrics::commName(int commId)
+{
+    int count = int(sizeof(commNames) / sizeof(commNames[0]));
+
+    if (commId >= 0 && commId < count) {
+        return commNames[commId];
+    } else {
+        return QString("COMM_%1").arg(commId);
+    }
+}
+
+double LinkMetrics::rttBucketLimitMs(int bucket)
+{
+    return double(1 << bucket);
+}
+
+void LinkMetrics::rateTimerSlot()
+{
+    qint64 now = mClock.elapsed();
+    double dt = double(now - mRateTimeLast) / 1000.0;
+
+    if (dt <= 0.0) {
+        return;
+    }
+
+    mBytesInRate = double(mBytesIn - mBytesInLast) / dt;
+    mBytesOutRate = double(mBytesOut - mBytesOutLast) / dt;
+    mPacketsInRate = double(mPacketsIn - mPacketsInLast) / dt;
+    mPacketsOutRate = double(mPacketsOut - mPacketsOutLast) / dt;
+
+    mBytesInLast = mBytesIn;
+    mBytesOutLast = mBytesOut;
+    mPacketsInLast = mPacketsIn;
+    mPacketsOutLast = mPacketsOut;
+    mRateTimeLast = now;
+
+    // Requests that never got a response
+    for (auto it = mPending.begin();it != mPending.end();) {
+        if ((now * 1000 - it.value()) > pendingTimeoutUs) {
+            it = mPending.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    emit ratesUpdated();
+}
+
+void LinkMetrics::dumpTimerSlot()
+{
+    if (mDumpFile.isOpen()) {
+        mDumpFile.write(toJson());
+        mDumpFile.write("\n");
+        mDumpFile.flush();
+    }
+}
@@ -0,0 +1,140 @@
+/*
+    Copyright 2020 Benjamin Vedder	benjamin@vedder.se
+
+    This file is part of VESC Tool.
+
+    VESC Tool is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    VESC Tool is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+    */
+
+#ifndef LINKMETRICS_H
+#define LINKMETRICS_H
+
+#include <QObject>
+#include <QHash>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QFile>
+#include <QVariantMap>
+
+/*
+ * Counters and histograms of the link to the VESC. Packet, Commands and
+ * OpenroadInterface report what happens on the link, and the results can be
+ * read through the Q_INVOKABLE API, shown on the diagnostics page or dumped
+ * to a file periodically.
+ */
+class LinkMetrics : public QObject
+{
+    Q_OBJECT
+public:
+    // Round trip time histogram with power of two bucket limits in ms. The
+    // last bucket holds everything slower.
+    static const int RTT_BUCKETS = 12;
+
+    struct CommandStats {
+        CommandStats();
+        void addRtt(qint64 us);
+        double rttPercentileMs(double p) const;
+
+        quint64 requests;
+        quint64 responses;
+        quint64 dropped;
+        quint64 rttCount;
+        qint64 rttMinUs;
+        qint64 rttMaxUs;
+        qint64 rttSumUs;
+        quint32 rttHist[RTT_BUCKETS];
+    };
+
+    explicit LinkMetrics(QObject *parent = nullptr);
+    ~LinkMetrics();
+
+    // Recording
+    void bytesReceived(int bytes);
+    void bytesSent(int bytes);
+    void packetReceived();
+    void packetSent();
+    void decodeFailed();
+    void resynced();
+    void requestSent(int commId);
+    void responseReceived(int commId);
+    void requestDropped(int commId);
+    void txQueueDepth(qint64 bytes);
+    void clearPending();
+
+    // Results
+    Q_INVOKABLE quint64 getBytesIn() const;
+    Q_INVOKABLE quint64 getBytesOut() const;
+    Q_INVOKABLE quint64 getPacketsIn() const;
+    Q_INVOKABLE quint64 getPacketsOut() const;
+    Q_INVOKABLE double getBytesInPerSec() const;
+    Q_INVOKABLE double getBytesOutPerSec() const;
+    Q_INVOKABLE double getPacketsInPerSec() const;
+    Q_INVOKABLE double getPacketsOutPerSec() const;
+    Q_INVOKABLE quint64 getDecodeFailures() const;
+    Q_INVOKABLE quint64 getResyncs() const;
+    Q_INVOKABLE qint64 getTxQueueDepth() const;
+    Q_INVOKABLE qint64 getTxQueueDepthMax() const;
+    Q_INVOKABLE QList<int> getCommandIds() const;
+    CommandStats getCommandStats(int commId) const;
+    Q_INVOKABLE QVariantMap getSnapshot() const;
+    Q_INVOKABLE QByteArray toJson() const;
+    Q_INVOKABLE void reset();
+
+    // Periodic dump
+    Q_INVOKABLE bool startDump(QString fileName, int intervalMs = 1000);
+    Q_INVOKABLE void stopDump();
+    Q_INVOKABLE bool isDumping() const;
+    Q_INVOKABLE QString getDumpFileName() const;
+
+    static QString commName(int commId);
+    static double rttBucketLimitMs(int bucket);
+
+signals:
+    void ratesUpdated();
+
+private slots:
+    void rateTimerSlot();
+    void dumpTimerSlot();
+
+private:
+    QElapsedTimer mClock;
+    QTimer *mRateTimer;
+    QTimer *mDumpTimer;
+    QFile mDumpFile;
+
+    quint64 mBytesIn;
+    quint64 mBytesOut;
+    quint64 mPacketsIn;
+    quint64 mPacketsOut;
+    quint64 mDecodeFailures;
+    quint64 mResyncs;
+    qint64 mTxQueueDepth;
+    qint64 mTxQueueDepthMax;
+
+    quint64 mBytesInLast;
+    quint64 mBytesOutLast;
+    quint64 mPacketsInLast;
+    quint64 mPacketsOutLast;
+    qint64 mRateTimeLast;
+    double mBytesInRate;
+    double mBytesOutRate;
+    double mPacketsInRate;
+    double mPacketsOutRate;
+
+    QHash<int, CommandStats> mCommands;
+    QHash<int, qint64> mPending;
+
+};
+
+#endif // LINKMETRICS_H
@@ -0,0 +1,240 @@
+/*
+    Copyright 2020 Benjamin Vedder	benjamin@vedder.se
+
+    This file is part of VESC Tool.
+
+    VESC Tool is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    VESC Tool is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+    */
+
+#include "logbatchanalysis.h"
+#include <QtConcurrent>
+#include <QDirIterator>
+#include <QSaveFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+namespace {
+LogBatchAnalysis::Summary summarizePath(const QString &path)
+{
+    LogBatchAnalysis::Summary s = LogDirIndex::summarize(path);
+    s.fileName = path;
+    return s;
+}
+
+// Paths can contain the separator, quotes and line breaks
+QString csvField(QString field)
+{
+    return "\"" + field.replace("\"", "\"\"") + "\"";
+}
+
+double whPerKm(const LogBatchAnalysis::Summary &s)
+{
+    return s.meters > 0.0 ? (s.wh - s.whCharged) / (s.meters / 1000.0) : 0.0;
+}
+
+QJsonObject summaryToJson(const LogBatchAnalysis::Summary &s)
+{
+    QJsonObject obj;
+    obj.insert("file", s.fileName);
+    obj.insert("valid", s.valid);
+    obj.insert("samples", s.samples);
+    obj.insert("duration_s", double(s.durationMs) / 1000.0);
+    obj.insert("distance_m", s.meters);
+    obj.insert("distance_gnss_m", s.metersGnss);
+    obj.insert("wh", s.wh);
+    obj.insert("wh_charged", s.whCharged);
+    obj.insert("ah", s.ah);
+    obj.insert("ah_charged", s.ahCharged);
+    obj.insert("wh_per_km", whPerKm(s));
+    obj.insert("speed_max_kmh", 3.6 * s.speedMax);
+    obj.insert("speed_max_gnss_kmh", 3.6 * s.speedMaxGnss);
+    obj.insert("power_avg_w", s.powerAvg);
+    obj.insert("power_max_w", s.powerMax);
+    obj.insert("temp_mos_max", s.tempMosMax);
+    obj.insert("temp_motor_max", s.tempMotorMax);
+    obj.insert("faults", s.faults);
+    return obj;
+}
+}
+
+/**
+ * @brief LogBatchAnalysis::findLogs
+ * Get the paths of all logs in a directory, optionally including its
+ * subdirectories.
+ */
+QStringList LogBatchAnalysis::findLogs(QString dirPath, bool recursive)
+{
+    QStringList res;
+    QDirIterator it(dirPath, LogDirIndex::nameFilters(), QDir::Files,
+                    recursive ? QDirIterator::Subdirectories : QDirIterator::NoIteratorFlags);
+
+    while (it.hasNext()) {
+        res.append(it.next());
+    }
+
+    res.sort();
+    return res;
+}
+
+/**
+ * @brief LogBatchAnalysis::start
+ * Start summarizing files on the global thread pool. The results are in
+ * the same order as files, with the full path as file name. The future
+ * reports progress and can be canceled.
+ */
+QFuture<LogBatchAnalysis::Summary> LogBatchAnalysis::start(const QStringList &files)
+{
+    return QtConcurrent::mapped(files, summarizePath);
+}
+
+/**
+ * @brief LogBatchAnalysis::run
+ * Same as start, but blocks until all files are done.
+ */
+QVector<LogBatchAnalysis::Summary> LogBatchAnalysis::run(const QStringList &files)
+{
+    return QtConcurrent::blockingMapped<QVector<Summary> >(files, summarizePath);
+}
+
+/**
+ * @brief LogBatchAnalysis::total
+ * Combine the valid logs into one summary. Counts, times and energy are
+ * added, maxima are the maxima of all logs and the average power is
+ * weighted by the duration of the logs.
+ */
+LogBatchAnalysis::Summary LogBatchAnalysis::total(const QVector<Summary> &logs)
+{
+    Summary t;
+    t.fileName = "Total";
+    double powerTime = 0.0;
+
+    for (const auto &s: logs) {
+        if (!s.valid) {
+            continue;
+        }
+
+        if (!t.valid) {
+            t.valid = true;
+            t.tempMosMax = s.tempMosMax;
+            t.tempMotorMax = s.tempMotorMax;
+        }
+
+        t.size += s.size;
+        t.samples += s.samples;
+        t.durationMs += s.durationMs;
+        t.meters += s.meters;
+        t.metersGnss += s.metersGnss;
+        t.wh += s.wh;
+        t.whCharged += s.whCharged;
+        t.ah += s.ah;
+        t.ahCharged += s.ahCharged;
+        t.speedMax = qMax(t.speedMax, s.speedMax);
+        t.speedMaxGnss = qMax(t.speedMaxGnss, s.speedMaxGnss);
+        t.powerMax = qMax(t.powerMax, s.powerMax);
+        t.tempMosMax = qMax(t.tempMosMax, s.tempMosMax);
+        t.tempMotorMax = qMax(t.tempMotorMax, s.tempMotorMax);
+        t.faults += s.faults;
+        powerTime += s.powerAvg * double(s.durationMs);
+    }
+
+    if (t.durationMs > 0) {
+        t.powerAvg = powerTime / double(t.durationMs);
+    }
+
+    return t;
+}
+
+/**
+ * @brief LogBatchAnalysis::toCsv
+ * Report with one line per log and the total on the last line, separated
+ * with semicolons like the logs themselves. All fields are quoted.
+ */
+QByteArray LogBatchAnalysis::toCsv(const QVector<Summary> &logs)
+{
+    QByteArray res;
+    res.append("file;valid;samples;duration_s;distance_m;distance_gnss_m;"
+               "wh;wh_charged;ah;ah_charged;wh_per_km;speed_max_kmh;"
+               "speed_max_gnss_kmh;power_avg_w;power_max_w;temp_mos_max;"
+               "temp_motor_max;faults\n");
+
+    QVector<Summary> rows = logs;
+    rows.append(total(logs));
+
+    for (const auto &s: rows) {
+        QStringList fields;
+        fields << s.fileName
+               << QString::number(s.valid ? 1 : 0)
+               << QString::number(s.samples)
+               << QString::number(double(s.durationMs) / 1000.0, 'f', 3)
+               << QString::number(s.meters, 'f', 2)
+               << QString::number(s.metersGnss, 'f', 2)
+               << QString::number(s.wh, 'f', 3)
+               << QString::number(s.whCharged, 'f', 3)
+               << QString::number(s.ah, 'f', 3)
+               << QString::number(s.ahCharged, 'f', 3)
+               << QString::number(whPerKm(s), 'f', 2)
+               << QString::number(3.6 * s.speedMax, 'f', 2)
+               << QString::number(3.6 * s.speedMaxGnss, 'f', 2)
+               << QString::number(s.powerAvg, 'f', 1)
+               << QString::number(s.powerMax, 'f', 1)
+               << QString::number(s.tempMosMax, 'f', 1)
+               << QString::number(s.tempMotorMax, 'f', 1)
+               << QString::number(s.faults);
+
+        for (auto &f: fields) {
+            f = csvField(f);
+        }
+
+        res.append(fields.join(";").toUtf8());
+        res.append('\n');
+    }
+
+    return res;
+}
+
+QByteArray LogBatchAnalysis::toJson(const QVector<Summary> &logs)
+{
+    QJsonArray arr;
+    for (const auto &s: logs) {
+        arr.append(summaryToJson(s));
+    }
+
+    QJsonObject obj;
+    obj.insert("logs", arr);
+    obj.insert("total", summaryToJson(total(logs)));
+
+    return QJsonDocument(obj).toJson();
+}
+
+/**
+ * @brief LogBatchAnalysis::writeReport
+ * Write a report to fileName. The format is JSON if fileName ends with
+ * .json and CSV otherwise.
+ */
+bool LogBatchAnalysis::writeReport(QString fileName, const QVector<Summary> &logs)
+{
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    if (fileName.toLower().endsWith(".json")) {
+        file.write(toJson(logs));
+    } else {
+        file.write(toCsv(logs));
+    }
+
+    return file.commit();
+}
@@ -0,0 +1,48 @@
+/*
+    Copyright 2020 Benjamin Vedder	benjamin@vedder.se
+
+    This file is part of VESC Tool.
+
+    VESC Tool is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    VESC Tool is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOGBATCHANALYSIS_H
+#define LOGBATCHANALYSIS_H
+
+#include <QFuture>
+#include <QStringList>
+#include "logdirindex.h"
+
+/*
+ * Summaries of many logs at once, e.g. all logs of a fleet, computed in
+ * parallel on all cores and written as a CSV or JSON report with one row
+ * per log and a total.
+ */
+class LogBatchAnalysis
+{
+public:
+    typedef LogDirIndex::Summary Summary;
+
+    static QStringList findLogs(QString dirPath, bool recursive);
+    static QFuture<Summary> start(const QStringList &files);
+    static QVector<Summary> run(const QStringList &files);
+    static Summary total(const QVector<Summary> &logs);
+
+    static QByteArray toCsv(const QVector<Summary> &logs);
+    static QByteArray toJson(const QVector<Summary> &logs);
+    static bool writeReport(QString fileName, const QVector<Summary> &logs);
+
+};
+
+#endif // LOGBATCHANALYSIS_H
@@ -0,0 +1,365 @@
+/*
+    Copyright 2020 Benjamin Vedder	benjamin@vedder.se
+
+    This file is part of VESC Tool.
+
+    VESC Tool is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    VESC Tool is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+    */
+
+#include "logdirindex.h"
+#include "openroadinterface.h"
+#include "logindex.h"
+#include "lzologdevice.h"
+#include <QtConcurrent>
+#include <QDir>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDataStream>
+#include <QSaveFile>
+#include <QDebug>
+#include <cmath>
+
+namespace {
+const char sidecarName[] = ".vesc_tool_logs.idx";
+const quint32 sidecarMagic = 0x564C4449;
+const quint32 sidecarVersion = 2;
+const int trackPoints = 48;
+
+QDataStream &operator<<(QDataStream &out, const LogDirIndex::Summary &s)
+{
+    out << s.fileName << s.size << s.modified << s.valid << qint32(s.samples)
+        << s.durationMs << s.meters << s.metersGnss << s.wh << s.whCharged
+        << s.ah << s.ahCharged << s.speedMax << s.speedMaxGnss
+        << s.powerAvg << s.powerMax << s.tempMosMax << s.tempMotorMax
+        << qint32(s.faults) << s.track;
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, LogDirIndex::Summary &s)
+{
+    qint32 samples = 0;
+    qint32 faults = 0;
+    in >> s.fileName >> s.size >> s.modified >> s.valid >> samples
+       >> s.durationMs >> s.meters >> s.metersGnss >> s.wh >> s.whCharged
+       >> s.ah >> s.ahCharged >> s.speedMax >> s.speedMaxGnss
+       >> s.powerAvg >> s.powerMax >> s.tempMosMax >> s.tempMotorMax
+       >> faults >> s.track;
+    s.samples = samples;
+    s.faults = faults;
+    return in;
+}
+}
+
+LogDirIndex::LogDirIndex(QObject *parent) : QObject(parent)
+{
+    mSidecarDirty = false;
+    mWatcher = new QFutureWatcher<Summary>(this);
+
+    connect(mWatcher, &QFutureWatcher<Summary>::finished, [this]() {
+        Summary s = mWatcher->result();
+
+        // Results for a directory that is not shown anymore are dropped,
+        // the log will be indexed again when that directory is opened.
+        if (mRunningDir == mDir) {
+            mSummaries.insert(s.fileName, s);
+            mSidecarDirty = true;
+            emit summaryUpdated(s.fileName);
+
+            // Not queued again by rescans while it was running
+            QFileInfo f(QDir(mDir).absoluteFilePath(s.fileName));
+            if (mFiles.contains(s.fileName) && f.exists() &&
+                    !isCurrent(s, f.size(), f.lastModified().toMSecsSinceEpoch()) &&
+                    !mQueue.contains(s.fileName)) {
+                mQueue.append(s.fileName);
+            }
+        }
+
+        mRunningFile.clear();
+        startNext();
+    });
+}
+
+LogDirIndex::~LogDirIndex()
+{
+    mQueue.clear();
+    mWatcher->waitForFinished();
+
+    if (mRunningDir == mDir && !mWatcher->future().isCanceled() &&
+            mWatcher->future().resultCount() > 0) {
+        Summary s = mWatcher->result();
+        mSummaries.insert(s.fileName, s);
+        mSidecarDirty = true;
+    }
+
+    saveSidecar();
+}
+
+/**
+ * @brief LogDirIndex::setDirectory
+ * Show the logs in path. The sidecar index of the directory is loaded and
+ * logs that are new or changed since it was written are queued for
+ * indexing. Calling this again with the same path rescans the directory.
+ */
+void LogDirIndex::setDirectory(QString path)
+{
+    QString dirPath = QDir(path).absolutePath();
+
+    if (dirPath != mDir) {
+        saveSidecar();
+        mSummaries.clear();
+        mDir = dirPath;
+        loadSidecar();
+    }
+
+    mFiles.clear();
+    mQueue.clear();
+
+    // The log that is being indexed is checked again when it is done
+    QString running;
+    if (mWatcher->isRunning() && mRunningDir == mDir) {
+        running = mRunningFile;
+    }
+
+    QDir dir(mDir);
+    if (dir.exists() && !path.isEmpty()) {
+        for (QFileInfo f: dir.entryInfoList(nameFilters(), QDir::Files, QDir::Name)) {
+            mFiles.append(f.fileName());
+
+            if (f.fileName() == running) {
+                continue;
+            }
+
+            auto it = mSummaries.constFind(f.fileName());
+            if (it == mSummaries.constEnd() ||
+                    !isCurrent(it.value(), f.size(), f.lastModified().toMSecsSinceEpoch())) {
+                mQueue.append(f.fileName());
+            }
+        }
+    }
+
+    // Forget logs that were removed
+    for (auto it = mSummaries.begin();it != mSummaries.end();) {
+        if (mFiles.contains(it.key())) {
+            ++it;
+        } else {
+            it = mSummaries.erase(it);
+            mSidecarDirty = true;
+        }
+    }
+
+    emit listChanged();
+    startNext();
+}
+
+QString LogDirIndex::directory() const
+{
+    return mDir;
+}
+
+QStringList LogDirIndex::fileNames() const
+{
+    return mFiles;
+}
+
+/**
+ * @brief LogDirIndex::summary
+ * Get the summary of a log in the current directory.
+ *
+ * @return
+ * false if the log has not been indexed yet.
+ */
+bool LogDirIndex::summary(QString fileName, LogDirIndex::Summary &s) const
+{
+    auto it = mSummaries.constFind(fileName);
+    if (it == mSummaries.constEnd()) {
+        return false;
+    }
+
+    s = it.value();
+    return true;
+}
+
+int LogDirIndex::pendingCount() const
+{
+    return mQueue.size() + (mWatcher->isRunning() ? 1 : 0);
+}
+
+QStringList LogDirIndex::nameFilters()
+{
+    return QStringList() << "*.csv" << "*.Csv" << "*.CSV" << "*." + LzoLogDevice::fileSuffix();
+}
+
+/**
+ * @brief LogDirIndex::summarize
+ * Parse a log and compute its summary. Only uses its argument, so it can
+ * run in a worker thread.
+ */
+LogDirIndex::Summary LogDirIndex::summarize(QString filePath)
+{
+    Summary s;
+    QFileInfo fi(filePath);
+    s.fileName = fi.fileName();
+    s.size = fi.size();
+    s.modified = fi.lastModified().toMSecsSinceEpoch();
+
+    QVector<LOG_DATA> data;
+    if (!OpenroadInterface::readRtLogFile(filePath, data)) {
+        return s;
+    }
+
+    s.valid = true;
+    s.samples = data.size();
+
+    if (data.isEmpty()) {
+        return s;
+    }
+
+    LogIndex index;
+    index.build(data);
+
+    int last = data.size() - 1;
+    const LOG_DATA &first = data.first();
+    const LOG_DATA &end = data.last();
+
+    s.durationMs = index.timeMsRange(0, last);
+    s.meters = end.setupValues.tachometer_abs - first.setupValues.tachometer_abs;
+    s.metersGnss = index.distGnss(last);
+    s.wh = end.setupValues.watt_hours - first.setupValues.watt_hours;
+    s.whCharged = end.setupValues.watt_hours_charged - first.setupValues.watt_hours_charged;
+    s.ah = end.setupValues.amp_hours - first.setupValues.amp_hours;
+    s.ahCharged = end.setupValues.amp_hours_charged - first.setupValues.amp_hours_charged;
+    s.speedMax = qMax(fabs(index.rangeMin(LogIndex::CH_SPEED, 0, data.size())),
+                      fabs(index.rangeMax(LogIndex::CH_SPEED, 0, data.size())));
+    s.speedMaxGnss = index.rangeMax(LogIndex::CH_SPEED_GNSS, 0, data.size());
+    s.powerAvg = index.rangeAvg(LogIndex::CH_POWER, 0, data.size());
+    s.powerMax = index.rangeMax(LogIndex::CH_POWER, 0, data.size());
+
+    // Faults are counted when they start, not for every sample they last
+    s.tempMosMax = first.values.temp_mos;
+    s.tempMotorMax = first.values.temp_motor;
+    mc_fault_code faultLast = FAULT_CODE_NONE;
+
+    for (const auto &d: data) {
+        s.tempMosMax = qMax(s.tempMosMax, d.values.temp_mos);
+        s.tempMotorMax = qMax(s.tempMotorMax, d.values.temp_motor);
+
+        if (d.values.fault_code != FAULT_CODE_NONE && d.values.fault_code != faultLast) {
+            s.faults++;
+        }
+        faultLast = d.values.fault_code;
+    }
+
+    int gnss = index.gnssCount();
+    if (gnss > 0) {
+        int step = qMax(1, gnss / trackPoints);
+        double xyz[3];
+
+        for (int g = 0;g < gnss;g += step) {
+            index.gnssEnu(g, xyz);
+            s.track.append(QPointF(xyz[0], xyz[1]));
+        }
+
+        if ((gnss - 1) % step != 0) {
+            index.gnssEnu(gnss - 1, xyz);
+            s.track.append(QPointF(xyz[0], xyz[1]));
+        }
+    }
+
+    return s;
+}
+
+void LogDirIndex::startNext()
+{
+    if (mWatcher->isRunning()) {
+        return;
+    }
+
+    if (mQueue.isEmpty()) {
+        saveSidecar();
+        emit indexingFinished();
+        return;
+    }
+
+    mRunningFile = mQueue.takeFirst();
+    QString path = QDir(mDir).absoluteFilePath(mRunningFile);
+    mRunningDir = mDir;
+    mWatcher->setFuture(QtConcurrent::run([path]() {
+        return summarize(path);
+    }));
+}
+
+void LogDirIndex::loadSidecar()
+{
+    QFile file(QDir(mDir).absoluteFilePath(sidecarName));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    qint32 count = 0;
+    in >> magic >> version >> count;
+
+    if (magic != sidecarMagic || version != sidecarVersion || count < 0) {
+        return;
+    }
+
+    for (int i = 0;i < count;i++) {
+        Summary s;
+        in >> s;
+
+        if (in.status() != QDataStream::Ok) {
+            qWarning() << "Log index" << file.fileName() << "is corrupt, rebuilding";
+            mSummaries.clear();
+            return;
+        }
+
+        mSummaries.insert(s.fileName, s);
+    }
+}
+
+void LogDirIndex::saveSidecar()
+{
+    if (!mSidecarDirty || mDir.isEmpty()) {
+        return;
+    }
+
+    mSidecarDirty = false;
+
+    // Written to a temporary file first, so that an interrupted write
+    // does not leave a broken index behind. A read-only directory just
+    // means that the logs are indexed again next time.
+    QSaveFile file(QDir(mDir).absoluteFilePath(sidecarName));
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << sidecarMagic << sidecarVersion << qint32(mSummaries.size());
+
+    for (const auto &s: mSummaries) {
+        out << s;
+    }
+
+    file.commit();
+}
+
+bool LogDirIndex::isCurrent(const LogDirIndex::Summary &s, qint64 size, qint64 modified)
+{
+    return s.size == size && s.modified == modified;
+}
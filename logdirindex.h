@@ -0,0 +1,120 @@
+/*
+    Copyright 2020 Benjamin Vedder	benjamin@vedder.se
+
+    This file is part of VESC Tool.
+
+    VESC Tool is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    VESC Tool is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOGDIRINDEX_H
+#define LOGDIRINDEX_H
+
+#include <QObject>
+#include <QHash>
+#include <QVector>
+#include <QPointF>
+#include <QStringList>
+#include <QFutureWatcher>
+
+/*
+ * Summary statistics and a small track thumbnail for every log in a
+ * directory. The summaries are stored in a sidecar file in the directory,
+ * keyed by file name, size and modification time, so only new or changed
+ * logs have to be parsed. Parsing is done one log at a time in a worker
+ * thread.
+ */
+class LogDirIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Summary {
+        Summary() {
+            size = 0;
+            modified = 0;
+            valid = false;
+            samples = 0;
+            durationMs = 0;
+            meters = 0.0;
+            metersGnss = 0.0;
+            wh = 0.0;
+            whCharged = 0.0;
+            ah = 0.0;
+            ahCharged = 0.0;
+            speedMax = 0.0;
+            speedMaxGnss = 0.0;
+            powerAvg = 0.0;
+            powerMax = 0.0;
+            tempMosMax = 0.0;
+            tempMotorMax = 0.0;
+            faults = 0;
+        }
+
+        QString fileName;
+        qint64 size;
+        qint64 modified;
+        bool valid;
+        int samples;
+        qint64 durationMs;
+        double meters;
+        double metersGnss;
+        double wh;
+        double whCharged;
+        double ah;
+        double ahCharged;
+        double speedMax;
+        double speedMaxGnss;
+        double powerAvg;
+        double powerMax;
+        double tempMosMax;
+        double tempMotorMax;
+        int faults;
+        QVector<QPointF> track;
+    };
+
+    explicit LogDirIndex(QObject *parent = nullptr);
+    ~LogDirIndex() override;
+
+    void setDirectory(QString path);
+    QString directory() const;
+    QStringList fileNames() const;
+    bool summary(QString fileName, Summary &s) const;
+    int pendingCount() const;
+
+    static QStringList nameFilters();
+    static Summary summarize(QString filePath);
+
+signals:
+    void listChanged();
+    void summaryUpdated(QString fileName);
+    void indexingFinished();
+
+private:
+    QString mDir;
+    QStringList mFiles;
+    QHash<QString, Summary> mSummaries;
+    QStringList mQueue;
+    QString mRunningDir;
+    QString mRunningFile;
+    bool mSidecarDirty;
+    QFutureWatcher<Summary> *mWatcher;
+
+    void startNext();
+    void loadSidecar();
+    void saveSidecar();
+    static bool isCurrent(const Summary &s, qint64 size, qint64 modified);
+
+};
+
+#endif // LOGDIRINDEX_H
@@ -0,0 +1,501 @@
+/*
+    Copyright 2020 Benjamin Vedder	benjamin@vedder.se
+
+    This file is part of VESC Tool.
+
+    VESC Tool is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    VESC Tool is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+    */
+
+#include "logindex.h"
+#include "utility.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+const qint64 msPerDay = 60 * 60 * 24 * 1000;
+const double valInf = std::numeric_limits<double>::infinity();
+}
+
+LogRangeTree::LogRangeTree()
+{
+    clear();
+}
+
+void LogRangeTree::clear()
+{
+    mSize = 0;
+    mCapacity = 0;
+    mMin.clear();
+    mMax.clear();
+    mSum.clear();
+    mSum.append(0.0);
+}
+
+void LogRangeTree::reserve(int size)
+{
+    int capacity = 1;
+    while (capacity < size) {
+        capacity *= 2;
+    }
+
+    if (capacity > mCapacity) {
+        grow(capacity);
+    }
+
+    mSum.reserve(size + 1);
+}
+
+void LogRangeTree::append(double value)
+{
+    if (mSize >= mCapacity) {
+        grow(mCapacity > 0 ? 2 * mCapacity : 1024);
+    }
+
+    int i = mCapacity + mSize;
+    mMin[i] = value;
+    mMax[i] = value;
+
+    for (i /= 2;i >= 1;i /= 2) {
+        mMin[i] = std::min(mMin[2 * i], mMin[2 * i + 1]);
+        mMax[i] = std::max(mMax[2 * i], mMax[2 * i + 1]);
+    }
+
+    mSum.append(mSum.last() + value);
+    mSize++;
+}
+
+int LogRangeTree::size() const
+{
+    return mSize;
+}
+
+/**
+ * @brief LogRangeTree::min
+ * Smallest value in [start, end), or +inf for an empty range.
+ */
+double LogRangeTree::min(int start, int end) const
+{
+    double res = valInf;
+    start = std::max(start, 0) + mCapacity;
+    end = std::min(end, mSize) + mCapacity;
+
+    while (start < end) {
+        if (start & 1) {
+            res = std::min(res, mMin[start++]);
+        }
+        if (end & 1) {
+            res = std::min(res, mMin[--end]);
+        }
+        start /= 2;
+        end /= 2;
+    }
+
+    return res;
+}
+
+/**
+ * @brief LogRangeTree::max
+ * Largest value in [start, end), or -inf for an empty range.
+ */
+double LogRangeTree::max(int start, int end) const
+{
+    double res = -valInf;
+    start = std::max(start, 0) + mCapacity;
+    end = std::min(end, mSize) + mCapacity;
+
+    while (start < end) {
+        if (start & 1) {
+            res = std::max(res, mMax[start++]);
+        }
+        if (end & 1) {
+            res = std::max(res, mMax[--end]);
+        }
+        start /= 2;
+        end /= 2;
+    }
+
+    return res;
+}
+
+double LogRangeTree::sum(int start, int end) const
+{
+    start = std::max(start, 0);
+    end = std::min(end, mSize);
+
+    if (start >= end) {
+        return 0.0;
+    }
+
+    return mSum.at(end) - mSum.at(start);
+}
+
+void LogRangeTree::grow(int capacity)
+{
+    QVector<double> min(2 * capacity, valInf);
+    QVector<double> max(2 * capacity, -valInf);
+
+    for (int i = 0;i < mSize;i++) {
+        min[capacity + i] = mMin[mCapacity + i];
+        max[capacity + i] = mMax[mCapacity + i];
+    }
+
+    for (int i = capacity - 1;i >= 1;i--) {
+        min[i] = std::min(min[2 * i], min[2 * i + 1]);
+        max[i] = std::max(max[2 * i], max[2 * i + 1]);
+    }
+
+    mMin = min;
+    mMax = max;
+    mCapacity = capacity;
+}
+
+LogIndex::LogIndex()
+{
+    mEnuRefSet = false;
+    mEnuRef[0] = 0.0;
+    mEnuRef[1] = 0.0;
+    mEnuRef[2] = 0.0;
+    mFilterEnabled = false;
+    mFilterMaxHAcc = 0.0;
+    clearColumns();
+}
+
+/**
+ * @brief LogIndex::clear
+ * Remove all samples and the ENU reference. The GNSS filter is kept.
+ */
+void LogIndex::clear()
+{
+    clearColumns();
+    mEnuRefSet = false;
+}
+
+void LogIndex::clearColumns()
+{
+    mTimeMs.clear();
+    mDistGnss.clear();
+    mGnssInd.clear();
+    mGnssEnu.clear();
+    for (auto &ch: mChannels) {
+        ch.clear();
+    }
+    mDayOffset = 0;
+    mTimeFirst = 0;
+    mTimeLast = 0;
+}
+
+void LogIndex::reserve(int size)
+{
+    mTimeMs.reserve(size);
+    mDistGnss.reserve(size);
+    for (auto &ch: mChannels) {
+        ch.reserve(size);
+    }
+}
+
+/**
+ * @brief LogIndex::build
+ * Index data from scratch. An ENU reference set before this call is kept,
+ * otherwise the first valid GNSS sample becomes the reference. All GNSS
+ * positions are converted to ENU in one batch.
+ */
+void LogIndex::build(const QVector<LOG_DATA> &data)
+{
+    clearColumns();
+    reserve(data.size());
+
+    QVector<double> llh;
+    for (const auto &d: data) {
+        if (isGnssValid(d)) {
+            llh.append(d.lat);
+            llh.append(d.lon);
+            llh.append(d.alt);
+        }
+    }
+
+    if (!mEnuRefSet && !llh.isEmpty()) {
+        setEnuRef(llh.constData());
+    }
+
+    QVector<double> enu(llh.size());
+    Utility::llhToEnu(mEnuRef, llh.constData(), enu.data(), llh.size() / 3);
+
+    int gnss = 0;
+    for (const auto &d: data) {
+        if (isGnssValid(d)) {
+            appendSample(d, enu.constData() + 3 * gnss);
+            gnss++;
+        } else {
+            appendSample(d, nullptr);
+        }
+    }
+}
+
+void LogIndex::append(const LOG_DATA &d)
+{
+    if (isGnssValid(d)) {
+        double llh[3] = {d.lat, d.lon, d.alt};
+        double xyz[3];
+
+        if (!mEnuRefSet) {
+            setEnuRef(llh);
+        }
+
+        Utility::llhToEnu(mEnuRef, llh, xyz);
+        appendSample(d, xyz);
+    } else {
+        appendSample(d, nullptr);
+    }
+}
+
+void LogIndex::appendSample(const LOG_DATA &d, const double *enu)
+{
+    qint64 t = qint64(d.valTime) + mDayOffset;
+
+    if (mTimeMs.isEmpty()) {
+        mTimeFirst = t;
+    } else if (t < (mTimeLast - msPerDay / 2)) { // Handle midnight
+        mDayOffset += msPerDay;
+        t += msPerDay;
+    }
+
+    mTimeLast = t;
+    mTimeMs.append(t - mTimeFirst);
+
+    int samples = mTimeMs.size();
+    mChannels[CH_SPEED].append(d.setupValues.speed);
+    mChannels[CH_SPEED_GNSS].append(d.gVel);
+    mChannels[CH_POWER].append(d.setupValues.current_in * d.values.v_in);
+    mChannels[CH_SAMPLE_INTERVAL].append(samples > 1 ?
+                                             double(mTimeMs.at(samples - 1) -
+                                                    mTimeMs.at(samples - 2)) : 0.0);
+
+    double dist = mDistGnss.isEmpty() ? 0.0 : mDistGnss.last();
+
+    if (enu) {
+        int last = mGnssEnu.size() - 3;
+        if (last >= 0) {
+            double dx = enu[0] - mGnssEnu.at(last);
+            double dy = enu[1] - mGnssEnu.at(last + 1);
+            dist += sqrt(dx * dx + dy * dy);
+        }
+
+        mGnssEnu.append(enu[0]);
+        mGnssEnu.append(enu[1]);
+        mGnssEnu.append(enu[2]);
+        mGnssInd.append(mTimeMs.size() - 1);
+    }
+
+    mDistGnss.append(dist);
+}
+
+void LogIndex::setEnuRef(const double *iLlh)
+{
+    mEnuRef[0] = iLlh[0];
+    mEnuRef[1] = iLlh[1];
+    mEnuRef[2] = iLlh[2];
+    mEnuRefSet = true;
+}
+
+bool LogIndex::getEnuRef(double *iLlh) const
+{
+    iLlh[0] = mEnuRef[0];
+    iLlh[1] = mEnuRef[1];
+    iLlh[2] = mEnuRef[2];
+    return mEnuRefSet;
+}
+
+/**
+ * @brief LogIndex::setGnssFilter
+ * Only GNSS samples with a horizontal accuracy better than maxHAcc are
+ * used when enabled. Takes effect for samples added after the call, so
+ * the index has to be rebuilt when the filter changes.
+ */
+void LogIndex::setGnssFilter(bool enabled, double maxHAcc)
+{
+    mFilterEnabled = enabled;
+    mFilterMaxHAcc = maxHAcc;
+}
+
+bool LogIndex::isGnssValid(const LOG_DATA &d) const
+{
+    return d.posTime >= 0 && (!mFilterEnabled || d.hAcc < mFilterMaxHAcc);
+}
+
+int LogIndex::size() const
+{
+    return mTimeMs.size();
+}
+
+/**
+ * @brief LogIndex::timeMs
+ * Milliseconds from the first sample of the log to sample ind.
+ */
+qint64 LogIndex::timeMs(int ind) const
+{
+    if (ind < 0 || ind >= mTimeMs.size()) {
+        return 0;
+    }
+
+    return mTimeMs.at(ind);
+}
+
+qint64 LogIndex::timeMsRange(int start, int ind) const
+{
+    return timeMs(ind) - timeMs(start);
+}
+
+/**
+ * @brief LogIndex::indexAtTime
+ * Binary search for the first sample in [start, end) that is at least
+ * timeMs after sample start.
+ *
+ * @return
+ * The index of the sample, the last sample of the range if timeMs is
+ * beyond it, or -1 if the range is empty.
+ */
+int LogIndex::indexAtTime(qint64 timeMs, int start, int end) const
+{
+    if (end < 0 || end > mTimeMs.size()) {
+        end = mTimeMs.size();
+    }
+
+    if (start < 0) {
+        start = 0;
+    }
+
+    if (start >= end) {
+        return -1;
+    }
+
+    auto first = mTimeMs.constBegin() + start;
+    auto last = mTimeMs.constBegin() + end;
+    auto it = std::lower_bound(first, last, *first + timeMs);
+
+    if (it == last) {
+        return end - 1;
+    }
+
+    return int(it - mTimeMs.constBegin());
+}
+
+int LogIndex::gnssCount() const
+{
+    return mGnssInd.size();
+}
+
+/**
+ * @brief LogIndex::gnssSample
+ * Index of the log sample that GNSS position gnss comes from.
+ */
+int LogIndex::gnssSample(int gnss) const
+{
+    return mGnssInd.at(gnss);
+}
+
+/**
+ * @brief LogIndex::gnssEnu
+ * ENU coordinates of GNSS position gnss, relative to the ENU reference.
+ */
+void LogIndex::gnssEnu(int gnss, double *xyz) const
+{
+    xyz[0] = mGnssEnu.at(3 * gnss);
+    xyz[1] = mGnssEnu.at(3 * gnss + 1);
+    xyz[2] = mGnssEnu.at(3 * gnss + 2);
+}
+
+/**
+ * @brief LogIndex::enuAt
+ * ENU coordinates of sample ind.
+ *
+ * @return
+ * false if sample ind has no valid GNSS position.
+ */
+bool LogIndex::enuAt(int ind, double *xyz) const
+{
+    auto it = std::lower_bound(mGnssInd.constBegin(), mGnssInd.constEnd(), ind);
+    if (it == mGnssInd.constEnd() || *it != ind) {
+        return false;
+    }
+
+    gnssEnu(int(it - mGnssInd.constBegin()), xyz);
+    return true;
+}
+
+/**
+ * @brief LogIndex::distGnss
+ * Cumulative GNSS distance in meters from the start of the log to sample ind.
+ */
+double LogIndex::distGnss(int ind) const
+{
+    if (ind < 0 || ind >= mDistGnss.size()) {
+        return 0.0;
+    }
+
+    return mDistGnss.at(ind);
+}
+
+/**
+ * @brief LogIndex::distGnssRange
+ * GNSS distance in meters from the first valid GNSS sample at or after
+ * start to sample ind.
+ */
+double LogIndex::distGnssRange(int start, int ind) const
+{
+    if (ind < start) {
+        return 0.0;
+    }
+
+    auto it = std::lower_bound(mGnssInd.constBegin(), mGnssInd.constEnd(), start);
+    if (it == mGnssInd.constEnd() || *it > ind) {
+        return 0.0;
+    }
+
+    return distGnss(ind) - distGnss(*it);
+}
+
+/**
+ * @brief LogIndex::rangeMin
+ * Smallest value of channel ch over the samples in [start, end).
+ *
+ * CH_SAMPLE_INTERVAL holds the time in milliseconds since the previous
+ * sample, so queries on it should start at the second sample of a range.
+ */
+double LogIndex::rangeMin(Channel ch, int start, int end) const
+{
+    return mChannels[ch].min(start, end);
+}
+
+double LogIndex::rangeMax(Channel ch, int start, int end) const
+{
+    return mChannels[ch].max(start, end);
+}
+
+double LogIndex::rangeSum(Channel ch, int start, int end) const
+{
+    return mChannels[ch].sum(start, end);
+}
+
+double LogIndex::rangeAvg(Channel ch, int start, int end) const
+{
+    start = std::max(start, 0);
+    end = std::min(end, size());
+
+    if (start >= end) {
+        return 0.0;
+    }
+
+    return mChannels[ch].sum(start, end) / double(end - start);
+}
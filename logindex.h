@@ -0,0 +1,124 @@
+/*
+    Copyright 2020 Benjamin Vedder	benjamin@vedder.se
+
+    This file is part of VESC Tool.
+
+    VESC Tool is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    VESC Tool is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOGINDEX_H
+#define LOGINDEX_H
+
+#include <QVector>
+#include "datatypes.h"
+
+/*
+ * Min/max segment tree with prefix sums over a growing column of values.
+ * Appending is amortized O(log n) and every range query is O(log n).
+ */
+class LogRangeTree
+{
+public:
+    LogRangeTree();
+
+    void clear();
+    void reserve(int size);
+    void append(double value);
+
+    int size() const;
+    double min(int start, int end) const;
+    double max(int start, int end) const;
+    double sum(int start, int end) const;
+
+private:
+    int mSize;
+    int mCapacity;
+    QVector<double> mMin;
+    QVector<double> mMax;
+    QVector<double> mSum;
+
+    void grow(int capacity);
+
+};
+
+/*
+ * Columns derived from a realtime log once, so that lookups by time and
+ * GNSS distances over any sample range do not have to rescan the log. The
+ * ENU track of all valid GNSS samples is kept as well.
+ *
+ * Time is unwrapped at midnight when samples are added, so timeMs() is
+ * monotonic for the whole log.
+ */
+class LogIndex
+{
+public:
+    enum Channel {
+        CH_SPEED = 0,
+        CH_SPEED_GNSS,
+        CH_POWER,
+        CH_SAMPLE_INTERVAL,
+        CH_COUNT
+    };
+
+    LogIndex();
+
+    void clear();
+    void reserve(int size);
+    void build(const QVector<LOG_DATA> &data);
+    void append(const LOG_DATA &d);
+
+    void setEnuRef(const double *iLlh);
+    bool getEnuRef(double *iLlh) const;
+    void setGnssFilter(bool enabled, double maxHAcc);
+    bool isGnssValid(const LOG_DATA &d) const;
+
+    int size() const;
+    qint64 timeMs(int ind) const;
+    qint64 timeMsRange(int start, int ind) const;
+    int indexAtTime(qint64 timeMs, int start = 0, int end = -1) const;
+    int gnssCount() const;
+    int gnssSample(int gnss) const;
+    void gnssEnu(int gnss, double *xyz) const;
+    bool enuAt(int ind, double *xyz) const;
+    double distGnss(int ind) const;
+    double distGnssRange(int start, int ind) const;
+
+    double rangeMin(Channel ch, int start, int end) const;
+    double rangeMax(Channel ch, int start, int end) const;
+    double rangeSum(Channel ch, int start, int end) const;
+    double rangeAvg(Channel ch, int start, int end) const;
+
+private:
+    QVector<qint64> mTimeMs;
+    QVector<double> mDistGnss;
+    QVector<int> mGnssInd;
+    QVector<double> mGnssEnu;
+    LogRangeTree mChannels[CH_COUNT];
+
+    qint64 mDayOffset;
+    qint64 mTimeFirst;
+    qint64 mTimeLast;
+
+    double mEnuRef[3];
+    bool mEnuRefSet;
+
+    bool mFilterEnabled;
+    double mFilterMaxHAcc;
+
+    void clearColumns();
+    void appendSample(const LOG_DATA &d, const double *enu);
+
+};
+
+#endif // LOGINDEX_H
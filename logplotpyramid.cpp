@@ -0,0 +1,257 @@
+/*
+    Copyright 2020 Benjamin Vedder	benjamin@vedder.se
+
+    This file is part of VESC Tool.
+
+    VESC Tool is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    VESC Tool is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+    */
+
+#include "logplotpyramid.h"
+#include <algorithm>
+
+namespace {
+const int bucketFirst = 16;
+const int bucketFactor = 4;
+const int bucketsMin = 16;
+}
+
+LogPlotPyramid::LogPlotPyramid()
+{
+    clear();
+}
+
+void LogPlotPyramid::clear()
+{
+    mSize = 0;
+    mLevels = 0;
+    mChannels.clear();
+    mOrigins.clear();
+}
+
+/**
+ * @brief LogPlotPyramid::build
+ * Build all levels for the given channels. Only uses its arguments, so it
+ * can run in a worker thread on a copy of the log.
+ *
+ * @param data
+ * The log samples.
+ *
+ * @param channels
+ * Channel IDs to build levels for, passed on to value.
+ *
+ * @param value
+ * Function that returns the value of a channel for a sample.
+ */
+void LogPlotPyramid::build(const QVector<LOG_DATA> &data, const QVector<int> &channels,
+                           ValueFunc value)
+{
+    clear();
+    mSize = data.size();
+    mLevels = levelsForSize(mSize);
+
+    for (int ch: channels) {
+        // The first level is kept also when it is too small to be used,
+        // so that later levels can be built from it when appending.
+        QVector<Level> levels(std::max(mLevels, 1));
+
+        Level &first = levels[0];
+        double origin = mSize > 0 ? value(ch, data.at(0)) : 0.0;
+        int buckets = (mSize + bucketFirst - 1) / bucketFirst;
+        first.min.reserve(buckets);
+        first.max.reserve(buckets);
+
+        for (int i = 0;i < mSize;i += bucketFirst) {
+            int end = std::min(i + bucketFirst, mSize);
+            double min = value(ch, data.at(i));
+            double max = min;
+
+            for (int j = i + 1;j < end;j++) {
+                double v = value(ch, data.at(j));
+                min = std::min(min, v);
+                max = std::max(max, v);
+            }
+
+            first.min.append(float(min - origin));
+            first.max.append(float(max - origin));
+        }
+
+        for (int l = 1;l < mLevels;l++) {
+            buildLevel(levels.at(l - 1), levels[l]);
+        }
+
+        mChannels.insert(ch, levels);
+        mOrigins.insert(ch, origin);
+    }
+}
+
+/**
+ * @brief LogPlotPyramid::append
+ * Add one sample to the end of all channels, e.g. while a log is being
+ * recorded. Only the last bucket of every level is touched, and levels
+ * are added as the log grows.
+ */
+void LogPlotPyramid::append(const LOG_DATA &d, ValueFunc value)
+{
+    int ind = mSize;
+    mSize++;
+    int levels = levelsForSize(mSize);
+
+    for (auto it = mChannels.begin();it != mChannels.end();++it) {
+        QVector<Level> &chLevels = it.value();
+        double val = value(it.key(), d);
+
+        // Channels built from an empty log start at their first sample
+        if (ind == 0) {
+            mOrigins.insert(it.key(), val);
+        }
+
+        float v = float(val - mOrigins.value(it.key()));
+
+        for (int l = 0;l < chLevels.size();l++) {
+            Level &level = chLevels[l];
+            int bucket = ind / bucketSize(l);
+
+            if (bucket < level.min.size()) {
+                level.min[bucket] = std::min(level.min.at(bucket), v);
+                level.max[bucket] = std::max(level.max.at(bucket), v);
+            } else {
+                level.min.append(v);
+                level.max.append(v);
+            }
+        }
+
+        while (chLevels.size() < levels) {
+            Level level;
+            buildLevel(chLevels.last(), level);
+            chLevels.append(level);
+        }
+    }
+
+    mLevels = levels;
+}
+
+bool LogPlotPyramid::isEmpty() const
+{
+    return mLevels == 0;
+}
+
+int LogPlotPyramid::size() const
+{
+    return mSize;
+}
+
+int LogPlotPyramid::levelCount() const
+{
+    return mLevels;
+}
+
+/**
+ * @brief LogPlotPyramid::bucketSize
+ * Number of samples in each bucket of level. The last bucket of a level
+ * can be shorter.
+ */
+int LogPlotPyramid::bucketSize(int level) const
+{
+    int size = bucketFirst;
+    for (int i = 0;i < level;i++) {
+        size *= bucketFactor;
+    }
+    return size;
+}
+
+/**
+ * @brief LogPlotPyramid::levelFor
+ * Find the coarsest level that still has at least one bucket per pixel.
+ *
+ * @param samples
+ * Number of samples in the visible range.
+ *
+ * @param pixels
+ * Width of the plot in pixels.
+ *
+ * @return
+ * The level, or -1 if the samples should be plotted at full resolution.
+ */
+int LogPlotPyramid::levelFor(int samples, int pixels) const
+{
+    int res = -1;
+
+    if (pixels <= 0) {
+        return res;
+    }
+
+    for (int l = 0;l < mLevels;l++) {
+        if (samples / bucketSize(l) < pixels) {
+            break;
+        }
+        res = l;
+    }
+
+    return res;
+}
+
+bool LogPlotPyramid::bucketMinMax(int channel, int level, int bucket,
+                                  double &min, double &max) const
+{
+    auto it = mChannels.constFind(channel);
+    if (it == mChannels.constEnd() || level < 0 || level >= mLevels) {
+        return false;
+    }
+
+    const Level &l = it.value().at(level);
+    if (bucket < 0 || bucket >= l.min.size()) {
+        return false;
+    }
+
+    double origin = mOrigins.value(channel);
+    min = origin + double(l.min.at(bucket));
+    max = origin + double(l.max.at(bucket));
+    return true;
+}
+
+int LogPlotPyramid::levelsForSize(int size)
+{
+    int levels = 0;
+    int bucket = bucketFirst;
+
+    while (size / bucket >= bucketsMin) {
+        levels++;
+        bucket *= bucketFactor;
+    }
+
+    return levels;
+}
+
+void LogPlotPyramid::buildLevel(const Level &prev, Level &level)
+{
+    int prevSize = prev.min.size();
+    level.min.clear();
+    level.max.clear();
+    level.min.reserve((prevSize + bucketFactor - 1) / bucketFactor);
+    level.max.reserve((prevSize + bucketFactor - 1) / bucketFactor);
+
+    for (int i = 0;i < prevSize;i += bucketFactor) {
+        int end = std::min(i + bucketFactor, prevSize);
+        float min = prev.min.at(i);
+        float max = prev.max.at(i);
+
+        for (int j = i + 1;j < end;j++) {
+            min = std::min(min, prev.min.at(j));
+            max = std::max(max, prev.max.at(j));
+        }
+
+        level.min.append(min);
+        level.max.append(max);
+    }
+}
@@ -0,0 +1,75 @@
+/*
+    Copyright 2020 Benjamin Vedder	benjamin@vedder.se
+
+    This file is part of VESC Tool.
+
+    VESC Tool is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    VESC Tool is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOGPLOTPYRAMID_H
+#define LOGPLOTPYRAMID_H
+
+#include <QVector>
+#include <QHash>
+#include "datatypes.h"
+
+/*
+ * Min/max buckets of log channels at several resolutions, used to plot
+ * long logs with about one bucket per pixel instead of every sample.
+ *
+ * Level 0 has buckets of 16 samples and every following level is 4 times
+ * coarser. Finer resolutions are cheap to compute from the samples
+ * directly, so they are not stored.
+ *
+ * The buckets are stored as floats relative to the first value of each
+ * channel, so that channels with large values and small changes, such as
+ * positions and timestamps, keep their precision.
+ */
+class LogPlotPyramid
+{
+public:
+    typedef double (*ValueFunc)(int channel, const LOG_DATA &d);
+
+    LogPlotPyramid();
+
+    void clear();
+    void build(const QVector<LOG_DATA> &data, const QVector<int> &channels,
+               ValueFunc value);
+    void append(const LOG_DATA &d, ValueFunc value);
+
+    bool isEmpty() const;
+    int size() const;
+    int levelCount() const;
+    int bucketSize(int level) const;
+    int levelFor(int samples, int pixels) const;
+    bool bucketMinMax(int channel, int level, int bucket,
+                      double &min, double &max) const;
+
+private:
+    struct Level {
+        QVector<float> min;
+        QVector<float> max;
+    };
+
+    int mSize;
+    int mLevels;
+    QHash<int, QVector<Level> > mChannels;
+    QHash<int, double> mOrigins;
+
+    static int levelsForSize(int size);
+    static void buildLevel(const Level &prev, Level &level);
+
+};
+
+#endif // LOGPLOTPYRAMID_H
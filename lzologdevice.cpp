@@ -0,0 +1,302 @@
+/*
+    Copyright 2020 Benjamin Vedder	benjamin@vedder.se
+
+    This file is part of VESC Tool.
+
+    VESC Tool is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    VESC Tool is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+    */
+
+#include "lzologdevice.h"
+#include "vbytearray.h"
+#include <QtConcurrent>
+#include <QDebug>
+
+namespace {
+const char magic[] = "VLZ1";
+const int magicLen = 4;
+const int headerLen = 8;
+const int blockSizeDefault = 32 * 1024;
+const quint32 blockSizeMax = 16 * 1024 * 1024;
+}
+
+LzoLogDevice::LzoLogDevice(QIODevice *target, QObject *parent) : QIODevice(parent)
+{
+    mTarget = target;
+    mBlockSize = blockSizeDefault;
+    mBlockFailed = false;
+}
+
+LzoLogDevice::~LzoLogDevice()
+{
+    close();
+}
+
+/**
+ * @brief LzoLogDevice::open
+ * Open for writing and write the file magic to the target device, which
+ * has to be open for writing already.
+ */
+bool LzoLogDevice::open(QIODevice::OpenMode mode)
+{
+    if ((mode & QIODevice::ReadOnly) || !(mode & QIODevice::WriteOnly) ||
+            !mTarget || !mTarget->isWritable()) {
+        return false;
+    }
+
+    mBuffer.clear();
+    mBuffer.reserve(mBlockSize + 1024);
+    mBlockFailed = false;
+
+    if (mTarget->write(magic, magicLen) != magicLen) {
+        return false;
+    }
+
+    return QIODevice::open(mode & ~QIODevice::Text);
+}
+
+/**
+ * @brief LzoLogDevice::close
+ * Compress and write the remaining data. The target device is not closed.
+ */
+void LzoLogDevice::close()
+{
+    if (!isOpen()) {
+        return;
+    }
+
+    if (!mBuffer.isEmpty()) {
+        writeBlock(mBuffer.size());
+    }
+
+    QIODevice::close();
+}
+
+bool LzoLogDevice::isSequential() const
+{
+    return true;
+}
+
+void LzoLogDevice::setBlockSize(int size)
+{
+    mBlockSize = qBound(1024, size, int(blockSizeMax));
+}
+
+int LzoLogDevice::blockSize() const
+{
+    return mBlockSize;
+}
+
+QString LzoLogDevice::fileSuffix()
+{
+    return "csvlz";
+}
+
+/**
+ * @brief LzoLogDevice::isCompressed
+ * Check if dev starts with the magic of this format, without consuming it.
+ */
+bool LzoLogDevice::isCompressed(QIODevice *dev)
+{
+    return dev->peek(magicLen) == QByteArray(magic, magicLen);
+}
+
+/**
+ * @brief LzoLogDevice::readBlockIndex
+ * Find the blocks in dev by reading only their headers, so that single
+ * blocks can be read and decompressed later. dev has to be seekable.
+ *
+ * @return
+ * false if dev is not in this format or truncated. The blocks before the
+ * truncation are still returned.
+ */
+bool LzoLogDevice::readBlockIndex(QIODevice *dev, QVector<Block> &blocks)
+{
+    blocks.clear();
+
+    if (!dev->seek(0) || dev->read(magicLen) != QByteArray(magic, magicLen)) {
+        return false;
+    }
+
+    qint64 pos = magicLen;
+
+    while (pos < dev->size()) {
+        VByteArray header = dev->read(headerLen);
+        if (header.size() != headerLen) {
+            return false;
+        }
+
+        Block b;
+        b.rawSize = header.vbPopFrontUint32();
+        b.compSize = header.vbPopFrontUint32();
+        b.offset = pos + headerLen;
+
+        if (b.rawSize > blockSizeMax ||
+                b.offset + qint64(b.compSize) > dev->size()) {
+            return false;
+        }
+
+        blocks.append(b);
+        pos = b.offset + b.compSize;
+
+        if (!dev->seek(pos)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool LzoLogDevice::readBlock(QIODevice *dev, const Block &block, QByteArray &compressed)
+{
+    if (!dev->seek(block.offset)) {
+        return false;
+    }
+
+    compressed = dev->read(block.compSize);
+    return compressed.size() == int(block.compSize);
+}
+
+bool LzoLogDevice::decompressBlock(const QByteArray &compressed, quint32 rawSize, QByteArray &out)
+{
+    out.resize(int(rawSize));
+    std::size_t outLen = 0;
+
+    lzokay::EResult error = lzokay::decompress((const uint8_t*)compressed.constData(),
+                                               compressed.size(), (uint8_t*)out.data(),
+                                               rawSize, outLen);
+
+    if (error != lzokay::EResult::Success || outLen != rawSize) {
+        out.clear();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief LzoLogDevice::decompressAll
+ * Read all blocks of dev and decompress them in parallel.
+ *
+ * @return
+ * true if all blocks could be decompressed. Otherwise out contains the
+ * data up to the first broken block, e.g. when the log was not closed.
+ */
+bool LzoLogDevice::decompressAll(QIODevice *dev, QByteArray &out)
+{
+    out.clear();
+
+    QVector<Block> blocks;
+    bool res = readBlockIndex(dev, blocks);
+
+    QList<QPair<QByteArray, quint32> > compressed;
+    for (const auto &b: blocks) {
+        QByteArray data;
+        if (!readBlock(dev, b, data)) {
+            res = false;
+            break;
+        }
+        compressed.append(qMakePair(data, b.rawSize));
+    }
+
+    QList<QByteArray> decompressed = QtConcurrent::blockingMapped<QList<QByteArray> >(compressed,
+                                                                  [](const QPair<QByteArray, quint32> &b) {
+        QByteArray data;
+        decompressBlock(b.first, b.second, data);
+        return data;
+    });
+
+    qint64 size = 0;
+    for (const auto &b: blocks) {
+        size += b.rawSize;
+    }
+    out.reserve(int(size));
+
+    for (int i = 0;i < decompressed.size();i++) {
+        if (decompressed.at(i).size() != int(compressed.at(i).second)) {
+            qWarning() << "Could not decompress log block" << i;
+            res = false;
+            break;
+        }
+
+        out.append(decompressed.at(i));
+    }
+
+    return res;
+}
+
+qint64 LzoLogDevice::readData(char *data, qint64 maxSize)
+{
+    (void)data;
+    (void)maxSize;
+    return -1;
+}
+
+qint64 LzoLogDevice::writeData(const char *data, qint64 maxSize)
+{
+    if (mBlockFailed) {
+        return -1;
+    }
+
+    mBuffer.append(data, int(maxSize));
+
+    while (mBuffer.size() >= mBlockSize) {
+        // End the block after the last complete line that fits
+        int end = mBuffer.lastIndexOf('\n', mBlockSize - 1);
+        if (end < 0) {
+            end = mBuffer.indexOf('\n', mBlockSize);
+        }
+
+        if (end < 0) {
+            if (quint32(mBuffer.size()) < blockSizeMax) {
+                break;
+            }
+            end = int(blockSizeMax) - 1;
+        }
+
+        if (!writeBlock(end + 1)) {
+            return -1;
+        }
+    }
+
+    return maxSize;
+}
+
+bool LzoLogDevice::writeBlock(int size)
+{
+    std::size_t outMaxSize = lzokay::compress_worst_size(std::size_t(size));
+    QByteArray out(int(outMaxSize), Qt::Uninitialized);
+    std::size_t outLen = 0;
+
+    lzokay::EResult error = lzokay::compress((const uint8_t*)mBuffer.constData(), std::size_t(size),
+                                             (uint8_t*)out.data(), outMaxSize, outLen, mDict);
+
+    if (error != lzokay::EResult::Success) {
+        qWarning() << "Could not compress log block.";
+        mBlockFailed = true;
+        return false;
+    }
+
+    VByteArray header;
+    header.vbAppendUint32(quint32(size));
+    header.vbAppendUint32(quint32(outLen));
+
+    if (mTarget->write(header) != header.size() ||
+            mTarget->write(out.constData(), qint64(outLen)) != qint64(outLen)) {
+        mBlockFailed = true;
+        return false;
+    }
+
+    mBuffer.remove(0, size);
+    return true;
+}
@@ -0,0 +1,79 @@
+/*
+    Copyright 2020 Benjamin Vedder	benjamin@vedder.se
+
+    This file is part of VESC Tool.
+
+    VESC Tool is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    VESC Tool is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+    */
+
+#ifndef LZOLOGDEVICE_H
+#define LZOLOGDEVICE_H
+
+#include <QIODevice>
+#include <QByteArray>
+#include <QVector>
+#include "lzokay/lzokay.hpp"
+
+/*
+ * Write-only device that stores text in independently LZO-compressed
+ * blocks on another device. Blocks always end at a line break, so every
+ * block can be decompressed and parsed on its own.
+ *
+ * File layout: the magic "VLZ1", then for every block the uncompressed and
+ * the compressed size as big-endian uint32 followed by the compressed data.
+ */
+class LzoLogDevice : public QIODevice
+{
+    Q_OBJECT
+
+public:
+    struct Block {
+        qint64 offset;
+        quint32 rawSize;
+        quint32 compSize;
+    };
+
+    explicit LzoLogDevice(QIODevice *target, QObject *parent = nullptr);
+    ~LzoLogDevice() override;
+
+    bool open(OpenMode mode) override;
+    void close() override;
+    bool isSequential() const override;
+
+    void setBlockSize(int size);
+    int blockSize() const;
+
+    static QString fileSuffix();
+    static bool isCompressed(QIODevice *dev);
+    static bool readBlockIndex(QIODevice *dev, QVector<Block> &blocks);
+    static bool readBlock(QIODevice *dev, const Block &block, QByteArray &compressed);
+    static bool decompressBlock(const QByteArray &compressed, quint32 rawSize, QByteArray &out);
+    static bool decompressAll(QIODevice *dev, QByteArray &out);
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 maxSize) override;
+
+private:
+    QIODevice *mTarget;
+    QByteArray mBuffer;
+    int mBlockSize;
+    bool mBlockFailed;
+    lzokay::Dict<> mDict;
+
+    bool writeBlock(int size);
+
+};
+
+#endif // LZOLOGDEVICE_H
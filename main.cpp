@@ -19,6 +19,8 @@
 
 #include "mainwindow.h"
 #include "mobile/qmlui.h"
+#include "clitool.h"
+#include "eventtrace.h"
 
 #include <QApplication>
 #include <QStyleFactory>
@@ -33,6 +35,12 @@ int main(int argc, char *argv[])
     QCoreApplication::setOrganizationDomain("openroad-project.com");
     QCoreApplication::setApplicationName("VESC Tool");
 
+    // Command line mode, without any GUI. See vesc_tool --cli --help
+    if (CliTool::isCliArgs(argc, argv)) {
+        QCoreApplication a(argc, argv);
+        return CliTool::run(a.arguments());
+    }
+
     // DPI settings
     // TODO: http://www.qcustomplot.com/index.php/support/forum/1344
 
@@ -89,7 +97,14 @@ int main(int argc, char *argv[])
     }
 #endif
 
-    QApplication a(argc, argv);
+    // Traces the dispatch of every event while tracing is enabled. With
+    // VESC_TOOL_TRACE=<file.json> tracing starts right away and the trace is
+    // written to that file on exit.
+    EventTraceApplication<QApplication> a(argc, argv);
+    QString traceFile = QString::fromLocal8Bit(qgetenv("VESC_TOOL_TRACE"));
+    if (!traceFile.isEmpty()) {
+        EventTrace::setEnabled(true);
+    }
 
     // Fonts
     QFontDatabase::addApplicationFont("://res/fonts/DejaVuSans.ttf");
@@ -125,5 +140,12 @@ int main(int argc, char *argv[])
     w.show();
 #endif
 
-    return a.exec();
+    int res = a.exec();
+
+    if (!traceFile.isEmpty()) {
+        EventTrace::setEnabled(false);
+        EventTrace::exportChromeJson(traceFile);
+    }
+
+    return res;
 }
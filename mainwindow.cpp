@@ -31,6 +31,8 @@
 #include "startupwizard.h"
 #include "widgets/helpdialog.h"
 #include "utility.h"
+#include "utilityapp.h"
+#include "eventtrace.h"
 #include "widgets/paramdialog.h"
 #include "widgets/detectallfocdialog.h"
 
@@ -95,6 +97,12 @@ MainWindow::MainWindow(QWidget *parent) :
 {
     ui->setupUi(this);
 
+    {
+        // Tracing can already be on, see main.cpp
+        QSignalBlocker blocker(ui->actionRecordEventTrace);
+        ui->actionRecordEventTrace->setChecked(EventTrace::isEnabled());
+    }
+
     mVersion = QString::number(VT_VERSION, 'f', 2);
     mOpenroad = new OpenroadInterface(this);
     mStatusInfoTime = 0;
@@ -114,10 +122,14 @@ MainWindow::MainWindow(QWidget *parent) :
             this, SLOT(serialPortNotWritable(QString)));
     connect(mOpenroad->commands(), SIGNAL(valuesReceived(MC_VALUES,unsigned int)),
             this, SLOT(valuesReceived(MC_VALUES,unsigned int)));
+    mOpenroad->commands()->subscribeValues(this, Commands::VALUES_CURRENT_MOTOR |
+                                           Commands::VALUES_DUTY_NOW);
     connect(mOpenroad->commands(), SIGNAL(mcConfigCheckResult(QStringList)),
             this, SLOT(mcConfigCheckResult(QStringList)));
     connect(mOpenroad->mcConfig(), SIGNAL(paramChangedDouble(QObject*,QString,double)),
             this, SLOT(paramChangedDouble(QObject*,QString,double)));
+    connect(mOpenroad->mcConfig(), SIGNAL(paramsChanged(QObject*,QStringList)),
+            this, SLOT(paramsChanged(QObject*,QStringList)));
     connect(ui->actionAboutQt, SIGNAL(triggered(bool)),
             qApp, SLOT(aboutQt()));
 
@@ -129,7 +141,7 @@ MainWindow::MainWindow(QWidget *parent) :
     // Remove the menu with the option to hide the toolbar
     ui->mainToolBar->setContextMenuPolicy(Qt::PreventContextMenu);
 
-    mOpenroad->fwConfig()->loadParamsXml("://res/config/fw.xml");
+    mOpenroad->fwConfig()->loadParamsCached("://res/config/fw.xml");
     Utility::configLoadLatest(mOpenroad);
 
     QMenu *fwMenu = new QMenu(this);
@@ -183,6 +195,15 @@ MainWindow::MainWindow(QWidget *parent) :
         mAppConfRead = true;
     });
 
+    // Read the configurations again on the next connection, the cached
+    // ones are shown until then.
+    connect(mOpenroad, &OpenroadInterface::portConnectedChanged, [this]() {
+        if (!mOpenroad->isPortConnected()) {
+            mMcConfRead = false;
+            mAppConfRead = false;
+        }
+    });
+
     connect(mOpenroad, &OpenroadInterface::configurationChanged, [this]() {
         qDebug() << "Reloading user interface due to configuration change.";
 
@@ -361,7 +382,7 @@ void MainWindow::timerSlot()
 
     // RT data
     if (ui->actionRtData->isChecked()) {
-        mOpenroad->commands()->getValues();
+        mOpenroad->commands()->getValuesSubscribed();
     }
 
     // APP RT data
@@ -487,7 +508,7 @@ void MainWindow::timerSlot()
 
         has_run_start_checks = true;
         checkUdev();
-        Utility::checkVersion(mOpenroad);
+        UtilityApp::checkVersion(mOpenroad);
     }
 }
 
@@ -595,6 +616,13 @@ void MainWindow::paramChangedDouble(QObject *src, QString name, double newParam)
     }
 }
 
+void MainWindow::paramsChanged(QObject *src, QStringList names)
+{
+    if (names.contains("l_current_max")) {
+        paramChangedDouble(src, "l_current_max", mOpenroad->mcConfig()->getParamDouble("l_current_max"));
+    }
+}
+
 void MainWindow::mcConfigCheckResult(QStringList paramsNotSet)
 {
     if (!paramsNotSet.isEmpty()) {
@@ -776,7 +804,7 @@ void MainWindow::on_actionExit_triggered()
 
 void MainWindow::on_actionAbout_triggered()
 {
-    QMessageBox::about(this, "VESC Tool", Utility::aboutText());
+    QMessageBox::about(this, "VESC Tool", UtilityApp::aboutText());
 }
 
 void MainWindow::on_actionLibrariesUsed_triggered()
@@ -1067,6 +1095,11 @@ void MainWindow::reloadPages()
     ui->pageWidget->addWidget(mPageCanAnalyzer);
     addPageItem(tr("CAN Analyzer"), "://res/icons/can_off.png", "", true);
 
+    mPageLinkDiagnostics = new PageLinkDiagnostics(this);
+    mPageLinkDiagnostics->setOpenroad(mOpenroad);
+    ui->pageWidget->addWidget(mPageLinkDiagnostics);
+    addPageItem(tr("Link Diagnostics"), "://res/icons/Connected-96.png", "", true);
+
     mPageDebugPrint = new PageDebugPrint(this);
     ui->pageWidget->addWidget(mPageDebugPrint);
     addPageItem(tr("Debug Console"), "://res/icons/Bug-96.png", "", true);
@@ -1369,6 +1402,39 @@ void MainWindow::on_actionExportConfigurationParser_triggered()
     Utility::createParamParserC(mOpenroad, path);
 }
 
+void MainWindow::on_actionRecordEventTrace_toggled(bool checked)
+{
+    if (checked) {
+        EventTrace::clear();
+    }
+
+    EventTrace::setEnabled(checked);
+    showStatusInfo(checked ? tr("Recording event trace") :
+                             tr("Event trace recorded, %1 events").arg(EventTrace::count()), true);
+}
+
+void MainWindow::on_actionExportEventTrace_triggered()
+{
+    QString path;
+    path = QFileDialog::getSaveFileName(this,
+                                        tr("Choose where to save the event trace"),
+                                        ".",
+                                        tr("Trace files (*.json)"));
+
+    if (path.isNull()) {
+        return;
+    }
+
+    if (!path.toLower().endsWith(".json")) {
+        path.append(".json");
+    }
+
+    if (!EventTrace::exportChromeJson(path)) {
+        QMessageBox::critical(this, tr("Export Event Trace"),
+                              tr("Could not open\n%1\nfor writing").arg(path));
+    }
+}
+
 void MainWindow::on_actionBackupConfiguration_triggered()
 {
     bool ok;
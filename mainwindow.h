@@ -59,6 +59,7 @@
 #include "pages/pageappimu.h"
 #include "pages/pageloganalysis.h"
 #include "pages/pagecananalyzer.h"
+#include "pages/pagelinkdiagnostics.h"
 
 namespace Ui {
 class MainWindow;
@@ -80,6 +81,7 @@ private slots:
     void serialPortNotWritable(const QString &port);
     void valuesReceived(MC_VALUES values, unsigned int mask);
     void paramChangedDouble(QObject *src, QString name, double newParam);
+    void paramsChanged(QObject *src, QStringList names);
     void mcConfigCheckResult(QStringList paramsNotSet);
 
     void on_actionReconnect_triggered();
@@ -129,6 +131,8 @@ private slots:
     void on_posBox_editingFinished();
     void on_posBox_valueChanged(double arg1);
     void on_actionExportConfigurationParser_triggered();
+    void on_actionRecordEventTrace_toggled(bool checked);
+    void on_actionExportEventTrace_triggered();
     void on_actionBackupConfiguration_triggered();
     void on_actionRestoreConfiguration_triggered();
     void on_actionClearConfigurationBackups_triggered();
@@ -181,6 +185,7 @@ private:
     PageAppImu *mPageAppImu;
     PageLogAnalysis *mPageLogAnalysis;
     PageCanAnalyzer *mPageCanAnalyzer;
+    PageLinkDiagnostics *mPageLinkDiagnostics;
 
     void addPageItem(QString name,
                      QString icon = "",
@@ -26,6 +26,7 @@
 
 #include "mapwidget.h"
 #include "utility.h"
+#include "eventtrace.h"
 
 namespace
 {
@@ -1583,6 +1584,7 @@ void MapWidget::getEnuRef(double *llh)
 
 void MapWidget::paint(QPainter &painter, int width, int height, bool highQuality)
 {
+    VT_TRACE_SCOPE("MapWidget::paint");
     if (highQuality) {
         painter.setRenderHint(QPainter::Antialiasing, true);
         painter.setRenderHint(QPainter::TextAntialiasing, true);
@@ -385,5 +385,11 @@ Item {
                 currentBox.realValue = newParam / 3.0
             }
         }
+
+        onParamsChanged: {
+            if (names.indexOf("l_current_max") >= 0) {
+                currentBox.realValue = mMcConf.getParamDouble("l_current_max") / 3.0
+            }
+        }
     }
 }
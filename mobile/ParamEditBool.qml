@@ -135,5 +135,12 @@ Item {
                 boolSwitch.checked = newParam
             }
         }
+
+        onParamsChanged: {
+            if (src !== editor && names.indexOf(paramName) >= 0) {
+                var newParam = params.getParamBool(paramName)
+                boolSwitch.checked = newParam
+            }
+        }
     }
 }
@@ -196,5 +196,13 @@ Item {
                 percentageBox.value = Math.round((100.0 * newParam) / maxVal)
             }
         }
+
+        onParamsChanged: {
+            if (src !== editor && names.indexOf(paramName) >= 0) {
+                var newParam = params.getParamDouble(paramName)
+                valueBox.realValue = newParam * params.getParamEditorScale(paramName)
+                percentageBox.value = Math.round((100.0 * newParam) / maxVal)
+            }
+        }
     }
 }
@@ -147,5 +147,12 @@ Item {
                 enumBox.currentIndex = newParam
             }
         }
+
+        onParamsChanged: {
+            if (src !== editor && names.indexOf(paramName) >= 0) {
+                var newParam = params.getParamEnum(paramName)
+                enumBox.currentIndex = newParam
+            }
+        }
     }
 }
@@ -208,5 +208,13 @@ Item {
                 percentageBox.value = Math.round((100.0 * newParam) / maxVal)
             }
         }
+
+        onParamsChanged: {
+            if (src !== editor && names.indexOf(paramName) >= 0) {
+                var newParam = params.getParamInt(paramName)
+                valueBox.value = newParam * params.getParamEditorScale(paramName)
+                percentageBox.value = Math.round((100.0 * newParam) / maxVal)
+            }
+        }
     }
 }
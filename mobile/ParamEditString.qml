@@ -146,5 +146,12 @@ Item {
                 stringInput.text = newParam
             }
         }
+
+        onParamsChanged: {
+            if (src !== editor && names.indexOf(paramName) >= 0) {
+                var newParam = params.getParamQString(paramName)
+                stringInput.text = newParam
+            }
+        }
     }
 }
@@ -215,6 +215,10 @@ Item {
         onParamChangedDouble: {
             checkActive()
         }
+
+        onParamsChanged: {
+            checkActive()
+        }
     }
 
     Connections {
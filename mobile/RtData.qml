@@ -33,10 +33,18 @@ Item {
     property int gaugeSize: Math.min(width / 2 - 10,
                                      (height - valMetrics.height * 10) /
                                      (isHorizontal ? 1 : 2) - (isHorizontal ? 30 : 20))
+    property int valuesMask: Commands.VALUES_TEMP_MOS | Commands.VALUES_TEMP_MOTOR |
+                             Commands.VALUES_CURRENT_MOTOR | Commands.VALUES_CURRENT_IN |
+                             Commands.VALUES_DUTY_NOW | Commands.VALUES_RPM |
+                             Commands.VALUES_V_IN | Commands.VALUES_AMP_HOURS |
+                             Commands.VALUES_AMP_HOURS_CHARGED | Commands.VALUES_WATT_HOURS |
+                             Commands.VALUES_WATT_HOURS_CHARGED |
+                             Commands.VALUES_TACHOMETER_ABS | Commands.VALUES_FAULT_CODE
 
     Component.onCompleted: {
         currentGauge.minimumValue = -mMcConf.getParamDouble("l_current_max")
         currentGauge.maximumValue = mMcConf.getParamDouble("l_current_max")
+        mCommands.subscribeValues(rtData, valuesMask)
         mCommands.emitEmptyValues()
     }
 
@@ -151,6 +159,10 @@ Item {
         target: mCommands
 
         onValuesReceived: {
+            if ((mask & valuesMask) !== valuesMask) {
+                return
+            }
+
             currentGauge.value = values.current_motor
             dutyGauge.value = values.duty_now * 100.0
 
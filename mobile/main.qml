@@ -713,13 +713,13 @@ ApplicationWindow {
 
                 if (OpenroadIf.isRtLogOpen()) {
                     interval = 50
-                    mCommands.getValues()
+                    mCommands.getValuesSubscribed()
                     mCommands.getValuesSetup()
                     mCommands.getImuData(0xFFFF)
                 } else {
                     if ((tabBar.currentIndex == 1 && rtSwipeView.currentIndex == 0)) {
                         interval = 50
-                        mCommands.getValues()
+                        mCommands.getValuesSubscribed()
                     }
 
                     if (tabBar.currentIndex == 1 && rtSwipeView.currentIndex == 1) {
@@ -37,7 +37,7 @@ QmlUi::QmlUi(QObject *parent) : QObject(parent)
 bool QmlUi::startQmlUi()
 {
     qmlRegisterSingletonType<OpenroadInterface>("Vedder.openroad.openroadinterface", 1, 0, "OpenroadIf", openroadinterface_singletontype_provider);
-    qmlRegisterSingletonType<Utility>("Vedder.openroad.utility", 1, 0, "Utility", utility_singletontype_provider);
+    qmlRegisterSingletonType<UtilityApp>("Vedder.openroad.utility", 1, 0, "Utility", utility_singletontype_provider);
 #ifdef HAS_BLUETOOTH
     qmlRegisterType<BleUart>("Vedder.openroad.bleuart", 1, 0, "BleUart");
 #endif
@@ -95,7 +95,7 @@ QObject *QmlUi::openroadinterface_singletontype_provider(QQmlEngine *engine, QJS
 
     OpenroadInterface *openroad = new OpenroadInterface();
     mOpenroad = openroad;
-    openroad->fwConfig()->loadParamsXml("://res/config/fw.xml");
+    openroad->fwConfig()->loadParamsCached("://res/config/fw.xml");
     Utility::configLoadLatest(openroad);
 
     return openroad;
@@ -106,7 +106,8 @@ QObject *QmlUi::utility_singletontype_provider(QQmlEngine *engine, QJSEngine *sc
     (void)engine;
     (void)scriptEngine;
 
-    Utility *util = new Utility();
+    // Includes the invokables that are not part of the core library
+    UtilityApp *util = new UtilityApp();
 
     return util;
 }
@@ -24,7 +24,7 @@
 #include <QQmlApplicationEngine>
 
 #include "openroadinterface.h"
-#include "utility.h"
+#include "utilityapp.h"
 
 class QmlUi : public QObject
 {
@@ -18,6 +18,7 @@
     */
 
 #include "packet.h"
+#include "linkmetrics.h"
 #include <cstring>
 #include <QDebug>
 
@@ -64,6 +65,7 @@ Packet::Packet(QObject *parent) : QObject(parent)
     mBytesLeft = 0;
     mBufferLen = mMaxPacketLen + 8;
     mRxBuffer = new unsigned char[mBufferLen];
+    mMetrics = nullptr;
 
     mTimer = new QTimer(this);
     mTimer->setInterval(10);
@@ -107,6 +109,11 @@ void Packet::sendPacket(const QByteArray &data)
     to_send.append((char)(crc & 0xFF));
     to_send.append((char)3);
 
+    if (mMetrics) {
+        mMetrics->packetSent();
+        mMetrics->bytesSent(to_send.size());
+    }
+
     emit dataToSend(to_send);
 }
 
@@ -117,6 +124,16 @@ void Packet::resetState()
     mBytesLeft = 0;
 }
 
+/**
+ * @brief Packet::setMetrics
+ * Report traffic and decoding errors to metrics. Nothing is reported
+ * when metrics is null.
+ */
+void Packet::setMetrics(LinkMetrics *metrics)
+{
+    mMetrics = metrics;
+}
+
 unsigned short Packet::crc16(const unsigned char *buf, unsigned int len)
 {
     unsigned short cksum = 0;
@@ -130,6 +147,10 @@ void Packet::processData(QByteArray data)
 {
     QVector<QByteArray> decodedPackets;
 
+    if (mMetrics) {
+        mMetrics->bytesReceived(data.size());
+    }
+
     for(unsigned char rx_data: data) {
         mRxTimer = mByteTimeout;
 
@@ -176,6 +197,9 @@ void Packet::processData(QByteArray data)
                 mRxReadPtr += res;
             } else if (res == -1) {
                 // Something went wrong. Move pointer forward and try again.
+                if (mMetrics) {
+                    mMetrics->decodeFailed();
+                }
                 mRxReadPtr++;
                 data_len--;
             }
@@ -189,6 +213,9 @@ void Packet::processData(QByteArray data)
     }
 
     for (QByteArray b: decodedPackets) {
+        if (mMetrics) {
+            mMetrics->packetReceived();
+        }
         emit packetReceived(b);
     }
 }
@@ -198,6 +225,11 @@ void Packet::timerSlot()
     if (mRxTimer) {
         mRxTimer--;
     } else {
+        // A partial packet that timed out is dropped
+        if (mMetrics && mRxWritePtr != mRxReadPtr) {
+            mMetrics->resynced();
+        }
+
         mRxReadPtr = 0;
         mRxWritePtr = 0;
         mBytesLeft = 0;
@@ -23,6 +23,8 @@
 #include <QObject>
 #include <QTimer>
 
+class LinkMetrics;
+
 class Packet : public QObject
 {
     Q_OBJECT
@@ -31,6 +33,7 @@ public:
     ~Packet();
     void sendPacket(const QByteArray &data);
     void resetState();
+    void setMetrics(LinkMetrics *metrics);
     static unsigned short crc16(const unsigned char *buf, unsigned int len);
 
 signals:
@@ -53,6 +56,7 @@ private:
     unsigned int mMaxPacketLen;
     unsigned int mBufferLen;
     unsigned char *mRxBuffer;
+    LinkMetrics *mMetrics;
 
     int try_decode_packet(unsigned char *buffer, unsigned int in_len,
                           int *bytes_left, QVector<QByteArray> &decodedPackets);
@@ -60,6 +60,8 @@ void PageAppAdc::setOpenroad(OpenroadInterface *openroad)
                 this, SLOT(paramChangedDouble(QObject*,QString,double)));
         connect(mOpenroad->appConfig(), SIGNAL(paramChangedEnum(QObject*,QString,int)),
                 this, SLOT(paramChangedEnum(QObject*,QString,int)));
+        connect(mOpenroad->appConfig(), SIGNAL(paramsChanged(QObject*,QStringList)),
+                this, SLOT(paramsChanged(QObject*,QStringList)));
 
         paramChangedEnum(nullptr, "app_adc_conf.throttle_exp_mode", 0);
     }
@@ -110,3 +112,12 @@ void PageAppAdc::paramChangedEnum(QObject *src, QString name, int newParam)
         paramChangedDouble(0, "app_adc_conf.throttle_exp", 0.0);
     }
 }
+
+void PageAppAdc::paramsChanged(QObject *src, QStringList names)
+{
+    if (names.contains("app_adc_conf.throttle_exp") ||
+            names.contains("app_adc_conf.throttle_exp_brake") ||
+            names.contains("app_adc_conf.throttle_exp_mode")) {
+        paramChangedDouble(src, "app_adc_conf.throttle_exp", 0.0);
+    }
+}
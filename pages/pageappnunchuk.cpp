@@ -62,6 +62,8 @@ void PageAppNunchuk::setOpenroad(OpenroadInterface *openroad)
                 this, SLOT(paramChangedDouble(QObject*,QString,double)));
         connect(mOpenroad->appConfig(), SIGNAL(paramChangedEnum(QObject*,QString,int)),
                 this, SLOT(paramChangedEnum(QObject*,QString,int)));
+        connect(mOpenroad->appConfig(), SIGNAL(paramsChanged(QObject*,QStringList)),
+                this, SLOT(paramsChanged(QObject*,QStringList)));
 
         paramChangedEnum(nullptr, "app_chuk_conf.throttle_exp_mode", 0);
     }
@@ -118,3 +120,12 @@ void PageAppNunchuk::paramChangedEnum(QObject *src, QString name, int newParam)
         paramChangedDouble(nullptr, "app_chuk_conf.throttle_exp", 0.0);
     }
 }
+
+void PageAppNunchuk::paramsChanged(QObject *src, QStringList names)
+{
+    if (names.contains("app_chuk_conf.throttle_exp") ||
+            names.contains("app_chuk_conf.throttle_exp_brake") ||
+            names.contains("app_chuk_conf.throttle_exp_mode")) {
+        paramChangedDouble(src, "app_chuk_conf.throttle_exp", 0.0);
+    }
+}
@@ -43,6 +43,7 @@ private slots:
     void decodedChukReceived(double value);
     void paramChangedDouble(QObject *src, QString name, double newParam);
     void paramChangedEnum(QObject *src, QString name, int newParam);
+    void paramsChanged(QObject *src, QStringList names);
 
 private:
     Ui::PageAppNunchuk *ui;
@@ -42,6 +42,7 @@ public:
 private slots:
     void paramChangedDouble(QObject *src, QString name, double newParam);
     void paramChangedEnum(QObject *src, QString name, int newParam);
+    void paramsChanged(QObject *src, QStringList names);
 
 private:
     Ui::PageAppPpm *ui;
@@ -52,7 +52,7 @@ void PageAppSettings::setOpenroad(OpenroadInterface *openroad)
 void PageAppSettings::reloadParams()
 {
     if (mOpenroad) {
-        ConfigParam *p = mOpenroad->infoConfig()->getParam("app_setting_description");
+        const ConfigParam *p = mOpenroad->infoConfig()->getParam("app_setting_description");
         if (p != nullptr) {
             ui->textEdit->setHtml(p->description);
         } else {
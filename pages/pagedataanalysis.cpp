@@ -44,7 +44,7 @@ void PageDataAnalysis::setOpenroad(OpenroadInterface *openroad)
     mOpenroad = openroad;
 
     if (mOpenroad) {
-        ConfigParam *p = mOpenroad->infoConfig()->getParam("data_analysis_description");
+        const ConfigParam *p = mOpenroad->infoConfig()->getParam("data_analysis_description");
         if (p != 0) {
             ui->textEdit->setHtml(p->description);
         } else {
@@ -31,6 +31,15 @@
 #include <QSerialPortInfo>
 #endif
 
+namespace {
+// The fields that are sampled while an experiment runs
+const unsigned int valuesMask =
+        Commands::VALUES_CURRENT_IN | Commands::VALUES_CURRENT_MOTOR |
+        Commands::VALUES_V_IN | Commands::VALUES_RPM | Commands::VALUES_TEMP_MOS |
+        Commands::VALUES_TEMP_MOS_123 | Commands::VALUES_TEMP_MOTOR |
+        Commands::VALUES_DUTY_NOW;
+}
+
 PageExperiments::PageExperiments(QWidget *parent) :
     QWidget(parent),
     ui(new Ui::PageExperiments)
@@ -135,15 +144,14 @@ void PageExperiments::setOpenroad(OpenroadInterface *openroad)
 void PageExperiments::stop()
 {
     mOpenroad->commands()->setCurrent(0);
+    mOpenroad->commands()->unsubscribeValues(this);
     mState = EXPERIMENT_OFF;
     ui->progressBar->setValue(100);
 }
 
 void PageExperiments::valuesReceived(MC_VALUES values, unsigned int mask)
 {
-    (void)mask;
-
-    if (mState != EXPERIMENT_OFF) {
+    if (mState != EXPERIMENT_OFF && (mask & valuesMask) == valuesMask) {
 #ifdef HAS_SERIALPORT
         if (mVictronPort->isOpen()) {
             values.current_in = mVictronCurrent;
@@ -184,7 +192,7 @@ void PageExperiments::timerSlot()
 #endif
 
     if (mState != EXPERIMENT_OFF) {
-        mOpenroad->commands()->getValues();
+        mOpenroad->commands()->getValuesSubscribed();
 
         double from = 0.0;
         double to = 0.0;
@@ -231,6 +239,7 @@ void PageExperiments::timerSlot()
         if (progress >= 1.0) {
             mState = EXPERIMENT_OFF;
             mOpenroad->commands()->setCurrent(0);
+            mOpenroad->commands()->unsubscribeValues(this);
         } else {
             ui->progressBar->setValue(progress * 100);
 
@@ -257,6 +266,7 @@ void PageExperiments::timerSlot()
 void PageExperiments::on_dutyRunButton_clicked()
 {
     mState = EXPERIMENT_DUTY;
+    mOpenroad->commands()->subscribeValues(this, valuesMask);
     mExperimentTimer.start();
     resetSamples();
 }
@@ -264,6 +274,7 @@ void PageExperiments::on_dutyRunButton_clicked()
 void PageExperiments::on_currentRunButton_clicked()
 {
     mState = EXPERIMENT_CURRENT;
+    mOpenroad->commands()->subscribeValues(this, valuesMask);
     mExperimentTimer.start();
     resetSamples();
 }
@@ -271,6 +282,7 @@ void PageExperiments::on_currentRunButton_clicked()
 void PageExperiments::on_rpmRunButton_clicked()
 {
     mState = EXPERIMENT_RPM;
+    mOpenroad->commands()->subscribeValues(this, valuesMask);
     mExperimentTimer.start();
     resetSamples();
 }
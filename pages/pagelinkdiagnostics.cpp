@@ -0,0 +1,209 @@
+/*
+    Copyright 2020 Benjamin Vedder	benjamin@vedder.se
+
+    This file is part of VESC Tool.
+
+    VESC Tool is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    VESC Tool is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+    */
+
+#include "pagelinkdiagnostics.h"
+#include "ui_pagelinkdiagnostics.h"
+#include <QFileDialog>
+#include <QMessageBox>
+#include <QSaveFile>
+
+namespace {
+// Sorts numerically, with an empty cell before all numbers
+class NumberItem : public QTableWidgetItem
+{
+public:
+    NumberItem(double value, int decimals) :
+        QTableWidgetItem(QString::number(value, 'f', decimals)), mValue(value) {}
+    NumberItem() : QTableWidgetItem(), mValue(-1.0) {}
+
+    bool operator<(const QTableWidgetItem &other) const override {
+        const NumberItem *o = dynamic_cast<const NumberItem*>(&other);
+        return o ? mValue < o->mValue : QTableWidgetItem::operator<(other);
+    }
+
+private:
+    double mValue;
+};
+}
+
+PageLinkDiagnostics::PageLinkDiagnostics(QWidget *parent) :
+    QWidget(parent),
+    ui(new Ui::PageLinkDiagnostics)
+{
+    ui->setupUi(this);
+    layout()->setContentsMargins(0, 0, 0, 0);
+    ui->commandTable->setColumnWidth(0, 200);
+    mOpenroad = nullptr;
+}
+
+PageLinkDiagnostics::~PageLinkDiagnostics()
+{
+    delete ui;
+}
+
+OpenroadInterface *PageLinkDiagnostics::openroad() const
+{
+    return mOpenroad;
+}
+
+void PageLinkDiagnostics::setOpenroad(OpenroadInterface *openroad)
+{
+    mOpenroad = openroad;
+
+    if (mOpenroad) {
+        connect(mOpenroad->linkMetrics(), SIGNAL(ratesUpdated()),
+                this, SLOT(updateTables()));
+        updateTables();
+    }
+}
+
+void PageLinkDiagnostics::updateTables()
+{
+    // The metrics are collected all the time, the tables are only
+    // filled while the page is shown.
+    if (!mOpenroad || !isVisible()) {
+        return;
+    }
+
+    LinkMetrics *m = mOpenroad->linkMetrics();
+
+    ui->summaryTable->setRowCount(12);
+    setSummaryRow(0, tr("Bytes in"), QString::number(m->getBytesIn()));
+    setSummaryRow(1, tr("Bytes out"), QString::number(m->getBytesOut()));
+    setSummaryRow(2, tr("Bytes in/s"), QString::number(m->getBytesInPerSec(), 'f', 0));
+    setSummaryRow(3, tr("Bytes out/s"), QString::number(m->getBytesOutPerSec(), 'f', 0));
+    setSummaryRow(4, tr("Packets in/s"), QString::number(m->getPacketsInPerSec(), 'f', 1));
+    setSummaryRow(5, tr("Packets out/s"), QString::number(m->getPacketsOutPerSec(), 'f', 1));
+    setSummaryRow(6, tr("Packets in"), QString::number(m->getPacketsIn()));
+    setSummaryRow(7, tr("Packets out"), QString::number(m->getPacketsOut()));
+    setSummaryRow(8, tr("Decode failures"), QString::number(m->getDecodeFailures()));
+    setSummaryRow(9, tr("Resyncs"), QString::number(m->getResyncs()));
+    setSummaryRow(10, tr("TX queue (bytes)"), QString::number(m->getTxQueueDepth()));
+    setSummaryRow(11, tr("TX queue max (bytes)"), QString::number(m->getTxQueueDepthMax()));
+
+    QList<int> ids = m->getCommandIds();
+
+    ui->commandTable->setSortingEnabled(false);
+    ui->commandTable->setRowCount(ids.size());
+
+    for (int row = 0;row < ids.size();row++) {
+        LinkMetrics::CommandStats s = m->getCommandStats(ids.at(row));
+
+        ui->commandTable->setItem(row, 0, new QTableWidgetItem(LinkMetrics::commName(ids.at(row))));
+        ui->commandTable->setItem(row, 1, new NumberItem(double(s.requests), 0));
+        ui->commandTable->setItem(row, 2, new NumberItem(double(s.responses), 0));
+        ui->commandTable->setItem(row, 3, new NumberItem(double(s.dropped), 0));
+
+        if (s.rttCount > 0) {
+            ui->commandTable->setItem(row, 4, new NumberItem(double(s.rttMinUs) / 1000.0, 1));
+            ui->commandTable->setItem(row, 5, new NumberItem(double(s.rttSumUs) /
+                                                             double(s.rttCount) / 1000.0, 1));
+            ui->commandTable->setItem(row, 6, new NumberItem(s.rttPercentileMs(0.5), 1));
+            ui->commandTable->setItem(row, 7, new NumberItem(s.rttPercentileMs(0.95), 1));
+            ui->commandTable->setItem(row, 8, new NumberItem(double(s.rttMaxUs) / 1000.0, 1));
+        } else {
+            for (int col = 4;col < 9;col++) {
+                ui->commandTable->setItem(row, col, new NumberItem());
+            }
+        }
+    }
+
+    ui->commandTable->setSortingEnabled(true);
+}
+
+void PageLinkDiagnostics::on_resetButton_clicked()
+{
+    if (mOpenroad) {
+        mOpenroad->linkMetrics()->reset();
+        updateTables();
+    }
+}
+
+void PageLinkDiagnostics::on_saveButton_clicked()
+{
+    if (!mOpenroad) {
+        return;
+    }
+
+    QString fileName = QFileDialog::getSaveFileName(this,
+                                                    tr("Save Link Metrics"), "",
+                                                    tr("JSON Files (*.json)"));
+
+    if (!fileName.isEmpty()) {
+        if (!fileName.toLower().endsWith(".json")) {
+            fileName.append(".json");
+        }
+
+        QSaveFile file(fileName);
+        if (!file.open(QIODevice::WriteOnly)) {
+            QMessageBox::critical(this, tr("Save Link Metrics"),
+                                  tr("Could not open\n%1\nfor writing").arg(fileName));
+            return;
+        }
+
+        file.write(mOpenroad->linkMetrics()->toJson());
+        file.write("\n");
+        file.commit();
+    }
+}
+
+void PageLinkDiagnostics::on_dumpButton_toggled(bool checked)
+{
+    if (!mOpenroad) {
+        return;
+    }
+
+    LinkMetrics *m = mOpenroad->linkMetrics();
+
+    if (!checked) {
+        m->stopDump();
+        ui->dumpLabel->clear();
+        return;
+    }
+
+    QString fileName = QFileDialog::getSaveFileName(this,
+                                                    tr("Dump Link Metrics"), "",
+                                                    tr("JSON Lines Files (*.jsonl)"),
+                                                    nullptr,
+                                                    QFileDialog::DontConfirmOverwrite);
+
+    if (!fileName.isEmpty() && !fileName.toLower().endsWith(".jsonl")) {
+        fileName.append(".jsonl");
+    }
+
+    if (fileName.isEmpty() || !m->startDump(fileName)) {
+        if (!fileName.isEmpty()) {
+            QMessageBox::critical(this, tr("Dump Link Metrics"),
+                                  tr("Could not open\n%1\nfor writing").arg(fileName));
+        }
+
+        ui->dumpButton->blockSignals(true);
+        ui->dumpButton->setChecked(false);
+        ui->dumpButton->blockSignals(false);
+        return;
+    }
+
+    ui->dumpLabel->setText(tr("Appending to %1").arg(m->getDumpFileName()));
+}
+
+void PageLinkDiagnostics::setSummaryRow(int row, QString name, QString value)
+{
+    ui->summaryTable->setItem(row, 0, new QTableWidgetItem(name));
+    ui->summaryTable->setItem(row, 1, new QTableWidgetItem(value));
+}
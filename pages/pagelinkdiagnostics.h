@@ -0,0 +1,55 @@
+/*
+    Copyright 2020 Benjamin Vedder	benjamin@vedder.se
+
+    This file is part of VESC Tool.
+
+    VESC Tool is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    VESC Tool is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+    */
+
+#ifndef PAGELINKDIAGNOSTICS_H
+#define PAGELINKDIAGNOSTICS_H
+
+#include <QWidget>
+#include "openroadinterface.h"
+
+namespace Ui {
+class PageLinkDiagnostics;
+}
+
+class PageLinkDiagnostics : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit PageLinkDiagnostics(QWidget *parent = nullptr);
+    ~PageLinkDiagnostics();
+
+    OpenroadInterface *openroad() const;
+    void setOpenroad(OpenroadInterface *openroad);
+
+private slots:
+    void updateTables();
+    void on_resetButton_clicked();
+    void on_saveButton_clicked();
+    void on_dumpButton_toggled(bool checked);
+
+private:
+    Ui::PageLinkDiagnostics *ui;
+    OpenroadInterface *mOpenroad;
+
+    void setSummaryRow(int row, QString name, QString value);
+
+};
+
+#endif // PAGELINKDIAGNOSTICS_H
@@ -21,7 +21,186 @@
 #include "pageloganalysis.h"
 #include "ui_pageloganalysis.h"
 #include "utility.h"
+#include "logbatchanalysis.h"
 #include <cmath>
+#include <algorithm>
+#include <QtConcurrent>
+#include <QProgressDialog>
+
+namespace {
+/*
+ * Value of a row in the data table for sample d, without scale. The trip
+ * rows are not relative to the start of the span here, and Trip GNSS
+ * (row 6) comes from the log index as it depends on the outlier filter.
+ */
+double logRowValue(int row, const LOG_DATA &d)
+{
+    switch (row) {
+    case 0: return d.setupValues.speed * 3.6;
+    case 1: return d.gVel * 3.6;
+    case 4: return d.setupValues.tachometer;
+    case 5: return d.setupValues.tachometer_abs;
+    case 7: return d.setupValues.current_motor;
+    case 8: return d.setupValues.current_in;
+    case 9: return d.setupValues.current_in * d.values.v_in;
+    case 10: return d.values.rpm / 1000;
+    case 11: return d.values.duty_now * 100.0;
+    case 12: return double(d.values.fault_code);
+    case 13: return d.values.v_in;
+    case 14: return d.setupValues.battery_level * 100.0;
+    case 15: return d.values.temp_mos;
+    case 16: return d.values.temp_motor;
+    case 17: return d.setupValues.amp_hours;
+    case 18: return d.setupValues.amp_hours_charged;
+    case 19: return d.setupValues.watt_hours;
+    case 20: return d.setupValues.watt_hours_charged;
+    case 21: return d.values.id;
+    case 22: return d.values.iq;
+    case 23: return d.values.vd;
+    case 24: return d.values.vq;
+    case 25: return d.values.temp_mos_1;
+    case 26: return d.values.temp_mos_2;
+    case 27: return d.values.temp_mos_3;
+    case 28: return d.values.position;
+    case 29: return d.alt;
+    case 30: return d.imuValues.roll * 180.0 / M_PI;
+    case 31: return d.imuValues.pitch * 180.0 / M_PI;
+    case 32: return d.imuValues.yaw * 180.0 / M_PI;
+    case 33: return d.imuValues.accX;
+    case 34: return d.imuValues.accY;
+    case 35: return d.imuValues.accZ;
+    case 36: return d.imuValues.gyroX;
+    case 37: return d.imuValues.gyroY;
+    case 38: return d.imuValues.gyroZ;
+    case 39: return d.hAcc;
+    case 40: return d.values.current_motor;
+    case 41: return d.values.current_in;
+    case 42: return d.values.current_in * d.values.v_in;
+    case 43: return d.values.amp_hours;
+    case 44: return d.values.amp_hours_charged;
+    case 45: return d.values.watt_hours;
+    case 46: return d.values.watt_hours_charged;
+    case 47: return d.lat;
+    case 48: return d.lon;
+    case 49: return d.vVel * 3.6;
+    case 50: return d.vAcc;
+    case 51: return double(d.setupValues.num_openroads);
+    default: return 0.0;
+    }
+}
+
+QString logRowName(int row)
+{
+    switch (row) {
+    case 0: return "Speed VESC (km/h * %1)";
+    case 1: return "Speed GNSS (km/h * %1)";
+    case 4: return "Trip VESC (m * %1)";
+    case 5: return "Trip ABS VESC (m * %1)";
+    case 6: return "Trip GNSS (m * %1)";
+    case 7: return "Current Motor (A * %1)";
+    case 8: return "Current Battery (A * %1)";
+    case 9: return "Power (W * %1)";
+    case 10: return "ERPM (1/1000 * %1)";
+    case 11: return "Duty (% * %1)";
+    case 12: return "Fault Code (* %1)";
+    case 13: return "Input Voltage (V * %1)";
+    case 14: return "Input Voltage (% * %1)";
+    case 15: return "Temp MOSFET (°C * %1)";
+    case 16: return "Temp Motor (°C * %1)";
+    case 17: return "Ah Used (Ah * %1)";
+    case 18: return "Ah Charged (Ah * %1)";
+    case 19: return "Wh Used (Wh * %1)";
+    case 20: return "Wh Charged (Wh * %1)";
+    case 21: return "id (A * %1)";
+    case 22: return "iq (A * %1)";
+    case 23: return "vd (V * %1)";
+    case 24: return "vq (A * %1)";
+    case 25: return "Temp MOSFET 1 (°C * %1)";
+    case 26: return "Temp MOSFET 2 (°C * %1)";
+    case 27: return "Temp MOSFET 3 (°C * %1)";
+    case 28: return "Motor Pos (° * %1)";
+    case 29: return "Altitude GNSS (m * %1)";
+    case 30: return "Roll (° * %1)";
+    case 31: return "Pitch (° * %1)";
+    case 32: return "Yaw (° * %1)";
+    case 33: return "Accel X (G * %1)";
+    case 34: return "Accel Y (G * %1)";
+    case 35: return "Accel Z (G * %1)";
+    case 36: return "Gyro X (°/s * %1)";
+    case 37: return "Gyro Y (°/s * %1)";
+    case 38: return "Gyro Z (°/s * %1)";
+    case 39: return "GNSS Accuracy (m * %1)";
+    case 40: return "V1 Current (A * %1)";
+    case 41: return "V1 Current In (A * %1)";
+    case 42: return "Power (W * %1)";
+    case 43: return "V1 Ah Used (Ah * %1)";
+    case 44: return "V1 Ah Charged (Ah * %1)";
+    case 45: return "V1 Wh Used (Wh * %1)";
+    case 46: return "V1 Wh Charged (Wh * %1)";
+    case 47: return "Latitude (° * %1)";
+    case 48: return "Longitude (° * %1)";
+    case 49: return "V. Speed GNSS (km/h * %1)";
+    case 50: return "GNSS V. Accuracy (m * %1)";
+    case 51: return "VESC num (* %1)";
+    default: return "";
+    }
+}
+
+/*
+ * Log list item that sorts on the number in Qt::UserRole + 1 when it has
+ * one, so that e.g. durations and sizes sort by value and not as text.
+ */
+class LogListItem : public QTableWidgetItem
+{
+public:
+    explicit LogListItem(const QString &text = QString()) : QTableWidgetItem(text) {}
+
+    bool operator<(const QTableWidgetItem &other) const override
+    {
+        QVariant a = data(Qt::UserRole + 1);
+        QVariant b = other.data(Qt::UserRole + 1);
+
+        if (a.isValid() && b.isValid()) {
+            return a.toDouble() < b.toDouble();
+        }
+
+        return QTableWidgetItem::operator<(other);
+    }
+};
+
+QPixmap logTrackIcon(const QVector<QPointF> &track, QSize size, QColor color)
+{
+    QPixmap pix(size);
+    pix.fill(Qt::transparent);
+
+    if (track.size() < 2) {
+        return pix;
+    }
+
+    QRectF bounds(track.first(), QSizeF(0, 0));
+    for (const auto &p: track) {
+        bounds |= QRectF(p, QSizeF(0, 0));
+    }
+
+    // Same scale on both axes, and y is north
+    double margin = 2.0;
+    double scale = qMin((size.width() - 2.0 * margin) / qMax(bounds.width(), 1.0),
+                        (size.height() - 2.0 * margin) / qMax(bounds.height(), 1.0));
+
+    QPolygonF poly;
+    for (const auto &p: track) {
+        poly.append(QPointF(size.width() / 2.0 + (p.x() - bounds.center().x()) * scale,
+                            size.height() / 2.0 - (p.y() - bounds.center().y()) * scale));
+    }
+
+    QPainter painter(&pix);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(QPen(color, 1.5));
+    painter.drawPolyline(poly);
+
+    return pix;
+}
+}
 
 PageLogAnalysis::PageLogAnalysis(QWidget *parent) :
     QWidget(parent),
@@ -29,6 +208,10 @@ PageLogAnalysis::PageLogAnalysis(QWidget *parent) :
 {
     ui->setupUi(this);
     mOpenroad = nullptr;
+    mLogTruncStart = 0;
+    mLogTruncEnd = 0;
+    mPlotLevel = -1;
+    mLiveReset = false;
 
     updateTileServers();
 
@@ -64,16 +247,73 @@ PageLogAnalysis::PageLogAnalysis(QWidget *parent) :
     mPlayPosNow = 0.0;
     mPlayTimer->start(100);
 
+    ui->logTable->setColumnWidth(1, 80);
+    ui->logTable->setColumnWidth(2, 80);
+    ui->logTable->setColumnWidth(3, 80);
+    ui->logTable->setColumnWidth(4, 80);
+    ui->logTable->setColumnWidth(5, 90);
+    ui->logTable->sortByColumn(0, Qt::AscendingOrder);
+
+    mLogDirIndex = new LogDirIndex(this);
+    connect(mLogDirIndex, &LogDirIndex::listChanged, [this]() {
+        logListFill();
+    });
+    connect(mLogDirIndex, &LogDirIndex::summaryUpdated, [this](QString fileName) {
+        ui->logTable->setSortingEnabled(false);
+        for (int i = 0;i < ui->logTable->rowCount();i++) {
+            if (ui->logTable->item(i, 0)->text() == fileName) {
+                logListUpdateRow(i);
+                break;
+            }
+        }
+        ui->logTable->setSortingEnabled(true);
+        logListFilter();
+    });
+    connect(mLogDirIndex, &LogDirIndex::indexingFinished, [this]() {
+        ui->logIndexLabel->clear();
+    });
+    connect(ui->logFilterEdit, &QLineEdit::textChanged, [this]() {
+        logListFilter();
+    });
+
+    mPlotPyramidWatcher = new QFutureWatcher<LogPlotPyramid>(this);
+    connect(mPlotPyramidWatcher, &QFutureWatcher<LogPlotPyramid>::finished, [this]() {
+        mPlotPyramid = mPlotPyramidWatcher->result();
+
+        // Samples added in live mode while the pyramid was built
+        for (int i = mPlotPyramid.size();i < mLogData.size();i++) {
+            mPlotPyramid.append(mLogData.at(i), logRowValue);
+        }
+
+        updateGraphs();
+    });
+
+    mLiveTimer = new QTimer(this);
+    mLiveTimer->start(500);
+
+    connect(mLiveTimer, &QTimer::timeout, [this]() {
+        if (mOpenroad && ui->liveBox->isChecked()) {
+            if (mLiveReset) {
+                on_openCurrentButton_clicked();
+            } else if (mOpenroad->getRtLogSize() > mLogData.size()) {
+                appendLogData();
+            }
+        }
+    });
+
+    connect(ui->liveBox, &QCheckBox::toggled, [this](bool checked) {
+        if (checked) {
+            on_openCurrentButton_clicked();
+        }
+    });
+
     connect(mPlayTimer, &QTimer::timeout, [this]() {
         if (ui->playButton->isChecked()) {
             mPlayPosNow += double(mPlayTimer->interval()) / 1000.0;
 
-            int timeMs = mLogDataTruncated.last().valTime - mLogDataTruncated.first().valTime;
-            if (timeMs < 0) { // Handle midnight
-                timeMs += 60 * 60 * 24 * 1000;
-            }
+            qint64 timeMs = mLogIndex.timeMsRange(mLogTruncStart, mLogTruncEnd - 1);
 
-            if (mLogDataTruncated.size() > 0 &&
+            if (mLogTruncEnd > mLogTruncStart &&
                     mPlayPosNow <= double(timeMs) / 1000.0) {
                 updateDataAndPlot(mPlayPosNow);
             } else {
@@ -169,7 +409,7 @@ PageLogAnalysis::PageLogAnalysis(QWidget *parent) :
     mVerticalLine = new QCPCurve(ui->plot->xAxis, ui->plot->yAxis);
     mVerticalLine->removeFromLegend();
     mVerticalLine->setPen(QPen(Qt::black));
-    mVerticalLineMsLast = -1;
+    mVerticalLineIndLast = -1;
 
     auto updateMouse = [this](QMouseEvent *event) {
         if (event->modifiers() == Qt::ShiftModifier) {
@@ -187,7 +427,7 @@ PageLogAnalysis::PageLogAnalysis(QWidget *parent) :
     };
 
     connect(ui->map, &MapWidget::infoPointClicked, [this](LocPoint info) {
-        updateDataAndPlot(double(info.getInfo().toInt() - mLogDataTruncated.first().valTime) / 1000.0);
+        updateDataAndPlot(double(mLogIndex.timeMsRange(mLogTruncStart, info.getInfo().toInt())) / 1000.0);
     });
 
     connect(ui->plot, &QCustomPlot::mousePress, [updateMouse](QMouseEvent *event) {
@@ -236,6 +476,7 @@ PageLogAnalysis::PageLogAnalysis(QWidget *parent) :
     });
 
     connect(ui->filterOutlierBox, &QGroupBox::toggled, [this]() {
+        updateLogIndex();
         truncateDataAndPlot(ui->autoZoomBox->isChecked());
     });
 
@@ -243,6 +484,7 @@ PageLogAnalysis::PageLogAnalysis(QWidget *parent) :
             [this](double newVal) {
         (void)newVal;
         if (ui->filterOutlierBox->isChecked()) {
+            updateLogIndex();
             truncateDataAndPlot(ui->autoZoomBox->isChecked());
         }
     });
@@ -268,6 +510,12 @@ OpenroadInterface *PageLogAnalysis::openroad() const
 void PageLogAnalysis::setOpenroad(OpenroadInterface *openroad)
 {
     mOpenroad = openroad;
+
+    if (mOpenroad) {
+        connect(mOpenroad, &OpenroadInterface::rtLogDataReset, [this]() {
+            mLiveReset = true;
+        });
+    }
 }
 
 void PageLogAnalysis::on_openCsvButton_clicked()
@@ -275,7 +523,7 @@ void PageLogAnalysis::on_openCsvButton_clicked()
     if (mOpenroad) {
         QString fileName = QFileDialog::getOpenFileName(this,
                                                         tr("Load CSV File"), "",
-                                                        tr("CSV files (*.csv)"));
+                                                        tr("CSV files (*.csv *.csvlz)"));
 
         if (!fileName.isEmpty()) {            
             QSettings set;
@@ -295,6 +543,8 @@ void PageLogAnalysis::on_openCurrentButton_clicked()
 {
     if (mOpenroad) {
         mLogData = mOpenroad->getRtLogData();
+        mVerticalLineIndLast = -1;
+        mLiveReset = false;
 
         double i_llh[3];
         for (auto d: mLogData) {
@@ -308,6 +558,8 @@ void PageLogAnalysis::on_openCurrentButton_clicked()
             }
         }
 
+        updateLogIndex();
+        updatePlotPyramid();
         truncateDataAndPlot();
     }
 }
@@ -331,53 +583,217 @@ void PageLogAnalysis::on_tilesOsmButton_toggled(bool checked)
     ui->map->update();
 }
 
-void PageLogAnalysis::truncateDataAndPlot(bool zoomGraph)
+void PageLogAnalysis::updateLogIndex()
 {
-    double start = double(ui->spanSlider->alt_value()) / 10000.0;
-    double end = double(ui->spanSlider->value()) / 10000.0;
-
-    ui->map->setInfoTraceNow(0);
-    ui->map->clearAllInfoTraces();
-
-    int ind = 0;
     double i_llh[3];
-    int posTimeLast = -1;
-
     ui->map->getEnuRef(i_llh);
-    mLogDataTruncated.clear();
 
-    for (auto d: mLogData) {
-        ind++;
-        double prop = double(ind) / double(mLogData.size());
-        if (prop < start || prop > end) {
-            continue;
-        }
+    mLogIndex.clear();
+    mLogIndex.setEnuRef(i_llh);
+    mLogIndex.setGnssFilter(ui->filterOutlierBox->isChecked(),
+                            ui->filterhAccBox->value());
+    mLogIndex.build(mLogData);
+
+    // The map trace for the whole log is built once here, truncating
+    // it to the selected span is then just a range lookup.
+    mLogTrace.clear();
+    mLogTraceInd.clear();
+    extendLogTrace(0);
+}
 
-        mLogDataTruncated.append(d);
+/**
+ * @brief PageLogAnalysis::extendLogTrace
+ * Add the GNSS positions from gnssStart in the log index to the cached
+ * map trace, skipping repeated positions.
+ */
+void PageLogAnalysis::extendLogTrace(int gnssStart)
+{
+    int posTimeLast = -1;
+    if (!mLogTraceInd.isEmpty()) {
+        posTimeLast = mLogData.at(mLogTraceInd.last()).posTime;
+    }
 
-        if (d.posTime >= 0 &&
-                (!ui->filterOutlierBox->isChecked() ||
-                 d.hAcc < ui->filterhAccBox->value()) &&
-                posTimeLast != d.posTime) {
-            double llh[3];
-            double xyz[3];
+    for (int g = gnssStart;g < mLogIndex.gnssCount();g++) {
+        int i = mLogIndex.gnssSample(g);
+        const LOG_DATA &d = mLogData.at(i);
 
-            llh[0] = d.lat;
-            llh[1] = d.lon;
-            llh[2] = d.alt;
-            Utility::llhToEnu(i_llh, llh, xyz);
+        if (posTimeLast != d.posTime) {
+            double xyz[3];
+            mLogIndex.gnssEnu(g, xyz);
 
             LocPoint p;
             p.setXY(xyz[0], xyz[1]);
             p.setRadius(5);
             QString info;
-            info.sprintf("%d", d.valTime);
+            info.sprintf("%d", i);
             p.setInfo(info);
 
-            ui->map->addInfoPoint(p, false);
+            mLogTrace.append(p);
+            mLogTraceInd.append(i);
             posTimeLast = d.posTime;
         }
     }
+}
+
+/**
+ * @brief PageLogAnalysis::appendLogData
+ * Add the samples that were recorded since the log was loaded. Only the
+ * new samples are processed: they are appended to the log index, the plot
+ * pyramid and the map trace, and added to the graphs directly when they
+ * are drawn at full resolution. The statistics come from the log index,
+ * so updating them does not depend on the log length.
+ */
+void PageLogAnalysis::appendLogData()
+{
+    int start = mLogData.size();
+    QVector<LOG_DATA> data = mOpenroad->getRtLogDataSince(start);
+
+    if (data.isEmpty()) {
+        return;
+    }
+
+    // Only follow the new samples if the end of the log is shown
+    bool follow = ui->spanSlider->value() == ui->spanSlider->maximum() &&
+            mLogTruncEnd == start;
+    bool pyramidReady = mPlotPyramid.size() == start;
+    int gnssStart = mLogIndex.gnssCount();
+    int traceStart = mLogTrace.size();
+
+    mLogData.reserve(start + data.size());
+    for (const auto &d: data) {
+        mLogData.append(d);
+        mLogIndex.append(d);
+
+        if (pyramidReady) {
+            mPlotPyramid.append(d, logRowValue);
+        }
+    }
+
+    extendLogTrace(gnssStart);
+
+    if (!follow) {
+        return;
+    }
+
+    mLogTruncEnd = mLogData.size();
+
+    ui->map->setInfoTraceNow(0);
+    for (int i = traceStart;i < mLogTrace.size();i++) {
+        ui->map->addInfoPoint(mLogTrace[i], false);
+    }
+    ui->map->update();
+
+    int level = mPlotPyramid.size() == mLogData.size() ?
+                mPlotPyramid.levelFor(mLogTruncEnd - mLogTruncStart,
+                                      ui->plot->axisRect()->width()) : -1;
+
+    if (level < 0 && mPlotLevel < 0 && ui->plot->graphCount() == mPlotRows.size()) {
+        QCPRange yRange = ui->plot->yAxis->range();
+        double xLast = 0.0;
+
+        for (int i = start;i < mLogTruncEnd;i++) {
+            xLast = double(mLogIndex.timeMsRange(mLogTruncStart, i)) / 1000.0;
+
+            for (int r = 0;r < mPlotRows.size();r++) {
+                double y = plotValue(r, i) * mPlotScales.at(r);
+                ui->plot->graph(r)->addData(xLast, y);
+                yRange.expand(y);
+            }
+        }
+
+        if (xLast > ui->plot->xAxis->range().upper) {
+            ui->plot->xAxis->setRangeUpper(xLast);
+        }
+
+        if (mPlotRows.size() > 0) {
+            ui->plot->yAxis->setRange(yRange);
+        }
+
+        ui->plot->replot();
+    } else {
+        updateGraphs();
+    }
+
+    updateStats();
+}
+
+/**
+ * @brief PageLogAnalysis::plotValue
+ * Unscaled value of plotted graph r at sample ind, relative to the start
+ * of the span for the trip graphs.
+ */
+double PageLogAnalysis::plotValue(int r, int ind)
+{
+    int row = mPlotRows.at(r);
+
+    if (row == 6) {
+        return mLogIndex.distGnssRange(mLogTruncStart, ind);
+    }
+
+    return logRowValue(row, mLogData.at(ind)) - mPlotOffsets.at(r);
+}
+
+/**
+ * @brief PageLogAnalysis::updatePlotPyramid
+ * Build the plot levels for the current log in the background. Until they
+ * are done the graphs are drawn at full resolution.
+ */
+void PageLogAnalysis::updatePlotPyramid()
+{
+    mPlotPyramid.clear();
+
+    QVector<int> rows;
+    for (int row = 0;row < ui->dataTable->rowCount();row++) {
+        if (row != 6 && !logRowName(row).isEmpty()) {
+            rows.append(row);
+        }
+    }
+
+    QVector<LOG_DATA> data = mLogData;
+    mPlotPyramidWatcher->setFuture(QtConcurrent::run([data, rows]() {
+        LogPlotPyramid p;
+        p.build(data, rows, logRowValue);
+        return p;
+    }));
+}
+
+void PageLogAnalysis::truncateDataAndPlot(bool zoomGraph)
+{
+    double start = double(ui->spanSlider->alt_value()) / 10000.0;
+    double end = double(ui->spanSlider->value()) / 10000.0;
+
+    ui->map->setInfoTraceNow(0);
+    ui->map->clearAllInfoTraces();
+
+    // Sample i is in the span when start <= (i + 1) / n <= end
+    int n = mLogData.size();
+    int startInd = qBound(0, int(ceil(start * n)) - 1, n);
+    while (startInd > 0 && double(startInd) / double(n) >= start) {
+        startInd--;
+    }
+    while (startInd < n && double(startInd + 1) / double(n) < start) {
+        startInd++;
+    }
+
+    int endInd = qBound(0, int(floor(end * n)), n);
+    while (endInd < n && double(endInd + 1) / double(n) <= end) {
+        endInd++;
+    }
+    while (endInd > 0 && double(endInd) / double(n) > end) {
+        endInd--;
+    }
+
+    mLogTruncStart = startInd;
+    mLogTruncEnd = qMax(startInd, endInd);
+
+    auto it = std::lower_bound(mLogTraceInd.constBegin(), mLogTraceInd.constEnd(), mLogTruncStart);
+    for (int i = int(it - mLogTraceInd.constBegin());i < mLogTrace.size();i++) {
+        if (mLogTraceInd.at(i) >= mLogTruncEnd) {
+            break;
+        }
+
+        ui->map->addInfoPoint(mLogTrace[i], false);
+    }
 
     if (zoomGraph) {
         ui->map->zoomInOnInfoTrace(-1, 0.1);
@@ -396,327 +812,91 @@ void PageLogAnalysis::updateGraphs()
     QVector<QVector<double> > yAxes;
     QVector<QString> names;
 
-    int startTime = -1;
-    LOG_DATA prevSampleGnss;
-    bool prevSampleGnssSet = false;
-    double metersGnss = 0.0;
+    mPlotRows.clear();
+    mPlotScales.clear();
+    mPlotOffsets.clear();
+
     LOG_DATA firstData;
 
-    if (mLogDataTruncated.size() > 0) {
-        firstData = mLogDataTruncated.first();
+    if (mLogTruncEnd > mLogTruncStart) {
+        firstData = mLogData.at(mLogTruncStart);
     }
 
-    double verticalTime = -1.0;
-    LocPoint p, p2;
-
-    for (LOG_DATA d: mLogDataTruncated) {
-        if (startTime < 0) {
-            startTime = d.valTime;
-        }
-
-        int timeMs = d.valTime - startTime;
-        if (timeMs < 0) { // Handle midnight
-            timeMs += 60 * 60 * 24 * 1000;
+    for (int r = 0;r < rows.size();r++) {
+        int row = rows.at(r).row();
+        QString name = logRowName(row);
+        if (name.isEmpty()) {
+            continue;
         }
 
-        if (mVerticalLineMsLast == d.valTime) {
-            verticalTime = double(timeMs) / 1000.0;
+        double rowScale = 1.0;
+        if(QDoubleSpinBox *sb = qobject_cast<QDoubleSpinBox*>
+                (ui->dataTable->cellWidget(row, 2))) {
+            rowScale = sb->value();
         }
 
-        xAxis.append(double(timeMs) / 1000.0);
-
-        if (d.posTime >= 0 &&
-                (!ui->filterOutlierBox->isChecked() ||
-                 d.hAcc < ui->filterhAccBox->value())) {
-            if (prevSampleGnssSet) {
-                double i_llh[3];
-                double llh[3];
-                double xyz[3];
-                ui->map->getEnuRef(i_llh);
-
-                llh[0] = d.lat;
-                llh[1] = d.lon;
-                llh[2] = d.alt;
-                Utility::llhToEnu(i_llh, llh, xyz);
+        mPlotRows.append(row);
+        mPlotScales.append(rowScale);
+        mPlotOffsets.append((row == 4 || row == 5) ? logRowValue(row, firstData) : 0.0);
+        names.append(name.arg(rowScale));
+        yAxes.append(QVector<double>());
+    }
 
-                p.setXY(xyz[0], xyz[1]);
-                p.setRadius(10);
+    double verticalTime = -1.0;
+    if (mVerticalLineIndLast >= mLogTruncStart && mVerticalLineIndLast < mLogTruncEnd) {
+        verticalTime = double(mLogIndex.timeMsRange(mLogTruncStart, mVerticalLineIndLast)) / 1000.0;
+    }
 
-                llh[0] = prevSampleGnss.lat;
-                llh[1] = prevSampleGnss.lon;
-                llh[2] = prevSampleGnss.alt;
-                Utility::llhToEnu(i_llh, llh, xyz);
+    int samples = mLogTruncEnd - mLogTruncStart;
+    int level = mPlotPyramid.size() == mLogData.size() ?
+                mPlotPyramid.levelFor(samples, ui->plot->axisRect()->width()) : -1;
+    mPlotLevel = level;
 
-                p2.setXY(xyz[0], xyz[1]);
-                p2.setRadius(10);
+    if (level < 0) {
+        for (int i = mLogTruncStart;i < mLogTruncEnd;i++) {
+            xAxis.append(double(mLogIndex.timeMsRange(mLogTruncStart, i)) / 1000.0);
 
-                metersGnss += p.getDistanceTo(p2);
+            for (int r = 0;r < mPlotRows.size();r++) {
+                yAxes[r].append(plotValue(r, i) * mPlotScales.at(r));
             }
-
-            prevSampleGnssSet = true;
-            prevSampleGnss = d;
         }
+    } else {
+        // One min and one max point per bucket. Buckets cut by the span
+        // are computed from the samples.
+        int bSize = mPlotPyramid.bucketSize(level);
+
+        for (int b = mLogTruncStart / bSize;b <= (mLogTruncEnd - 1) / bSize;b++) {
+            int first = qMax(mLogTruncStart, b * bSize);
+            int end = qMin(mLogTruncEnd, (b + 1) * bSize);
+            bool whole = first == b * bSize && end == qMin(mLogData.size(), (b + 1) * bSize);
+
+            xAxis.append(double(mLogIndex.timeMsRange(mLogTruncStart, first)) / 1000.0);
+            xAxis.append(double(mLogIndex.timeMsRange(mLogTruncStart, end - 1)) / 1000.0);
+
+            for (int r = 0;r < mPlotRows.size();r++) {
+                int row = mPlotRows.at(r);
+                double min = 0.0;
+                double max = 0.0;
+
+                if (row == 6) {
+                    // Cumulative, so the ends of the bucket are the extremes
+                    min = plotValue(r, first);
+                    max = plotValue(r, end - 1);
+                } else if (whole && mPlotPyramid.bucketMinMax(row, level, b, min, max)) {
+                    min -= mPlotOffsets.at(r);
+                    max -= mPlotOffsets.at(r);
+                } else {
+                    min = plotValue(r, first);
+                    max = min;
+                    for (int i = first + 1;i < end;i++) {
+                        double v = plotValue(r, i);
+                        min = qMin(min, v);
+                        max = qMax(max, v);
+                    }
+                }
 
-        int rowInd = 0;
-        for (int r = 0;r < rows.size();r++) {
-            int row = rows.at(r).row();
-            double rowScale = 1.0;
-            if(QDoubleSpinBox *sb = qobject_cast<QDoubleSpinBox*>
-                    (ui->dataTable->cellWidget(row, 2))) {
-                rowScale = sb->value();
-            }
-            if (row == 0) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.setupValues.speed * 3.6 * rowScale);
-                names.append(QString("Speed VESC (km/h * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 1) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.gVel * 3.6 * rowScale);
-                names.append(QString("Speed GNSS (km/h * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 4) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append((d.setupValues.tachometer -
-                                      firstData.setupValues.tachometer) * rowScale);
-                names.append(QString("Trip VESC (m * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 5) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append((d.setupValues.tachometer_abs -
-                                      firstData.setupValues.tachometer_abs) * rowScale);
-                names.append(QString("Trip ABS VESC (m * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 6) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(metersGnss * rowScale);
-                names.append(QString("Trip GNSS (m * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 7) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.setupValues.current_motor * rowScale);
-                names.append(QString("Current Motor (A * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 8) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.setupValues.current_in * rowScale);
-                names.append(QString("Current Battery (A * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 9) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.setupValues.current_in * d.values.v_in * rowScale);
-                names.append(QString("Power (W * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 10) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.values.rpm / 1000 * rowScale);
-                names.append(QString("ERPM (1/1000 * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 11) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.values.duty_now * 100.0 * rowScale);
-                names.append(QString("Duty (% * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 12) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(double(d.values.fault_code) * rowScale);
-                names.append(QString("Fault Code (* %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 13) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.values.v_in * rowScale);
-                names.append(QString("Input Voltage (V * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 14) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.setupValues.battery_level * 100.0 * rowScale);
-                names.append(QString("Input Voltage (% * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 15) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.values.temp_mos * rowScale);
-                names.append(QString("Temp MOSFET (°C * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 16) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.values.temp_motor * rowScale);
-                names.append(QString("Temp Motor (°C * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 17) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.setupValues.amp_hours * rowScale);
-                names.append(QString("Ah Used (Ah * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 18) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.setupValues.amp_hours_charged * rowScale);
-                names.append(QString("Ah Charged (Ah * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 19) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.setupValues.watt_hours * rowScale);
-                names.append(QString("Wh Used (Wh * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 20) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.setupValues.watt_hours_charged * rowScale);
-                names.append(QString("Wh Charged (Wh * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 21) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.values.id * rowScale);
-                names.append(QString("id (A * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 22) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.values.iq * rowScale);
-                names.append(QString("iq (A * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 23) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.values.vd * rowScale);
-                names.append(QString("vd (V * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 24) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.values.vq * rowScale);
-                names.append(QString("vq (A * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 25) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.values.temp_mos_1 * rowScale);
-                names.append(QString("Temp MOSFET 1 (°C * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 26) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.values.temp_mos_2 * rowScale);
-                names.append(QString("Temp MOSFET 2 (°C * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 27) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.values.temp_mos_3 * rowScale);
-                names.append(QString("Temp MOSFET 3 (°C * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 28) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.values.position * rowScale);
-                names.append(QString("Motor Pos (° * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 29) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.alt * rowScale);
-                names.append(QString("Altitude GNSS (m * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 30) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.imuValues.roll * 180.0 / M_PI * rowScale);
-                names.append(QString("Roll (° * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 31) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.imuValues.pitch * 180.0 / M_PI * rowScale);
-                names.append(QString("Pitch (° * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 32) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.imuValues.yaw * 180.0 / M_PI * rowScale);
-                names.append(QString("Yaw (° * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 33) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.imuValues.accX * rowScale);
-                names.append(QString("Accel X (G * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 34) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.imuValues.accY * rowScale);
-                names.append(QString("Accel Y (G * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 35) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.imuValues.accZ * rowScale);
-                names.append(QString("Accel Z (G * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 36) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.imuValues.gyroX * rowScale);
-                names.append(QString("Gyro X (°/s * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 37) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.imuValues.gyroY * rowScale);
-                names.append(QString("Gyro Y (°/s * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 38) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.imuValues.gyroZ * rowScale);
-                names.append(QString("Gyro Z (°/s * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 39) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.hAcc * rowScale);
-                names.append(QString("GNSS Accuracy (m * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 40) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.values.current_motor * rowScale);
-                names.append(QString("V1 Current (A * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 41) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.values.current_in * rowScale);
-                names.append(QString("V1 Current In (A * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 42) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.values.current_in * d.values.v_in * rowScale);
-                names.append(QString("Power (W * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 43) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.values.amp_hours * rowScale);
-                names.append(QString("V1 Ah Used (Ah * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 44) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.values.amp_hours_charged * rowScale);
-                names.append(QString("V1 Ah Charged (Ah * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 45) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.values.watt_hours * rowScale);
-                names.append(QString("V1 Wh Used (Wh * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 46) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.values.watt_hours_charged * rowScale);
-                names.append(QString("V1 Wh Charged (Wh * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 47) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.lat * rowScale);
-                names.append(QString("Latitude (° * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 48) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.lon * rowScale);
-                names.append(QString("Longitude (° * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 49) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.vVel * 3.6 * rowScale);
-                names.append(QString("V. Speed GNSS (km/h * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 50) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(d.vAcc * rowScale);
-                names.append(QString("GNSS V. Accuracy (m * %1)").arg(rowScale));
-                rowInd++;
-            } else if (row == 51) {
-                if (yAxes.size() <= rowInd) yAxes.append(QVector<double>());
-                yAxes[rowInd].append(double(d.setupValues.num_openroads) * rowScale);
-                names.append(QString("VESC num (* %1)").arg(rowScale));
-                rowInd++;
+                yAxes[r].append(min * mPlotScales.at(r));
+                yAxes[r].append(max * mPlotScales.at(r));
             }
         }
     }
@@ -766,12 +946,11 @@ void PageLogAnalysis::updateGraphs()
 
 void PageLogAnalysis::updateStats()
 {
-    bool startSampleSet = false;
     LOG_DATA startSample;
     LOG_DATA endSample;
 
-    int samples = 0;
-    int timeTotMs = 0;
+    int samples = mLogTruncEnd - mLogTruncStart;
+    qint64 timeTotMs = 0;
     double meters = 0.0;
     double metersAbs = 0.0;
     double metersGnss = 0.0;
@@ -779,57 +958,27 @@ void PageLogAnalysis::updateStats()
     double whCharge = 0.0;
     double ah = 0.0;
     double ahCharge = 0.0;
-    LOG_DATA prevSampleGnss;
-    bool prevSampleGnssSet = false;
-
-    for (LOG_DATA d: mLogDataTruncated) {
-        if (!startSampleSet) {
-            startSample = d;
-            startSampleSet = true;
-        }
-
-        samples++;
-
-        if (d.posTime >= 0 &&
-                (!ui->filterOutlierBox->isChecked() ||
-                 d.hAcc < ui->filterhAccBox->value())) {
-            if (prevSampleGnssSet) {
-                double i_llh[3];
-                double llh[3];
-                double xyz[3];
-                ui->map->getEnuRef(i_llh);
-
-                llh[0] = d.lat;
-                llh[1] = d.lon;
-                llh[2] = d.alt;
-                Utility::llhToEnu(i_llh, llh, xyz);
-
-                LocPoint p;
-                p.setXY(xyz[0], xyz[1]);
-                p.setRadius(10);
-
-                llh[0] = prevSampleGnss.lat;
-                llh[1] = prevSampleGnss.lon;
-                llh[2] = prevSampleGnss.alt;
-                Utility::llhToEnu(i_llh, llh, xyz);
-
-                LocPoint p2;
-                p2.setXY(xyz[0], xyz[1]);
-                p2.setRadius(10);
-
-                metersGnss += p.getDistanceTo(p2);
-            }
-
-            prevSampleGnssSet = true;
-            prevSampleGnss = d;
-        }
-
-        endSample = d;
+    double speedMax = 0.0;
+    double speedMaxGnss = 0.0;
+    double powerAvg = 0.0;
+    double powerMax = 0.0;
+    double intervalMax = 0.0;
+
+    if (samples > 0) {
+        startSample = mLogData.at(mLogTruncStart);
+        endSample = mLogData.at(mLogTruncEnd - 1);
+        timeTotMs = mLogIndex.timeMsRange(mLogTruncStart, mLogTruncEnd - 1);
+        metersGnss = mLogIndex.distGnssRange(mLogTruncStart, mLogTruncEnd - 1);
+
+        speedMax = qMax(fabs(mLogIndex.rangeMin(LogIndex::CH_SPEED, mLogTruncStart, mLogTruncEnd)),
+                        fabs(mLogIndex.rangeMax(LogIndex::CH_SPEED, mLogTruncStart, mLogTruncEnd)));
+        speedMaxGnss = mLogIndex.rangeMax(LogIndex::CH_SPEED_GNSS, mLogTruncStart, mLogTruncEnd);
+        powerAvg = mLogIndex.rangeAvg(LogIndex::CH_POWER, mLogTruncStart, mLogTruncEnd);
+        powerMax = mLogIndex.rangeMax(LogIndex::CH_POWER, mLogTruncStart, mLogTruncEnd);
     }
 
-    timeTotMs = endSample.valTime - startSample.valTime;
-    if (timeTotMs < 0) { // Handle midnight
-        timeTotMs += 60 * 60 * 24 * 1000;
+    if (samples > 1) {
+        intervalMax = mLogIndex.rangeMax(LogIndex::CH_SAMPLE_INTERVAL, mLogTruncStart + 1, mLogTruncEnd);
     }
 
     meters = endSample.setupValues.tachometer - startSample.setupValues.tachometer;
@@ -862,9 +1011,14 @@ void PageLogAnalysis::updateStats()
     addStatItem("Efficiency");
     addStatItem("Efficiency GNSS");
     addStatItem("Avg Sample Rate");
+    addStatItem("Max Speed");
+    addStatItem("Max Speed GNSS");
+    addStatItem("Avg Power");
+    addStatItem("Max Power");
+    addStatItem("Max Sample Interval");
 
     QTime t(0, 0, 0, 0);
-    t = t.addMSecs(timeTotMs);
+    t = t.addMSecs(int(timeTotMs));
 
     ui->statTable->item(0, 1)->setText(QString::number(samples));
     ui->statTable->item(1, 1)->setText(t.toString("hh:mm:ss.zzz"));
@@ -880,6 +1034,11 @@ void PageLogAnalysis::updateStats()
     ui->statTable->item(11, 1)->setText(QString::number((wh - whCharge) / (metersAbs / 1000.0), 'f', 2) + " wh/km");
     ui->statTable->item(12, 1)->setText(QString::number((wh - whCharge) / (metersGnss / 1000.0), 'f', 2) + " wh/km");
     ui->statTable->item(13, 1)->setText(QString::number(double(samples) / (double(timeTotMs) / 1000.0), 'f', 2) + " Hz");
+    ui->statTable->item(14, 1)->setText(QString::number(3.6 * speedMax, 'f', 2) + " km/h");
+    ui->statTable->item(15, 1)->setText(QString::number(3.6 * speedMaxGnss, 'f', 2) + " km/h");
+    ui->statTable->item(16, 1)->setText(QString::number(powerAvg, 'f', 2) + " W");
+    ui->statTable->item(17, 1)->setText(QString::number(powerMax, 'f', 2) + " W");
+    ui->statTable->item(18, 1)->setText(QString::number(intervalMax, 'f', 0) + " ms");
 }
 
 void PageLogAnalysis::updateDataAndPlot(double time)
@@ -901,12 +1060,10 @@ void PageLogAnalysis::updateDataAndPlot(double time)
     ui->plot->replot();
 
     LOG_DATA d = getLogSample(int(time * 1000));
-    mVerticalLineMsLast = d.valTime;
-
-    int timeTotMs = d.valTime - getLogSample(0).valTime;
-    if (timeTotMs < 0) { // Handle midnight
-        timeTotMs += 60 * 60 * 24 * 1000;
-    }
+    LOG_DATA first = getLogSample(0);
+    int ind = mLogIndex.indexAtTime(int(time * 1000), mLogTruncStart, mLogTruncEnd);
+    mVerticalLineIndLast = ind;
+    int timeTotMs = int(mLogIndex.timeMsRange(mLogTruncStart, ind));
 
     ui->dataTable->item(0, 1)->setText(QString::number(d.setupValues.speed * 3.6, 'f', 2) + " km/h");
     ui->dataTable->item(1, 1)->setText(QString::number(d.gVel * 3.6, 'f', 2) + " km/h");
@@ -916,8 +1073,8 @@ void PageLogAnalysis::updateDataAndPlot(double time)
     QTime t2(0, 0, 0, 0);
     t2 = t2.addMSecs(timeTotMs);
     ui->dataTable->item(3, 1)->setText(t2.toString("hh:mm:ss.zzz"));
-    ui->dataTable->item(4, 1)->setText(QString::number(d.setupValues.tachometer - getLogSample(0).setupValues.tachometer, 'f', 2) + "m");
-    ui->dataTable->item(5, 1)->setText(QString::number(d.setupValues.tachometer_abs - getLogSample(0).setupValues.tachometer_abs, 'f', 2) + "m");
+    ui->dataTable->item(4, 1)->setText(QString::number(d.setupValues.tachometer - first.setupValues.tachometer, 'f', 2) + "m");
+    ui->dataTable->item(5, 1)->setText(QString::number(d.setupValues.tachometer_abs - first.setupValues.tachometer_abs, 'f', 2) + "m");
     ui->dataTable->item(6, 1)->setText(QString::number(getDistGnssSample(int(time * 1000)), 'f', 2) + "m");
     ui->dataTable->item(7, 1)->setText(QString::number(d.setupValues.current_motor, 'f', 2) + " A");
     ui->dataTable->item(8, 1)->setText(QString::number(d.setupValues.current_in, 'f', 2) + " A");
@@ -965,18 +1122,8 @@ void PageLogAnalysis::updateDataAndPlot(double time)
     ui->dataTable->item(50, 1)->setText(QString::number(d.vAcc, 'f', 2) + " m");
     ui->dataTable->item(51, 1)->setText(QString::number(d.setupValues.num_openroads));
 
-    if (d.posTime >= 0 &&
-            (!ui->filterOutlierBox->isChecked() ||
-             d.hAcc < ui->filterhAccBox->value())) {
-        double i_llh[3];
-        double llh[3];
-        double xyz[3];
-        ui->map->getEnuRef(i_llh);
-        llh[0] = d.lat;
-        llh[1] = d.lon;
-        llh[2] = d.alt;
-        Utility::llhToEnu(i_llh, llh, xyz);
-
+    double xyz[3];
+    if (mLogIndex.enuAt(ind, xyz)) {
         LocPoint p;
         p.setXY(xyz[0], xyz[1]);
         p.setRadius(10);
@@ -998,21 +1145,9 @@ LOG_DATA PageLogAnalysis::getLogSample(int timeMs)
 {
     LOG_DATA d;
 
-    if (mLogDataTruncated.size() > 0) {
-        d = mLogDataTruncated.first();
-        int startTime = d.valTime;
-
-        for (LOG_DATA dn: mLogDataTruncated) {
-            int timeMsNow = dn.valTime - startTime;
-            if (timeMsNow < 0) { // Handle midnight
-                timeMsNow += 60 * 60 * 24 * 1000;
-            }
-
-            if (timeMsNow >= timeMs) {
-                d = dn;
-                break;
-            }
-        }
+    int ind = mLogIndex.indexAtTime(timeMs, mLogTruncStart, mLogTruncEnd);
+    if (ind >= 0) {
+        d = mLogData.at(ind);
     }
 
     return d;
@@ -1020,69 +1155,8 @@ LOG_DATA PageLogAnalysis::getLogSample(int timeMs)
 
 double PageLogAnalysis::getDistGnssSample(int timeMs)
 {
-    if (mLogDataTruncated.size() < 2) {
-        return 0.0;
-    }
-
-    double metersGnss = 0.0;
-    LOG_DATA prevSample;
-    bool prevSampleSet = false;
-
-    for (LOG_DATA d: mLogDataTruncated) {
-        int timeMsNow = d.valTime - mLogDataTruncated.first().valTime;
-        if (timeMsNow < 0) { // Handle midnight
-            timeMsNow += 60 * 60 * 24 * 1000;
-        }
-
-        if (d.posTime < 0) {
-            if (timeMsNow >= timeMs) {
-                break;
-            }
-            continue;
-        }
-
-        if (!prevSampleSet) {
-            prevSampleSet = true;
-            prevSample = d;
-            if (timeMsNow >= timeMs) {
-                break;
-            }
-            continue;
-        }
-
-        double i_llh[3];
-        double llh[3];
-        double xyz[3];
-        ui->map->getEnuRef(i_llh);
-
-        llh[0] = d.lat;
-        llh[1] = d.lon;
-        llh[2] = d.alt;
-        Utility::llhToEnu(i_llh, llh, xyz);
-
-        LocPoint p;
-        p.setXY(xyz[0], xyz[1]);
-        p.setRadius(10);
-
-        llh[0] = prevSample.lat;
-        llh[1] = prevSample.lon;
-        llh[2] = prevSample.alt;
-        Utility::llhToEnu(i_llh, llh, xyz);
-
-        LocPoint p2;
-        p2.setXY(xyz[0], xyz[1]);
-        p2.setRadius(10);
-
-        metersGnss += p.getDistanceTo(p2);
-
-        prevSample = d;
-
-        if (timeMsNow >= timeMs) {
-            break;
-        }
-    }
-
-    return metersGnss;
+    int ind = mLogIndex.indexAtTime(timeMs, mLogTruncStart, mLogTruncEnd);
+    return mLogIndex.distGnssRange(mLogTruncStart, ind);
 }
 
 void PageLogAnalysis::updateTileServers()
@@ -1101,26 +1175,119 @@ void PageLogAnalysis::updateTileServers()
 void PageLogAnalysis::logListRefresh()
 {
     if (ui->tabWidget->currentIndex() == 3) {
-        ui->logTable->setRowCount(0);
         QSettings set;
         if (set.contains("pageloganalysis/lastdir")) {
-            QString dirPath = set.value("pageloganalysis/lastdir").toString();
-            QDir dir(dirPath);
-            if (dir.exists()) {
-                for (QFileInfo f: dir.entryInfoList(QStringList() << "*.csv" << "*.Csv" << "*.CSV",
-                                              QDir::Files, QDir::Name)) {
-                    QTableWidgetItem *itName = new QTableWidgetItem(f.fileName());
-                    itName->setData(Qt::UserRole, f.absoluteFilePath());
-                    ui->logTable->setRowCount(ui->logTable->rowCount() + 1);
-                    ui->logTable->setItem(ui->logTable->rowCount() - 1, 0, itName);
-                    ui->logTable->setItem(ui->logTable->rowCount() - 1, 1,
-                                          new QTableWidgetItem(QString("%1 MB").
-                                                               arg(double(f.size())
-                                                                   / 1024.0 / 1024.0,
-                                                                   0, 'f', 2)));
-                }
+            mLogDirIndex->setDirectory(set.value("pageloganalysis/lastdir").toString());
+        } else {
+            ui->logTable->setRowCount(0);
+        }
+    }
+}
+
+/**
+ * @brief PageLogAnalysis::logListFill
+ * Create a row for every log in the indexed directory, with the summaries
+ * that are available so far. The rest are filled in as they are indexed.
+ */
+void PageLogAnalysis::logListFill()
+{
+    ui->logTable->setSortingEnabled(false);
+    ui->logTable->setRowCount(0);
+
+    QDir dir(mLogDirIndex->directory());
+    for (QString name: mLogDirIndex->fileNames()) {
+        QFileInfo f(dir.absoluteFilePath(name));
+        int row = ui->logTable->rowCount();
+        ui->logTable->setRowCount(row + 1);
+
+        QTableWidgetItem *itName = new LogListItem(f.fileName());
+        itName->setData(Qt::UserRole, f.absoluteFilePath());
+        ui->logTable->setItem(row, 0, itName);
+
+        QTableWidgetItem *itSize = new LogListItem(QString("%1 MB").
+                                                   arg(double(f.size())
+                                                       / 1024.0 / 1024.0,
+                                                       0, 'f', 2));
+        itSize->setData(Qt::UserRole + 1, double(f.size()));
+        ui->logTable->setItem(row, 1, itSize);
+
+        for (int col = 2;col < ui->logTable->columnCount();col++) {
+            ui->logTable->setItem(row, col, new LogListItem);
+        }
+
+        logListUpdateRow(row);
+    }
+
+    ui->logTable->setSortingEnabled(true);
+    logListFilter();
+}
+
+void PageLogAnalysis::logListUpdateRow(int row)
+{
+    LogDirIndex::Summary s;
+    int pending = mLogDirIndex->pendingCount();
+
+    if (pending > 0) {
+        ui->logIndexLabel->setText(tr("Indexing %1 logs...").arg(pending));
+    } else {
+        ui->logIndexLabel->clear();
+    }
+
+    auto setCol = [this, row](int col, QString text, double key) {
+        QTableWidgetItem *it = ui->logTable->item(row, col);
+        it->setText(text);
+        it->setData(Qt::UserRole + 1, key);
+    };
+
+    if (!mLogDirIndex->summary(ui->logTable->item(row, 0)->text(), s)) {
+        for (int col = 2;col < ui->logTable->columnCount();col++) {
+            setCol(col, "...", -1.0);
+        }
+        return;
+    }
+
+    if (!s.valid) {
+        for (int col = 2;col < ui->logTable->columnCount();col++) {
+            setCol(col, "-", -1.0);
+        }
+        return;
+    }
+
+    QTime t(0, 0, 0, 0);
+    t = t.addMSecs(int(s.durationMs));
+
+    setCol(2, t.toString("hh:mm:ss"), double(s.durationMs));
+    setCol(3, QString::number(s.meters / 1000.0, 'f', 2) + " km", s.meters);
+    setCol(4, QString::number(s.wh - s.whCharged, 'f', 1) + " Wh", s.wh - s.whCharged);
+    setCol(5, QString::number(3.6 * s.speedMax, 'f', 1) + " km/h", s.speedMax);
+    setCol(6, "", s.metersGnss);
+
+    QTableWidgetItem *itTrack = ui->logTable->item(row, 6);
+    itTrack->setData(Qt::DecorationRole, logTrackIcon(s.track, ui->logTable->iconSize(),
+                                                      palette().color(QPalette::Highlight)));
+    itTrack->setToolTip(QString("%1 km GNSS").arg(s.metersGnss / 1000.0, 0, 'f', 2));
+}
+
+/**
+ * @brief PageLogAnalysis::logListFilter
+ * Hide the logs that do not contain all words of the filter in their name.
+ */
+void PageLogAnalysis::logListFilter()
+{
+    QStringList words = ui->logFilterEdit->text().split(" ", QString::SkipEmptyParts);
+
+    for (int i = 0;i < ui->logTable->rowCount();i++) {
+        QString name = ui->logTable->item(i, 0)->text();
+        bool show = true;
+
+        for (const auto &w: words) {
+            if (!name.contains(w, Qt::CaseInsensitive)) {
+                show = false;
+                break;
             }
         }
+
+        ui->logTable->setRowHidden(i, !show);
     }
 }
 
@@ -1199,11 +1366,10 @@ void PageLogAnalysis::on_centerButton_clicked()
 
 void PageLogAnalysis::on_logListOpenButton_clicked()
 {
-    auto items = ui->logTable->selectedItems();
+    int row = ui->logTable->currentRow();
 
-    if (items.size() > 0) {
-        QString fileName = items.
-                first()->data(Qt::UserRole).toString();
+    if (row >= 0 && !ui->logTable->isRowHidden(row)) {
+        QString fileName = ui->logTable->item(row, 0)->data(Qt::UserRole).toString();
         if (mOpenroad->loadRtLogFile(fileName)) {
             on_openCurrentButton_clicked();
         }
@@ -1216,3 +1382,57 @@ void PageLogAnalysis::on_logListRefreshButton_clicked()
 {
     logListRefresh();
 }
+
+void PageLogAnalysis::on_logListReportButton_clicked()
+{
+    QStringList files;
+    for (int i = 0;i < ui->logTable->rowCount();i++) {
+        if (!ui->logTable->isRowHidden(i)) {
+            files.append(ui->logTable->item(i, 0)->data(Qt::UserRole).toString());
+        }
+    }
+
+    if (files.isEmpty()) {
+        mOpenroad->emitMessageDialog("Log Report", "No Logs Listed", false);
+        return;
+    }
+
+    QString fileName = QFileDialog::getSaveFileName(this,
+                                                    tr("Save Report"), "",
+                                                    tr("CSV Files (*.csv);;JSON Files (*.json)"));
+
+    if (fileName.isEmpty()) {
+        return;
+    }
+
+    if (!fileName.toLower().endsWith(".csv") && !fileName.toLower().endsWith(".json")) {
+        fileName.append(".csv");
+    }
+
+    QProgressDialog dialog(tr("Analyzing logs..."), tr("Cancel"), 0, files.size(), this);
+    dialog.setWindowModality(Qt::WindowModal);
+
+    QFutureWatcher<LogDirIndex::Summary> watcher;
+    connect(&watcher, &QFutureWatcherBase::progressValueChanged,
+            &dialog, &QProgressDialog::setValue);
+    connect(&watcher, &QFutureWatcherBase::finished,
+            &dialog, &QProgressDialog::accept);
+    connect(&dialog, &QProgressDialog::canceled,
+            &watcher, &QFutureWatcherBase::cancel);
+
+    watcher.setFuture(LogBatchAnalysis::start(files));
+    dialog.exec();
+    watcher.waitForFinished();
+
+    if (watcher.isCanceled()) {
+        return;
+    }
+
+    if (LogBatchAnalysis::writeReport(fileName, watcher.future().results().toVector())) {
+        mOpenroad->emitStatusMessage(QString("Saved report of %1 logs").arg(files.size()), true);
+    } else {
+        mOpenroad->emitMessageDialog("Log Report",
+                                     "Could not write\n" + fileName,
+                                     false, false);
+    }
+}
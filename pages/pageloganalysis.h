@@ -22,9 +22,14 @@
 #define PAGELOGANALYSIS_H
 
 #include <QWidget>
+#include <QFutureWatcher>
 #include <openroadinterface.h>
 #include "widgets/qcustomplot.h"
 #include "widgets/openroad3dview.h"
+#include "map/locpoint.h"
+#include "logindex.h"
+#include "logplotpyramid.h"
+#include "logdirindex.h"
 
 namespace Ui {
 class PageLogAnalysis;
@@ -54,19 +59,38 @@ private slots:
     void on_centerButton_clicked();
     void on_logListOpenButton_clicked();
     void on_logListRefreshButton_clicked();
+    void on_logListReportButton_clicked();
 
 private:
     Ui::PageLogAnalysis *ui;
     OpenroadInterface *mOpenroad;
     QCPCurve *mVerticalLine;
-    int mVerticalLineMsLast;
+    int mVerticalLineIndLast;
     Openroad3DView *m3dView;
     QCheckBox *mUseYawBox;
     QVector<LOG_DATA> mLogData;
-    QVector<LOG_DATA> mLogDataTruncated;
+    LogIndex mLogIndex;
+    QVector<LocPoint> mLogTrace;
+    QVector<int> mLogTraceInd;
+    LogPlotPyramid mPlotPyramid;
+    QFutureWatcher<LogPlotPyramid> *mPlotPyramidWatcher;
+    QVector<int> mPlotRows;
+    QVector<double> mPlotScales;
+    QVector<double> mPlotOffsets;
+    int mPlotLevel;
+    int mLogTruncStart;
+    int mLogTruncEnd;
     QTimer *mPlayTimer;
     double mPlayPosNow;
-
+    QTimer *mLiveTimer;
+    bool mLiveReset;
+    LogDirIndex *mLogDirIndex;
+
+    void updateLogIndex();
+    void updatePlotPyramid();
+    void extendLogTrace(int gnssStart);
+    void appendLogData();
+    double plotValue(int r, int ind);
     void truncateDataAndPlot(bool zoomGraph = true);
     void updateGraphs();
     void updateStats();
@@ -75,6 +99,9 @@ private:
     double getDistGnssSample(int timeMs);
     void updateTileServers();
     void logListRefresh();
+    void logListFill();
+    void logListUpdateRow(int row);
+    void logListFilter();
 
 };
 
@@ -49,6 +49,8 @@ void PageMotorInfo::setOpenroad(OpenroadInterface *openroad)
 
         connect(mOpenroad->mcConfig(), SIGNAL(paramChangedQString(QObject*,QString,QString)),
                 this, SLOT(paramChangedQString(QObject*,QString,QString)));
+        connect(mOpenroad->mcConfig(), SIGNAL(paramsChanged(QObject*,QStringList)),
+                this, SLOT(paramsChanged(QObject*,QStringList)));
         connect(mOpenroad->mcConfig(), SIGNAL(savingXml()),
                 this, SLOT(savingXml()));
     }
@@ -92,6 +94,19 @@ void PageMotorInfo::paramChangedQString(QObject *src, QString name, QString newP
     }
 }
 
+void PageMotorInfo::paramsChanged(QObject *src, QStringList names)
+{
+    if (names.contains("motor_description")) {
+        paramChangedQString(src, "motor_description",
+                            mOpenroad->mcConfig()->getParamQString("motor_description"));
+    }
+
+    if (names.contains("motor_quality_description")) {
+        paramChangedQString(src, "motor_quality_description",
+                            mOpenroad->mcConfig()->getParamQString("motor_quality_description"));
+    }
+}
+
 void PageMotorInfo::on_descriptionHelpButton_clicked()
 {
     if (mOpenroad) {
@@ -42,6 +42,7 @@ public:
 private slots:
     void savingXml();
     void paramChangedQString(QObject *src, QString name, QString newParam);
+    void paramsChanged(QObject *src, QStringList names);
 
 private slots:
     void on_descriptionHelpButton_clicked();
@@ -52,7 +52,7 @@ void PageMotorSettings::setOpenroad(OpenroadInterface *openroad)
 void PageMotorSettings::reloadParams()
 {
     if (mOpenroad) {
-        ConfigParam *p = mOpenroad->infoConfig()->getParam("motor_setting_description");
+        const ConfigParam *p = mOpenroad->infoConfig()->getParam("motor_setting_description");
         if (p != nullptr) {
             ui->textEdit->setHtml(p->description);
         } else {
@@ -24,6 +24,19 @@
 #include <QXmlStreamWriter>
 #include <QXmlStreamReader>
 
+namespace {
+// The fields shown in the text box and the plots
+const unsigned int valuesMask =
+        Commands::VALUES_TEMP_MOS | Commands::VALUES_TEMP_MOTOR |
+        Commands::VALUES_CURRENT_MOTOR | Commands::VALUES_CURRENT_IN |
+        Commands::VALUES_ID | Commands::VALUES_IQ | Commands::VALUES_DUTY_NOW |
+        Commands::VALUES_RPM | Commands::VALUES_V_IN | Commands::VALUES_AMP_HOURS |
+        Commands::VALUES_AMP_HOURS_CHARGED | Commands::VALUES_WATT_HOURS |
+        Commands::VALUES_WATT_HOURS_CHARGED | Commands::VALUES_TACHOMETER |
+        Commands::VALUES_TACHOMETER_ABS | Commands::VALUES_FAULT_CODE |
+        Commands::VALUES_TEMP_MOS_123 | Commands::VALUES_VD | Commands::VALUES_VQ;
+}
+
 PageRtData::PageRtData(QWidget *parent) :
     QWidget(parent),
     ui(new Ui::PageRtData)
@@ -377,9 +390,31 @@ void PageRtData::timerSlot()
     }
 }
 
+void PageRtData::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+
+    if (mOpenroad) {
+        mOpenroad->commands()->subscribeValues(this, valuesMask);
+    }
+}
+
+void PageRtData::hideEvent(QHideEvent *event)
+{
+    QWidget::hideEvent(event);
+
+    if (mOpenroad) {
+        mOpenroad->commands()->unsubscribeValues(this);
+    }
+}
+
 void PageRtData::valuesReceived(MC_VALUES values, unsigned int mask)
 {
-    (void)mask;
+    // Responses to requests of other subscribers do not have all fields
+    if ((mask & valuesMask) != valuesMask) {
+        return;
+    }
+
     ui->rtText->setValues(values);
 
     const int maxS = 500;
@@ -595,7 +630,8 @@ void PageRtData::on_csvEnableLogBox_clicked(bool checked)
 {
     if (checked) {
         if (mOpenroad) {
-            mOpenroad->openRtLogFile(ui->csvFileEdit->text());
+            mOpenroad->openRtLogFile(ui->csvFileEdit->text(),
+                                     ui->csvCompressBox->isChecked());
         }
     } else {
         mOpenroad->closeRtLogFile();
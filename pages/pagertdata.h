@@ -40,6 +40,10 @@ public:
     OpenroadInterface *openroad() const;
     void setOpenroad(OpenroadInterface *openroad);
 
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
 private slots:
     void timerSlot();
     void valuesReceived(MC_VALUES values, unsigned int mask);
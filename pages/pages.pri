@@ -30,7 +30,8 @@ FORMS += \
     $$PWD/pageimu.ui \
     $$PWD/pageswdprog.ui \
     $$PWD/pageappimu.ui \
-    $$PWD/pageloganalysis.ui
+    $$PWD/pageloganalysis.ui \
+    $$PWD/pagelinkdiagnostics.ui
 
 HEADERS += \
     $$PWD/pageappbalance.h \
@@ -64,7 +65,8 @@ HEADERS += \
     $$PWD/pageimu.h \
     $$PWD/pageswdprog.h \
     $$PWD/pageappimu.h \
-    $$PWD/pageloganalysis.h
+    $$PWD/pageloganalysis.h \
+    $$PWD/pagelinkdiagnostics.h
 
 SOURCES += \
     $$PWD/pageappbalance.cpp \
@@ -98,4 +100,5 @@ SOURCES += \
     $$PWD/pageimu.cpp \
     $$PWD/pageswdprog.cpp \
     $$PWD/pageappimu.cpp \
-    $$PWD/pageloganalysis.cpp
+    $$PWD/pageloganalysis.cpp \
+    $$PWD/pagelinkdiagnostics.cpp
@@ -20,6 +20,7 @@
 #include "pagesampleddata.h"
 #include "ui_pagesampleddata.h"
 #include "digitalfiltering.h"
+#include "eventtrace.h"
 
 PageSampledData::PageSampledData(QWidget *parent) :
     QWidget(parent),
@@ -92,6 +93,7 @@ void PageSampledData::setOpenroad(OpenroadInterface *openroad)
 
 void PageSampledData::timerSlot()
 {
+    VT_TRACE_SCOPE("PageSampledData::timerSlot");
     static QVector<double> filter;
     QFont legendFont = font();
     legendFont.setPointSize(9);
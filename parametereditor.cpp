@@ -141,7 +141,7 @@ void ParameterEditor::on_paramOpenButton_clicked()
         selected = item->text();
     }
 
-    ConfigParam *p = mParams.getParam(selected);
+    const ConfigParam *p = mParams.getParam(selected);
 
     if (p) {
         setEditorValues(selected, *p);
@@ -178,7 +178,7 @@ void ParameterEditor::on_paramSaveButton_clicked()
     name = getEditorValues(&p);
 
     if (mParams.hasParam(name)) {
-        *mParams.getParam(name) = p;
+        mParams.setParam(name, p);
         showStatusInfo(tr("Parameter updated: %1").arg(name), true);
     } else {
         mParams.addParam(name, p);
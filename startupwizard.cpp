@@ -69,7 +69,7 @@ StartupIntroPage::StartupIntroPage(OpenroadInterface *openroad, QWidget *parent)
     mBrowser->setFrameStyle(QFrame::NoFrame);
     mBrowser->viewport()->setAutoFillBackground(false);
 
-    ConfigParam *p = openroad->infoConfig()->getParam("wizard_startup_intro");
+    const ConfigParam *p = openroad->infoConfig()->getParam("wizard_startup_intro");
     if (p != 0) {
         setTitle(p->longName);
         mBrowser->setHtml(p->description);
@@ -94,7 +94,7 @@ StartupUsagePage::StartupUsagePage(OpenroadInterface *openroad, QWidget *parent)
     mBrowser = new VTextBrowser;
     mAcceptBox = new QCheckBox("Yes, I understand and accept");
 
-    ConfigParam *p = openroad->infoConfig()->getParam("wizard_startup_usage");
+    const ConfigParam *p = openroad->infoConfig()->getParam("wizard_startup_usage");
     if (p != 0) {
         setTitle(p->longName);
         setSubTitle(p->valString);
@@ -144,7 +144,7 @@ StartupWarrantyPage::StartupWarrantyPage(OpenroadInterface *openroad, QWidget *p
     mBrowser = new VTextBrowser;
     mAcceptBox = new QCheckBox("Yes, I understand and accept");
 
-    ConfigParam *p = openroad->infoConfig()->getParam("wizard_startup_warranty");
+    const ConfigParam *p = openroad->infoConfig()->getParam("wizard_startup_warranty");
     if (p != 0) {
         setTitle(p->longName);
         setSubTitle(p->valString);
@@ -195,7 +195,7 @@ StartupConclusionPage::StartupConclusionPage(OpenroadInterface *openroad, QWidge
     mBrowser->setFrameStyle(QFrame::NoFrame);
     mBrowser->viewport()->setAutoFillBackground(false);
 
-    ConfigParam *p = openroad->infoConfig()->getParam("wizard_startup_conclusion");
+    const ConfigParam *p = openroad->infoConfig()->getParam("wizard_startup_conclusion");
     if (p != 0) {
         setTitle(p->longName);
         mBrowser->setHtml(p->description);
@@ -18,20 +18,16 @@
     */
 
 #include "utility.h"
+#include "eventtrace.h"
 #include <cmath>
-#include <QProgressDialog>
 #include <QEventLoop>
-#include <QNetworkAccessManager>
-#include <QUrl>
-#include <QNetworkRequest>
 #include <QDebug>
-#include <QNetworkReply>
-#include <QMessageBox>
 #include <QFile>
 #include <QFileInfo>
 #include <QtGlobal>
 #include <QNetworkInterface>
 #include <QDirIterator>
+#include <QHash>
 
 #ifdef Q_OS_ANDROID
 #include <QtAndroid>
@@ -39,6 +35,55 @@
 #include <QAndroidJniEnvironment>
 #endif
 
+namespace {
+// Directories of the bundled configurations, indexed by firmware version.
+// A directory can support several versions, e.g. 5.01_o_5.02.
+struct ConfigIndex {
+    QHash<QPair<int, int>, QString> dirs;
+    QVector<QPair<int, int>> fws;
+    QPair<int, int> latest = qMakePair(-1, -1);
+};
+
+ConfigIndex buildConfigIndex()
+{
+    ConfigIndex index;
+    QDirIterator it("://res/config");
+
+    while (it.hasNext()) {
+        QFileInfo fi(it.next());
+        QStringList names = fi.fileName().split("_o_");
+
+        if (fi.isDir()) {
+            for(auto name: names) {
+                auto parts = name.split(".");
+                if (parts.size() == 2) {
+                    QPair<int, int> ver = qMakePair(parts.at(0).toInt(), parts.at(1).toInt());
+                    index.fws.append(ver);
+
+                    if (!index.dirs.contains(ver)) {
+                        index.dirs.insert(ver, it.filePath());
+                    }
+
+                    if (ver > index.latest) {
+                        index.latest = ver;
+                    }
+                }
+            }
+        }
+    }
+
+    return index;
+}
+
+// The resources never change while VESC Tool runs, so the index is built
+// on first use only.
+const ConfigIndex &configIndex()
+{
+    static const ConfigIndex index = buildConfigIndex();
+    return index;
+}
+}
+
 Utility::Utility(QObject *parent) : QObject(parent)
 {
 
@@ -104,63 +149,6 @@ float Utility::throttle_curve(float val, float curve_acc, float curve_brake, int
     return ret;
 }
 
-bool Utility::autoconnectBlockingWithProgress(OpenroadInterface *openroad, QWidget *parent)
-{
-    if (!openroad) {
-        return false;
-    }
-
-    QProgressDialog dialog("Autoconnecting...", QString(), 0, 0, parent);
-    dialog.setWindowModality(Qt::WindowModal);
-    dialog.show();
-
-    bool res = openroad->autoconnect();
-
-    if (!res) {
-        openroad->emitMessageDialog(QObject::tr("Autoconnect"),
-                                QObject::tr("Could not autoconnect. Make sure that the USB cable is plugged in "
-                                            "and that the VESC is powered."),
-                                false);
-    }
-
-    return res;
-}
-
-void Utility::checkVersion(OpenroadInterface *openroad)
-{
-    QString version = QString::number(VT_VERSION);
-    QUrl url("https://openroad-project.com/openroadtool-version.html");
-    QNetworkAccessManager manager;
-    QNetworkRequest request(url);
-    QNetworkReply *reply = manager.get(request);
-    QEventLoop loop;
-    QObject::connect(reply, SIGNAL(finished()), &loop, SLOT(quit()));
-    loop.exec();
-
-    QString res = QString::fromUtf8(reply->readAll());
-
-    if (res.startsWith("openroadtoolversion")) {
-        res.remove(0, 15);
-        res.remove(res.indexOf("openroadtoolversion"), res.size());
-
-        if (res.toDouble() > version.toDouble()) {
-            if (openroad) {
-                openroad->emitStatusMessage("A new version of VESC Tool is available", true);
-                openroad->emitMessageDialog(QObject::tr("New Software Available"),
-                                        QObject::tr("A new version of VESC Tool is available. Go to "
-                                                    "<a href=\"http://openroad-project.com/\">http://openroad-project.com/</a>"
-                                                    " to download it and get all the latest features."),
-                                        true);
-            } else {
-                qDebug() << "A new version of VESC Tool is available. Go to openroad-project.com to download it "
-                            "and get all the latest features.";
-            }
-        }
-    } else {
-        qWarning() << res;
-    }
-}
-
 QString Utility::fwChangeLog()
 {
     QFile cl("://res/firmwares/CHANGELOG");
@@ -181,28 +169,6 @@ QString Utility::openroadToolChangeLog()
     }
 }
 
-QString Utility::aboutText()
-{
-    return tr("<b>VESC® Tool %1</b><br>"
-          #if defined(VER_ORIGINAL)
-              "Original Version<br>"
-          #elif defined(VER_PLATINUM)
-              "Platinum Version<br>"
-          #elif defined(VER_GOLD)
-              "Gold Version<br>"
-          #elif defined(VER_SILVER)
-              "Silver Version<br>"
-          #elif defined(VER_BRONZE)
-              "Bronze Version<br>"
-          #elif defined(VER_FREE)
-              "Free of Charge Version<br>"
-          #endif
-              "&copy; Benjamin Vedder 2016 - 2019<br>"
-              "<a href=\"mailto:benjamin@vedder.se\">benjamin@vedder.se</a><br>"
-              "<a href=\"https://openroad-project.com/\">https://openroad-project.com/</a>").
-            arg(QString::number(VT_VERSION, 'f', 2));
-}
-
 QString Utility::uuid2Str(QByteArray uuid, bool space)
 {
     QString strUuid;
@@ -268,6 +234,8 @@ void Utility::keepScreenOn(bool on)
 
 bool Utility::waitSignal(QObject *sender, QString signal, int timeoutMs)
 {
+    // Events dispatched by the nested loop show up inside this scope
+    VT_TRACE_SCOPE_CAT("Utility::waitSignal", "loop");
     QEventLoop loop;
     QTimer timeoutTimer;
     timeoutTimer.setSingleShot(true);
@@ -282,8 +250,150 @@ bool Utility::waitSignal(QObject *sender, QString signal, int timeoutMs)
     return timeoutTimer.isActive();
 }
 
+/**
+ * @brief Utility::readConfs
+ * Read the motor and/or app configuration from the current target. Both
+ * requests are sent at once and the responses are told apart by their
+ * command, so reading both takes about as long as reading one.
+ *
+ * @param defaults
+ * Read the default configurations instead.
+ *
+ * @return
+ * true when all requested configurations were received in time.
+ */
+bool Utility::readConfs(OpenroadInterface *openroad, bool mc, bool app, bool defaults, int timeoutMs)
+{
+    VT_TRACE_SCOPE_CAT("Utility::readConfs", "loop");
+    QEventLoop loop;
+    QTimer timeoutTimer;
+    timeoutTimer.setSingleShot(true);
+
+    bool mcDone = !mc;
+    bool appDone = !app;
+
+    auto conn1 = QObject::connect(openroad->mcConfig(), &ConfigParams::updated, [&]() {
+        mcDone = true;
+        if (appDone) {
+            loop.quit();
+        }
+    });
+    auto conn2 = QObject::connect(openroad->appConfig(), &ConfigParams::updated, [&]() {
+        appDone = true;
+        if (mcDone) {
+            loop.quit();
+        }
+    });
+    auto conn3 = QObject::connect(&timeoutTimer, SIGNAL(timeout()), &loop, SLOT(quit()));
+
+    if (mc) {
+        if (defaults) {
+            openroad->commands()->getMcconfDefault();
+        } else {
+            openroad->commands()->getMcconf();
+        }
+    }
+
+    if (app) {
+        if (defaults) {
+            openroad->commands()->getAppConfDefault();
+        } else {
+            openroad->commands()->getAppConf();
+        }
+    }
+
+    if (!mcDone || !appDone) {
+        timeoutTimer.start(timeoutMs);
+        loop.exec();
+    }
+
+    QObject::disconnect(conn1);
+    QObject::disconnect(conn2);
+    QObject::disconnect(conn3);
+
+    return mcDone && appDone;
+}
+
+/**
+ * @brief Utility::writeConfs
+ * Write the motor and/or app configuration to the current target, with
+ * both writes sent at once. The acks are matched to the writes by their
+ * command.
+ *
+ * @param mcOk
+ * Set to whether the motor configuration write was acked, or skipped
+ * because it had no changes, if given.
+ *
+ * @param appOk
+ * Set to whether the app configuration write was acked, or skipped
+ * because it had no changes, if given.
+ *
+ * @return
+ * true when all requested writes were acked in time. Writes that are
+ * blocked, e.g. of configurations from the cache, fail right away.
+ */
+bool Utility::writeConfs(OpenroadInterface *openroad, bool mc, bool app, int timeoutMs,
+                         bool *mcOk, bool *appOk)
+{
+    VT_TRACE_SCOPE_CAT("Utility::writeConfs", "loop");
+    QEventLoop loop;
+    QTimer timeoutTimer;
+    timeoutTimer.setSingleShot(true);
+
+    bool mcDone = !mc;
+    bool appDone = !app;
+    bool mcRes = !mc;
+    bool appRes = !app;
+
+    auto conn1 = QObject::connect(openroad->commands(), &Commands::mcConfigWritten,
+                                  [&](bool ok) {
+        mcDone = true;
+        mcRes = ok;
+        if (appDone) {
+            loop.quit();
+        }
+    });
+    auto conn2 = QObject::connect(openroad->commands(), &Commands::appConfigWritten,
+                                  [&](bool ok) {
+        appDone = true;
+        appRes = ok;
+        if (mcDone) {
+            loop.quit();
+        }
+    });
+    auto conn3 = QObject::connect(&timeoutTimer, SIGNAL(timeout()), &loop, SLOT(quit()));
+
+    if (mc) {
+        openroad->commands()->setMcconf(false);
+    }
+
+    if (app) {
+        openroad->commands()->setAppConf();
+    }
+
+    if (!mcDone || !appDone) {
+        timeoutTimer.start(timeoutMs);
+        loop.exec();
+    }
+
+    QObject::disconnect(conn1);
+    QObject::disconnect(conn2);
+    QObject::disconnect(conn3);
+
+    if (mcOk) {
+        *mcOk = mcDone && mcRes;
+    }
+
+    if (appOk) {
+        *appOk = appDone && appRes;
+    }
+
+    return mcDone && mcRes && appDone && appRes;
+}
+
 void Utility::sleepWithEventLoop(int timeMs)
 {
+    VT_TRACE_SCOPE_CAT("Utility::sleepWithEventLoop", "loop");
     QEventLoop loop;
     QTimer timeoutTimer;
     timeoutTimer.setSingleShot(true);
@@ -834,26 +944,10 @@ bool Utility::restoreConfAll(OpenroadInterface *openroad, bool can, bool mc, boo
         }
     }
 
-    if (mc) {
-        ConfigParams *p = openroad->mcConfig();
-        openroad->commands()->getMcconfDefault();
-        res = waitSignal(p, SIGNAL(updated()), 1500);
-
-        if (res) {
-            openroad->commands()->setMcconf(false);
-            res = waitSignal(openroad->commands(), SIGNAL(ackReceived(QString)), 2000);
-        }
-    }
-
-    if (app) {
-        ConfigParams *p = openroad->appConfig();
-        openroad->commands()->getAppConfDefault();
-        res = waitSignal(p, SIGNAL(updated()), 1500);
+    res = readConfs(openroad, mc, app, true, 1500);
 
-        if (res) {
-            openroad->commands()->setAppConf();
-            res = waitSignal(openroad->commands(), SIGNAL(ackReceived(QString)), 2000);
-        }
+    if (res) {
+        res = writeConfs(openroad, mc, app, 2000);
     }
 
     if (res && can) {
@@ -871,38 +965,16 @@ bool Utility::restoreConfAll(OpenroadInterface *openroad, bool can, bool mc, boo
                 return false;
             }
 
-            if (mc) {
-                ConfigParams *p = openroad->mcConfig();
-                openroad->commands()->getMcconfDefault();
-                res = waitSignal(p, SIGNAL(updated()), 1500);
-
-                if (!res) {
-                    break;
-                }
-
-                openroad->commands()->setMcconf(false);
-                res = waitSignal(openroad->commands(), SIGNAL(ackReceived(QString)), 2000);
+            res = readConfs(openroad, mc, app, true, 1500);
 
-                if (!res) {
-                    break;
-                }
+            if (!res) {
+                break;
             }
 
-            if (app) {
-                ConfigParams *p = openroad->appConfig();
-                openroad->commands()->getAppConfDefault();
-                res = waitSignal(p, SIGNAL(updated()), 1500);
-
-                if (!res) {
-                    break;
-                }
+            res = writeConfs(openroad, mc, app, 2000);
 
-                openroad->commands()->setAppConf();
-                res = waitSignal(openroad->commands(), SIGNAL(ackReceived(QString)), 2000);
-
-                if (!res) {
-                    break;
-                }
+            if (!res) {
+                break;
             }
         }
     }
@@ -999,7 +1071,7 @@ bool Utility::createParamParserC(OpenroadInterface *openroad, QString filename)
         for (int i = 0;i < serialOrder.size();i++) {
             QString name = serialOrder.at(i);
 
-            ConfigParam *p = params->getParam(name);
+            const ConfigParam *p = params->getParam(name);
 
             int last__ = name.lastIndexOf("__");
             if (last__ > 0) {
@@ -1083,7 +1155,7 @@ bool Utility::createParamParserC(OpenroadInterface *openroad, QString filename)
         for (int i = 0;i < serialOrder.size();i++) {
             QString name = serialOrder.at(i);
 
-            ConfigParam *p = params->getParam(name);
+            const ConfigParam *p = params->getParam(name);
 
             int last__ = name.lastIndexOf("__");
             if (last__ > 0) {
@@ -1171,7 +1243,7 @@ bool Utility::createParamParserC(OpenroadInterface *openroad, QString filename)
         for (int i = 0;i < serialOrder.size();i++) {
             QString name = serialOrder.at(i);
 
-            ConfigParam *p = params->getParam(name);
+            const ConfigParam *p = params->getParam(name);
 
             int last__ = name.lastIndexOf("__");
             if (last__ > 0) {
@@ -1386,23 +1458,50 @@ void Utility::createEnuMatrix(double lat, double lon, double *enuMat)
 }
 
 void Utility::llhToEnu(const double *iLlh, const double *llh, double *xyz)
+{
+    llhToEnu(iLlh, llh, xyz, 1);
+}
+
+/**
+ * @brief Utility::llhToEnu
+ * Convert count positions to ENU coordinates around the same reference.
+ * The reference and the ENU matrix are only computed once.
+ *
+ * @param iLlh
+ * ENU reference.
+ *
+ * @param llh
+ * count positions as consecutive lat, lon, height triplets.
+ *
+ * @param xyz
+ * Output for count ENU triplets. Must not overlap llh.
+ *
+ * @param count
+ * Number of positions.
+ */
+void Utility::llhToEnu(const double *iLlh, const double *llh, double *xyz, int count)
 {
     double ix, iy, iz;
     llhToXyz(iLlh[0], iLlh[1], iLlh[2], &ix, &iy, &iz);
 
-    double x, y, z;
-    llhToXyz(llh[0], llh[1], llh[2], &x, &y, &z);
-
     double enuMat[9];
     createEnuMatrix(iLlh[0], iLlh[1], enuMat);
 
-    double dx = x - ix;
-    double dy = y - iy;
-    double dz = z - iz;
+    for (int i = 0;i < count;i++) {
+        const double *p = llh + 3 * i;
+        double *res = xyz + 3 * i;
+
+        double x, y, z;
+        llhToXyz(p[0], p[1], p[2], &x, &y, &z);
 
-    xyz[0] = enuMat[0] * dx + enuMat[1] * dy + enuMat[2] * dz;
-    xyz[1] = enuMat[3] * dx + enuMat[4] * dy + enuMat[5] * dz;
-    xyz[2] = enuMat[6] * dx + enuMat[7] * dy + enuMat[8] * dz;
+        double dx = x - ix;
+        double dy = y - iy;
+        double dz = z - iz;
+
+        res[0] = enuMat[0] * dx + enuMat[1] * dy + enuMat[2] * dz;
+        res[1] = enuMat[3] * dx + enuMat[4] * dy + enuMat[5] * dz;
+        res[2] = enuMat[6] * dx + enuMat[7] * dy + enuMat[8] * dz;
+    }
 }
 
 void Utility::enuToLlh(const double *iLlh, const double *xyz, double *llh)
@@ -1422,90 +1521,36 @@ void Utility::enuToLlh(const double *iLlh, const double *xyz, double *llh)
 
 bool Utility::configCheckCompatibility(int fwMajor, int fwMinor)
 {
-    QDirIterator it("://res/config");
-
-    while (it.hasNext()) {
-        QFileInfo fi(it.next());
-        QStringList names = fi.fileName().split("_o_");
-
-        if (fi.isDir()) {
-            for(auto name: names) {
-                auto parts = name.split(".");
-                if (parts.size() == 2) {
-                    int major = parts.at(0).toInt();
-                    int minor = parts.at(1).toInt();
-                    if (major == fwMajor && minor == fwMinor) {
-                        return true;
-                    }
-                }
-            }
-        }
-    }
-
-    return false;
+    return configIndex().dirs.contains(qMakePair(fwMajor, fwMinor));
 }
 
 bool Utility::configLoad(OpenroadInterface *openroad, int fwMajor, int fwMinor)
 {
-    QDirIterator it("://res/config");
+    QString dir = configIndex().dirs.value(qMakePair(fwMajor, fwMinor));
 
-    while (it.hasNext()) {
-        QFileInfo fi(it.next());
-        QStringList names = fi.fileName().split("_o_");
-
-        if (fi.isDir()) {
-            for(auto name: names) {
-                auto parts = name.split(".");
-                if (parts.size() == 2) {
-                    int major = parts.at(0).toInt();
-                    int minor = parts.at(1).toInt();
-                    if (major == fwMajor && minor == fwMinor) {
-                        QFileInfo fMc(it.filePath() + "/parameters_mcconf.xml");
-                        QFileInfo fApp(it.filePath() + "/parameters_appconf.xml");
-                        QFileInfo fInfo(it.filePath() + "/info.xml");
-
-                        if (fMc.exists() && fApp.exists() && fInfo.exists()) {
-                            openroad->mcConfig()->loadParamsXml(fMc.absoluteFilePath());
-                            openroad->appConfig()->loadParamsXml(fApp.absoluteFilePath());
-                            openroad->infoConfig()->loadParamsXml(fInfo.absoluteFilePath());
-                            openroad->emitConfigurationChanged();
-                            return true;
-                        } else {
-                            qWarning() << "Configurations not found in firmware directory" << it.path();
-                            return false;
-                        }
-                    }
-                }
-            }
-        }
+    if (dir.isEmpty()) {
+        return false;
     }
 
-    return false;
+    QFileInfo fMc(dir + "/parameters_mcconf.xml");
+    QFileInfo fApp(dir + "/parameters_appconf.xml");
+    QFileInfo fInfo(dir + "/info.xml");
+
+    if (fMc.exists() && fApp.exists() && fInfo.exists()) {
+        openroad->mcConfig()->loadParamsCached(fMc.absoluteFilePath());
+        openroad->appConfig()->loadParamsCached(fApp.absoluteFilePath());
+        openroad->infoConfig()->loadParamsCached(fInfo.absoluteFilePath());
+        openroad->emitConfigurationChanged();
+        return true;
+    } else {
+        qWarning() << "Configurations not found in firmware directory" << dir;
+        return false;
+    }
 }
 
 QPair<int, int> Utility::configLatestSupported()
 {
-    QPair<int, int> res = qMakePair(-1, -1);
-    QDirIterator it("://res/config");
-
-    while (it.hasNext()) {
-        QFileInfo fi(it.next());
-        QStringList names = fi.fileName().split("_o_");
-
-        if (fi.isDir()) {
-            for(auto name: names) {
-                auto parts = name.split(".");
-                if (parts.size() == 2) {
-                    QPair<int, int> ver = qMakePair(parts.at(0).toInt(), parts.at(1).toInt());
-                    if (ver > res) {
-                        res = ver;
-                    }
-                }
-            }
-        }
-    }
-
-    return res;
+    return configIndex().latest;
 }
 
 bool Utility::configLoadLatest(OpenroadInterface *openroad)
@@ -1522,26 +1567,7 @@ bool Utility::configLoadLatest(OpenroadInterface *openroad)
 
 QVector<QPair<int, int> > Utility::configSupportedFws()
 {
-    QVector<QPair<int, int>> res;
-    QDirIterator it("://res/config");
-
-    while (it.hasNext()) {
-        QFileInfo fi(it.next());
-        QStringList names = fi.fileName().split("_o_");
-
-        if (fi.isDir()) {
-            for(auto name: names) {
-                auto parts = name.split(".");
-                if (parts.size() == 2) {
-                    int major = parts.at(0).toInt();
-                    int minor = parts.at(1).toInt();
-                    res.append(qMakePair(major, minor));
-                }
-            }
-        }
-    }
-
-    return res;
+    return configIndex().fws;
 }
 
 bool Utility::configLoadCompatible(OpenroadInterface *openroad, QString &uuidRx)
@@ -1583,3 +1609,107 @@ bool Utility::configLoadCompatible(OpenroadInterface *openroad, QString &uuidRx)
 
     return res;
 }
+
+/**
+ * @brief Utility::configLoadCompatibleRead
+ * Same as configLoadCompatible followed by readConfs, but the motor and
+ * app configurations are requested together with the firmware version.
+ * Their responses are held by Commands until the firmware version has
+ * arrived. When the loaded definitions support that firmware, which is
+ * the usual case when going through the VESCs on the CAN-bus, they are
+ * parsed and the target costs one round trip. Otherwise they are
+ * dropped, the definitions are loaded and the configurations are read
+ * again. Failures are reported with a message dialog.
+ *
+ * @return
+ * true when the definitions and both configurations of the target are
+ * loaded.
+ */
+bool Utility::configLoadCompatibleRead(OpenroadInterface *openroad, QString &uuidRx, int timeoutMs)
+{
+    VT_TRACE_SCOPE_CAT("Utility::configLoadCompatibleRead", "loop");
+    QEventLoop loop;
+    QTimer timeoutTimer;
+    timeoutTimer.setSingleShot(true);
+
+    bool fwDone = false;
+    bool fwMatch = false;
+    bool mcHeld = false;
+    bool appHeld = false;
+    bool mcDone = false;
+    bool appDone = false;
+    QPair<int, int> fw;
+
+    auto checkDone = [&]() {
+        if (fwDone && (!fwMatch || (mcHeld && appHeld))) {
+            loop.quit();
+        }
+    };
+
+    auto conn1 = connect(openroad->commands(), &Commands::fwVersionReceived,
+            [&](int major, int minor, QString hw, QByteArray uuid, bool isPaired) {
+        (void)hw;(void)isPaired;
+        fw = qMakePair(major, minor);
+        fwMatch = openroad->getSupportedFirmwarePairs().contains(fw);
+        uuidRx = uuid2Str(uuid, true).toUpper();
+        uuidRx.replace(" ", "");
+        fwDone = true;
+        checkDone();
+    });
+    auto conn2 = connect(openroad->commands(), &Commands::confResponseHeld,
+            [&](bool isMc, bool isApp) {
+        mcHeld = mcHeld || isMc;
+        appHeld = appHeld || isApp;
+        checkDone();
+    });
+    auto conn3 = connect(openroad->mcConfig(), &ConfigParams::updated, [&]() {
+        mcDone = true;
+    });
+    auto conn4 = connect(openroad->appConfig(), &ConfigParams::updated, [&]() {
+        appDone = true;
+    });
+    auto conn5 = connect(&timeoutTimer, SIGNAL(timeout()), &loop, SLOT(quit()));
+
+    disconnect(openroad->commands(), SIGNAL(fwVersionReceived(int,int,QString,QByteArray,bool)),
+               openroad, SLOT(fwVersionReceived(int,int,QString,QByteArray,bool)));
+
+    openroad->commands()->holdConfResponses();
+    openroad->commands()->getFwVersion();
+    openroad->commands()->getMcconf();
+    openroad->commands()->getAppConf();
+
+    timeoutTimer.start(timeoutMs);
+    loop.exec();
+
+    disconnect(conn1);
+    disconnect(conn2);
+    disconnect(conn5);
+
+    connect(openroad->commands(), SIGNAL(fwVersionReceived(int,int,QString,QByteArray,bool)),
+            openroad, SLOT(fwVersionReceived(int,int,QString,QByteArray,bool)));
+
+    // Parses what was read with the definitions it was read for, or
+    // drops it and everything that is still on the way.
+    openroad->commands()->releaseConfResponses(fwDone && fwMatch);
+    disconnect(conn3);
+    disconnect(conn4);
+
+    if (!fwDone) {
+        openroad->emitMessageDialog("Load Config", "No response when reading firmware version.", false, false);
+        return false;
+    }
+
+    if (!fwMatch) {
+        if (!configLoad(openroad, fw.first, fw.second)) {
+            openroad->emitMessageDialog("Load Config", "Could not load configuration parser.", false, false);
+            return false;
+        }
+    }
+
+    if ((!mcDone || !appDone) && !readConfs(openroad, !mcDone, !appDone, false, timeoutMs)) {
+        openroad->emitMessageDialog("Load Config", "Reading configuration timed out.", false, false);
+        return false;
+    }
+
+    return true;
+}
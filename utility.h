@@ -25,6 +25,8 @@
 #include <cstdint>
 #include "openroadinterface.h"
 
+class QWidget;
+
 #define FE_WGS84        (1.0/298.257223563) // earth flattening (WGS84)
 #define RE_WGS84        6378137.0           // earth semimajor axis (WGS84) (m)
 
@@ -38,15 +40,17 @@ public:
     static double map(double x, double in_min, double in_max, double out_min, double out_max);
     static float throttle_curve(float val, float curve_acc, float curve_brake, int mode);
     static bool autoconnectBlockingWithProgress(OpenroadInterface *openroad, QWidget *parent = nullptr);
-    Q_INVOKABLE static void checkVersion(OpenroadInterface *openroad = nullptr);
     Q_INVOKABLE static QString fwChangeLog();
     Q_INVOKABLE static QString openroadToolChangeLog();
-    Q_INVOKABLE static QString aboutText();
     Q_INVOKABLE static QString uuid2Str(QByteArray uuid, bool space);
     Q_INVOKABLE static bool requestFilePermission();
     Q_INVOKABLE static void keepScreenOn(bool on);
     Q_INVOKABLE static bool waitSignal(QObject *sender, QString signal, int timeoutMs);
     Q_INVOKABLE static void sleepWithEventLoop(int timeMs);
+    Q_INVOKABLE static bool readConfs(OpenroadInterface *openroad, bool mc, bool app,
+                                      bool defaults = false, int timeoutMs = 1500);
+    static bool writeConfs(OpenroadInterface *openroad, bool mc, bool app, int timeoutMs = 2000,
+                           bool *mcOk = nullptr, bool *appOk = nullptr);
     Q_INVOKABLE static QString detectAllFoc(OpenroadInterface *openroad,
                                             bool detect_can, double max_power_loss, double min_current_in,
                                             double max_current_in, double openloop_rpm, double sl_erpm);
@@ -70,6 +74,7 @@ public:
     static void xyzToLlh(double x, double y, double z, double *lat, double *lon, double *height);
     static void createEnuMatrix(double lat, double lon, double *enuMat);
     static void llhToEnu(const double *iLlh, const double *llh, double *xyz);
+    static void llhToEnu(const double *iLlh, const double *llh, double *xyz, int count);
     static void enuToLlh(const double *iLlh, const double *xyz, double *llh);
 
     static bool configCheckCompatibility(int fwMajor, int fwMinor);
@@ -78,6 +83,7 @@ public:
     static bool configLoadLatest(OpenroadInterface *openroad);
     static QVector<QPair<int, int>> configSupportedFws();
     static bool configLoadCompatible(OpenroadInterface *openroad, QString &uuidRx);
+    static bool configLoadCompatibleRead(OpenroadInterface *openroad, QString &uuidRx, int timeoutMs = 1500);
 
     template<typename QEnum>
     static QString QEnumToQString (const QEnum value) {
@@ -0,0 +1,117 @@
+/*
+    Copyright 2017 - 2019 Benjamin Vedder	benjamin@vedder.se
+
+    This file is part of VESC Tool.
+
+    VESC Tool is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    VESC Tool is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+    */
+
+#include "utilityapp.h"
+#include <QProgressDialog>
+#include <QEventLoop>
+#include <QNetworkAccessManager>
+#include <QNetworkRequest>
+#include <QNetworkReply>
+#include <QUrl>
+#include <QDebug>
+
+/*
+ * The parts of Utility that depend on QtWidgets or on the version and
+ * edition of the application. They are only built into the application,
+ * not into the core library.
+ */
+
+UtilityApp::UtilityApp(QObject *parent) : Utility(parent)
+{
+
+}
+
+bool Utility::autoconnectBlockingWithProgress(OpenroadInterface *openroad, QWidget *parent)
+{
+    if (!openroad) {
+        return false;
+    }
+
+    QProgressDialog dialog("Autoconnecting...", QString(), 0, 0, parent);
+    dialog.setWindowModality(Qt::WindowModal);
+    dialog.show();
+
+    bool res = openroad->autoconnect();
+
+    if (!res) {
+        openroad->emitMessageDialog(QObject::tr("Autoconnect"),
+                                QObject::tr("Could not autoconnect. Make sure that the USB cable is plugged in "
+                                            "and that the VESC is powered."),
+                                false);
+    }
+
+    return res;
+}
+
+void UtilityApp::checkVersion(OpenroadInterface *openroad)
+{
+    QString version = QString::number(VT_VERSION);
+    QUrl url("https://openroad-project.com/openroadtool-version.html");
+    QNetworkAccessManager manager;
+    QNetworkRequest request(url);
+    QNetworkReply *reply = manager.get(request);
+    QEventLoop loop;
+    QObject::connect(reply, SIGNAL(finished()), &loop, SLOT(quit()));
+    loop.exec();
+
+    QString res = QString::fromUtf8(reply->readAll());
+
+    if (res.startsWith("openroadtoolversion")) {
+        res.remove(0, 15);
+        res.remove(res.indexOf("openroadtoolversion"), res.size());
+
+        if (res.toDouble() > version.toDouble()) {
+            if (openroad) {
+                openroad->emitStatusMessage("A new version of VESC Tool is available", true);
+                openroad->emitMessageDialog(QObject::tr("New Software Available"),
+                                        QObject::tr("A new version of VESC Tool is available. Go to "
+                                                    "<a href=\"http://openroad-project.com/\">http://openroad-project.com/</a>"
+                                                    " to download it and get all the latest features."),
+                                        true);
+            } else {
+                qDebug() << "A new version of VESC Tool is available. Go to openroad-project.com to download it "
+                            "and get all the latest features.";
+            }
+        }
+    } else {
+        qWarning() << res;
+    }
+}
+
+QString UtilityApp::aboutText()
+{
+    return tr("<b>VESC® Tool %1</b><br>"
+          #if defined(VER_ORIGINAL)
+              "Original Version<br>"
+          #elif defined(VER_PLATINUM)
+              "Platinum Version<br>"
+          #elif defined(VER_GOLD)
+              "Gold Version<br>"
+          #elif defined(VER_SILVER)
+              "Silver Version<br>"
+          #elif defined(VER_BRONZE)
+              "Bronze Version<br>"
+          #elif defined(VER_FREE)
+              "Free of Charge Version<br>"
+          #endif
+              "&copy; Benjamin Vedder 2016 - 2019<br>"
+              "<a href=\"mailto:benjamin@vedder.se\">benjamin@vedder.se</a><br>"
+              "<a href=\"https://openroad-project.com/\">https://openroad-project.com/</a>").
+            arg(QString::number(VT_VERSION, 'f', 2));
+}
@@ -0,0 +1,42 @@
+/*
+    Copyright 2020 Benjamin Vedder	benjamin@vedder.se
+
+    This file is part of VESC Tool.
+
+    VESC Tool is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    VESC Tool is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+    */
+
+#ifndef UTILITYAPP_H
+#define UTILITYAPP_H
+
+#include "utility.h"
+
+/*
+ * The invokable parts of Utility that depend on the version and edition
+ * of the application. They are kept out of the meta-object of Utility, as
+ * that is built into the core library, where they are not defined.
+ */
+class UtilityApp : public Utility
+{
+    Q_OBJECT
+
+public:
+    explicit UtilityApp(QObject *parent = nullptr);
+
+    Q_INVOKABLE static void checkVersion(OpenroadInterface *openroad = nullptr);
+    Q_INVOKABLE static QString aboutText();
+
+};
+
+#endif // UTILITYAPP_H
@@ -35,20 +35,8 @@ CONFIG += c++11
 # sudo rm -rf /var/lib/bluetooth/*
 # sudo service bluetooth restart
 
-# Bluetooth available
-DEFINES += HAS_BLUETOOTH
-
-# CAN bus available
-# Adding serialbus to Qt seems to break the serial port on static builds. TODO: Figure out why.
-#DEFINES += HAS_CANBUS
-
-# Positioning
-DEFINES += HAS_POS
-
-!android: {
-    # Serial port available
-    DEFINES += HAS_SERIALPORT
-}
+# Optional features (bluetooth, CAN bus, positioning, serial port)
+include(features.pri)
 
 # Options
 #CONFIG += build_original
@@ -64,22 +52,7 @@ QT       += printsupport
 QT       += network
 QT       += quick
 QT       += quickcontrols2
-
-contains(DEFINES, HAS_SERIALPORT) {
-    QT       += serialport
-}
-
-contains(DEFINES, HAS_CANBUS) {
-    QT       += serialbus
-}
-
-contains(DEFINES, HAS_BLUETOOTH) {
-    QT       += bluetooth
-}
-
-contains(DEFINES, HAS_POS) {
-    QT       += positioning
-}
+QT       += concurrent
 
 android: QT += androidextras
 
@@ -151,52 +124,30 @@ build_mobile {
 
 SOURCES += main.cpp\
         mainwindow.cpp \
-    packet.cpp \
-    vbytearray.cpp \
-    commands.cpp \
-    configparams.cpp \
-    configparam.cpp \
-    openroadinterface.cpp \
     parametereditor.cpp \
-    digitalfiltering.cpp \
     setupwizardapp.cpp \
     setupwizardmotor.cpp \
     startupwizard.cpp \
-    utility.cpp \
-    tcpserversimple.cpp
+    utilityapp.cpp \
+    configparamseditors.cpp
 
 HEADERS  += mainwindow.h \
-    packet.h \
-    vbytearray.h \
-    commands.h \
-    datatypes.h \
-    configparams.h \
-    configparam.h \
-    openroadinterface.h \
     parametereditor.h \
-    digitalfiltering.h \
     setupwizardapp.h \
     setupwizardmotor.h \
     startupwizard.h \
-    utility.h \
-    tcpserversimple.h
+    utilityapp.h
 
 FORMS    += mainwindow.ui \
     parametereditor.ui
 
-contains(DEFINES, HAS_BLUETOOTH) {
-    SOURCES += bleuart.cpp
-    HEADERS += bleuart.h
-}
-
+include(core.pri)
 include(pages/pages.pri)
 include(widgets/widgets.pri)
 include(mobile/mobile.pri)
 include(map/map.pri)
-include(lzokay/lzokay.pri)
 
 RESOURCES += res.qrc
-RESOURCES += res_config.qrc
 
 build_original {
     RESOURCES += res_original.qrc \
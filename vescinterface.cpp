@@ -18,11 +18,13 @@
     */
 
 #include "openroadinterface.h"
+#include "eventtrace.h"
 #include <QDebug>
 #include <QHostInfo>
 #include <QFileInfo>
 #include <QThread>
 #include <QEventLoop>
+#include <QElapsedTimer>
 #include <utility.h>
 #include <cmath>
 #include <QRegularExpression>
@@ -30,6 +32,9 @@
 #include <QDir>
 #include <cmath>
 #include "lzokay/lzokay.hpp"
+#include <QBuffer>
+#include <QStandardPaths>
+#include <QSaveFile>
 
 #ifdef HAS_SERIALPORT
 #include <QSerialPortInfo>
@@ -54,6 +59,9 @@ OpenroadInterface::OpenroadInterface(QObject *parent) : QObject(parent)
     mFwConfig = new ConfigParams(this);
     mPacket = new Packet(this);
     mCommands = new Commands(this);
+    mLinkMetrics = new LinkMetrics(this);
+    mPacket->setMetrics(mLinkMetrics);
+    mCommands->setMetrics(mLinkMetrics);
 
     // Compatible firmwares
     mFwVersionReceived = false;
@@ -61,6 +69,7 @@ OpenroadInterface::OpenroadInterface(QObject *parent) : QObject(parent)
     mFwPollCnt = 0;
     mFwTxt = "x.x";
     mFwPair = qMakePair(-1, -1);
+    mUuidCanId = -1;
     mIsUploadingFw = false;
     mIsLastFwBootloader = false;
     mFwSupportsConfiguration = false;
@@ -135,6 +144,8 @@ OpenroadInterface::OpenroadInterface(QObject *parent) : QObject(parent)
     mPosSource = nullptr;
 #endif
 
+    mRtLogLzo = nullptr;
+
     // TCP
     mTcpSocket = new QTcpSocket(this);
     mTcpConnected = false;
@@ -209,20 +220,8 @@ OpenroadInterface::OpenroadInterface(QObject *parent) : QObject(parent)
         mSettings.endArray();
     }
 
-    {
-        int size = mSettings.beginReadArray("configurationBackups");
-        for (int i = 0; i < size; ++i) {
-            CONFIG_BACKUP cfg;
-            mSettings.setArrayIndex(i);
-            QString uuid = mSettings.value("uuid").toString();
-            cfg.openroad_uuid = uuid;
-            cfg.mcconf_xml_compressed = mSettings.value("mcconf").toString();
-            cfg.appconf_xml_compressed = mSettings.value("appconf").toString();
-            cfg.name = mSettings.value("name", QString("")).toString();
-            mConfigurationBackups.insert(uuid, cfg);
-        }
-        mSettings.endArray();
-    }
+    mConfBackups = ConfBackupStore::shared();
+    confImportSettingsBackups();
 
     mUseImperialUnits = mSettings.value("useImperialUnits", false).toBool();
     mKeepScreenOn = mSettings.value("keepScreenOn", true).toBool();
@@ -245,6 +244,14 @@ OpenroadInterface::OpenroadInterface(QObject *parent) : QObject(parent)
     connect(mMcConfig, SIGNAL(updated()), this, SLOT(mcconfUpdated()));
     connect(mAppConfig, SIGNAL(updated()), this, SLOT(appconfUpdated()));
 
+    // Only what was read from the VESC is cached, not the defaults
+    connect(mCommands, &Commands::mcConfigRead, [this]() {
+        confCacheStore(mMcConfig, "mcconf");
+    });
+    connect(mCommands, &Commands::appConfigRead, [this]() {
+        confCacheStore(mAppConfig, "appconf");
+    });
+
     connect(mCommands, &Commands::valuesSetupReceived, [this](SETUP_VALUES v) {
         mLastSetupValues = v;
         mLastSetupTime = QDateTime::currentDateTimeUtc();
@@ -255,8 +262,8 @@ OpenroadInterface::OpenroadInterface(QObject *parent) : QObject(parent)
         mLastImuTime = QDateTime::currentDateTimeUtc();
     });
 
-    connect(mCommands, &Commands::valuesReceived, [this](MC_VALUES v) {
-        if (mRtLogFile.isOpen()) {
+    connect(mCommands, &Commands::valuesReceived, [this](MC_VALUES v, unsigned int mask) {
+        if (mRtLogFile.isOpen() && (mask & Commands::VALUES_ALL) == Commands::VALUES_ALL) {
             int msPos = -1;
             double lat = 0.0;
             double lon = 0.0;
@@ -296,7 +303,7 @@ OpenroadInterface::OpenroadInterface(QObject *parent) : QObject(parent)
 #endif
 
             auto t = QDateTime::currentDateTimeUtc().time();
-            QTextStream os(&mRtLogFile);
+            QTextStream os(mRtLogLzo ? static_cast<QIODevice*>(mRtLogLzo) : &mRtLogFile);
 
             int msSetup = -1;
             if (mLastSetupTime.isValid()) {
@@ -385,6 +392,7 @@ OpenroadInterface::OpenroadInterface(QObject *parent) : QObject(parent)
             d.hAcc = hAcc;
             d.vAcc = vAcc;
             mRtLogData.append(d);
+            mRtLogIndex.append(d);
         }
     });
 
@@ -405,6 +413,15 @@ OpenroadInterface::OpenroadInterface(QObject *parent) : QObject(parent)
                               false, false);
         }
     });
+
+    connect(mCommands, &Commands::confWriteBlocked, [this](bool isMc, bool isApp) {
+        (void)isApp;
+        QString configName = isMc ? "motor" : "app";
+        emitMessageDialog("Write " + configName + " configuration",
+                          "The " + configName + " configuration shown is from the cache "
+                          "and has not been read from the VESC yet. Read it before writing.",
+                          false, false);
+    });
 }
 
 OpenroadInterface::~OpenroadInterface()
@@ -424,6 +441,15 @@ Commands *OpenroadInterface::commands() const
     return mCommands;
 }
 
+/**
+ * @brief OpenroadInterface::linkMetrics
+ * Traffic, decoding error and round trip time metrics of the connection.
+ */
+LinkMetrics *OpenroadInterface::linkMetrics() const
+{
+    return mLinkMetrics;
+}
+
 ConfigParams *OpenroadInterface::mcConfig()
 {
     return mMcConfig;
@@ -461,7 +487,7 @@ QList<QPair<int, int> > OpenroadInterface::getSupportedFirmwarePairs()
 {
     QList<QPair<int, int> > fws;
 
-    ConfigParam *p = mInfoConfig->getParam("fw_version");
+    const ConfigParam *p = mInfoConfig->getParam("fw_version");
 
     if (p) {
         QStringList strs = p->enumNames;
@@ -542,23 +568,6 @@ void OpenroadInterface::storeSettings()
     }
     mSettings.endArray();
 
-    mSettings.remove("configurationBackups");
-    {
-        mSettings.beginWriteArray("configurationBackups");
-        QHashIterator<QString, CONFIG_BACKUP> i(mConfigurationBackups);
-        int ind = 0;
-        while (i.hasNext()) {
-            i.next();
-            mSettings.setArrayIndex(ind);
-            mSettings.setValue("uuid", i.key());
-            mSettings.setValue("mcconf", i.value().mcconf_xml_compressed);
-            mSettings.setValue("appconf", i.value().appconf_xml_compressed);
-            mSettings.setValue("name", i.value().name);
-            ind++;
-        }
-        mSettings.endArray();
-    }
-
     mSettings.setValue("useImperialUnits", mUseImperialUnits);
     mSettings.setValue("keepScreenOn", mKeepScreenOn);
     mSettings.setValue("useWakeLock", mUseWakeLock);
@@ -1374,8 +1383,24 @@ bool OpenroadInterface::isCurrentFwBootloader()
     return mIsLastFwBootloader;
 }
 
-bool OpenroadInterface::openRtLogFile(QString outDirectory)
+/**
+ * @brief OpenroadInterface::openRtLogFile
+ * Start logging realtime data to a new file in outDirectory.
+ *
+ * @param outDirectory
+ * The directory to create the log file in.
+ *
+ * @param compressed
+ * Write the log in LZO-compressed blocks (LzoLogDevice) instead of as plain
+ * CSV. loadRtLogFile reads both formats.
+ *
+ * @return
+ * true if the file could be opened.
+ */
+bool OpenroadInterface::openRtLogFile(QString outDirectory, bool compressed)
 {
+    closeRtLogFile();
+
     if (outDirectory.startsWith("file:/")) {
         outDirectory.remove(0, 6);
     }
@@ -1392,19 +1417,35 @@ bool OpenroadInterface::openRtLogFile(QString outDirectory)
     }
 
     QDateTime d = QDateTime::currentDateTime();
-    mRtLogFile.setFileName(QString("%1/%2-%3-%4_%5-%6-%7.csv").
+    mRtLogFile.setFileName(QString("%1/%2-%3-%4_%5-%6-%7.%8").
                            arg(outDirectory).
                            arg(d.date().year(), 2, 10, QChar('0')).
                            arg(d.date().month(), 2, 10, QChar('0')).
                            arg(d.date().day(), 2, 10, QChar('0')).
                            arg(d.time().hour(), 2, 10, QChar('0')).
                            arg(d.time().minute(), 2, 10, QChar('0')).
-                           arg(d.time().second(), 2, 10, QChar('0')));
+                           arg(d.time().second(), 2, 10, QChar('0')).
+                           arg(compressed ? LzoLogDevice::fileSuffix() : "csv"));
 
-    bool res = mRtLogFile.open(QIODevice::WriteOnly | QIODevice::Text);
+    bool res = false;
+
+    if (compressed) {
+        res = mRtLogFile.open(QIODevice::WriteOnly);
+        if (res) {
+            mRtLogLzo = new LzoLogDevice(&mRtLogFile, this);
+            res = mRtLogLzo->open(QIODevice::WriteOnly);
+            if (!res) {
+                delete mRtLogLzo;
+                mRtLogLzo = nullptr;
+                mRtLogFile.close();
+            }
+        }
+    } else {
+        res = mRtLogFile.open(QIODevice::WriteOnly | QIODevice::Text);
+    }
 
     if (mRtLogFile.isOpen()) {
-        QTextStream os(&mRtLogFile);
+        QTextStream os(mRtLogLzo ? static_cast<QIODevice*>(mRtLogLzo) : &mRtLogFile);
         os << "ms_today" << ";";
         os << "input_voltage" << ";";
         os << "temp_mos_max" << ";";
@@ -1474,8 +1515,13 @@ bool OpenroadInterface::openRtLogFile(QString outDirectory)
     }
 
     mRtLogData.clear();
+    mRtLogIndex.clear();
+    emit rtLogDataReset();
 
     if (res) {
+        // Every row of the log has all values
+        mCommands->subscribeValues(this, Commands::VALUES_ALL);
+
 #ifdef HAS_POS
         if (mPosSource != nullptr) {
             mPosSource->deleteLater();
@@ -1500,6 +1546,14 @@ bool OpenroadInterface::openRtLogFile(QString outDirectory)
 
 void OpenroadInterface::closeRtLogFile()
 {
+    mCommands->unsubscribeValues(this);
+
+    if (mRtLogLzo) {
+        mRtLogLzo->close();
+        delete mRtLogLzo;
+        mRtLogLzo = nullptr;
+    }
+
     if (mRtLogFile.isOpen()) {
         mRtLogFile.close();
     }
@@ -1515,51 +1569,134 @@ QVector<LOG_DATA> OpenroadInterface::getRtLogData()
     return mRtLogData;
 }
 
+/**
+ * @brief OpenroadInterface::getRtLogDataSince
+ * Get the realtime log samples from index start, so that a view of a log
+ * that is being recorded only has to copy the new samples.
+ */
+QVector<LOG_DATA> OpenroadInterface::getRtLogDataSince(int start)
+{
+    if (start <= 0) {
+        return mRtLogData;
+    }
+
+    return mRtLogData.mid(start);
+}
+
+int OpenroadInterface::getRtLogSize()
+{
+    return mRtLogData.size();
+}
+
 bool OpenroadInterface::loadRtLogFile(QString file)
 {
     bool res = false;
+    bool complete = true;
 
+    if (readRtLogFile(file, mRtLogData, &complete)) {
+        if (!complete) {
+            emitStatusMessage("Compressed log is truncated, loading the readable part", false);
+        }
+
+        mRtLogIndex.build(mRtLogData);
+        emit rtLogDataReset();
+        res = true;
+
+        emitStatusMessage(QString("Loaded %1 log entries").arg(mRtLogData.size()), true);
+    } else {
+        emitMessageDialog("Read Log File",
+                          "Could not open\n" +
+                          file +
+                          "\nfor reading.",
+                          false, false);
+    }
+
+    return res;
+}
+
+/**
+ * @brief OpenroadInterface::readRtLogFile
+ * Parse a realtime log file, plain or compressed. Does not touch any
+ * state of the interface, so it can be used from worker threads.
+ *
+ * @param file
+ * Path of the log file.
+ *
+ * @param data
+ * The samples of the log are stored here.
+ *
+ * @param complete
+ * If not null, set to false when a compressed log is truncated. The
+ * readable part is still returned in data.
+ *
+ * @return
+ * false if the file could not be opened.
+ */
+bool OpenroadInterface::readRtLogFile(QString file, QVector<LOG_DATA> &data, bool *complete)
+{
     QFile inFile(file);
+    QByteArray decompressed;
+    QBuffer decompressedBuffer(&decompressed);
 
-    if (inFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        QTextStream in(&inFile);
-        int lineNum = 0;
+    if (complete) {
+        *complete = true;
+    }
+
+    // Opened in binary mode as the file can be compressed. readLine
+    // handles both line endings for CSV files.
+    if (!inFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
 
-        mRtLogData.clear();
-        while (!in.atEnd()) {
-            QStringList tokens = in.readLine().split(";");
+    QIODevice *inDev = &inFile;
 
-            if (tokens.size() < 22) {
-                continue;
-            }
+    if (LzoLogDevice::isCompressed(&inFile)) {
+        if (!LzoLogDevice::decompressAll(&inFile, decompressed) && complete) {
+            *complete = false;
+        }
 
-            if (lineNum > 0) {
-                LOG_DATA d;
-                d.valTime = tokens.at(0).toInt();
-                d.values.v_in = tokens.at(1).toDouble();
-                d.values.temp_mos = tokens.at(2).toDouble();
-                d.values.temp_mos_1 = tokens.at(3).toDouble();
-                d.values.temp_mos_2 = tokens.at(4).toDouble();
-                d.values.temp_mos_3 = tokens.at(5).toDouble();
-                d.values.temp_motor = tokens.at(6).toDouble();
-                d.values.current_motor = tokens.at(7).toDouble();
-                d.values.current_in = tokens.at(8).toDouble();
-                d.values.id = tokens.at(9).toDouble();
-                d.values.iq = tokens.at(10).toDouble();
-                d.values.rpm = tokens.at(11).toDouble();
-                d.values.duty_now = tokens.at(12).toDouble();
-                d.values.amp_hours = tokens.at(13).toDouble();
-                d.values.amp_hours_charged = tokens.at(14).toDouble();
-                d.values.watt_hours = tokens.at(15).toDouble();
-                d.values.watt_hours_charged = tokens.at(16).toDouble();
-                d.values.tachometer = tokens.at(17).toInt();
-                d.values.tachometer_abs = tokens.at(18).toInt();
-                d.values.position = tokens.at(19).toDouble();
-                d.values.fault_code = mc_fault_code(tokens.at(20).toInt());
-                d.values.openroad_id = tokens.at(21).toInt();
-
-                // Possibly populate setup values too, but these values would
-                // not correspond to setupValTime.
+        decompressedBuffer.open(QIODevice::ReadOnly);
+        inDev = &decompressedBuffer;
+    }
+
+    QTextStream in(inDev);
+    int lineNum = 0;
+
+    data.clear();
+    while (!in.atEnd()) {
+        QStringList tokens = in.readLine().split(";");
+
+        if (tokens.size() < 22) {
+            continue;
+        }
+
+        if (lineNum > 0) {
+            LOG_DATA d;
+            d.valTime = tokens.at(0).toInt();
+            d.values.v_in = tokens.at(1).toDouble();
+            d.values.temp_mos = tokens.at(2).toDouble();
+            d.values.temp_mos_1 = tokens.at(3).toDouble();
+            d.values.temp_mos_2 = tokens.at(4).toDouble();
+            d.values.temp_mos_3 = tokens.at(5).toDouble();
+            d.values.temp_motor = tokens.at(6).toDouble();
+            d.values.current_motor = tokens.at(7).toDouble();
+            d.values.current_in = tokens.at(8).toDouble();
+            d.values.id = tokens.at(9).toDouble();
+            d.values.iq = tokens.at(10).toDouble();
+            d.values.rpm = tokens.at(11).toDouble();
+            d.values.duty_now = tokens.at(12).toDouble();
+            d.values.amp_hours = tokens.at(13).toDouble();
+            d.values.amp_hours_charged = tokens.at(14).toDouble();
+            d.values.watt_hours = tokens.at(15).toDouble();
+            d.values.watt_hours_charged = tokens.at(16).toDouble();
+            d.values.tachometer = tokens.at(17).toInt();
+            d.values.tachometer_abs = tokens.at(18).toInt();
+            d.values.position = tokens.at(19).toDouble();
+            d.values.fault_code = mc_fault_code(tokens.at(20).toInt());
+            d.values.openroad_id = tokens.at(21).toInt();
+
+            // Possibly populate setup values too, but these values would
+            // not correspond to setupValTime.
 //                d.setupValues.v_in = d.values.v_in;
 //                d.setupValues.duty_now = d.values.duty_now;
 //                d.setupValues.temp_mos = d.values.temp_mos;
@@ -1567,64 +1704,53 @@ bool OpenroadInterface::loadRtLogFile(QString file)
 //                d.setupValues.fault_code = d.values.fault_code;
 //                d.setupValues.openroad_id = d.values.openroad_id;
 
-                if (tokens.size() >= 55) {
-                    d.values.vd = tokens.at(22).toDouble();
-                    d.values.vq = tokens.at(23).toDouble();
-
-                    d.setupValTime = tokens.at(24).toInt();
-                    d.setupValues.amp_hours = tokens.at(25).toDouble();
-                    d.setupValues.amp_hours_charged = tokens.at(26).toDouble();
-                    d.setupValues.watt_hours = tokens.at(27).toDouble();
-                    d.setupValues.watt_hours_charged = tokens.at(28).toDouble();
-                    d.setupValues.battery_level = tokens.at(29).toDouble();
-                    d.setupValues.battery_wh = tokens.at(30).toDouble();
-                    d.setupValues.current_in = tokens.at(31).toDouble();
-                    d.setupValues.current_motor = tokens.at(32).toDouble();
-                    d.setupValues.speed = tokens.at(33).toDouble();
-                    d.setupValues.tachometer = tokens.at(34).toDouble();
-                    d.setupValues.tachometer_abs = tokens.at(35).toDouble();
-                    d.setupValues.num_openroads = tokens.at(36).toInt();
-
-                    d.imuValTime = tokens.at(37).toInt();
-                    d.imuValues.roll = tokens.at(38).toDouble();
-                    d.imuValues.pitch = tokens.at(39).toDouble();
-                    d.imuValues.yaw = tokens.at(40).toDouble();
-                    d.imuValues.accX = tokens.at(41).toDouble();
-                    d.imuValues.accY = tokens.at(42).toDouble();
-                    d.imuValues.accZ = tokens.at(43).toDouble();
-                    d.imuValues.gyroX = tokens.at(44).toDouble();
-                    d.imuValues.gyroY = tokens.at(45).toDouble();
-                    d.imuValues.gyroZ = tokens.at(46).toDouble();
-
-                    d.posTime = tokens.at(47).toInt();
-                    d.lat = tokens.at(48).toDouble();
-                    d.lon = tokens.at(49).toDouble();
-                    d.alt = tokens.at(50).toDouble();
-                    d.gVel = tokens.at(51).toDouble();
-                    d.vVel = tokens.at(52).toDouble();
-                    d.hAcc = tokens.at(53).toDouble();
-                    d.vAcc = tokens.at(54).toDouble();
-                }
-
-                mRtLogData.append(d);
+            if (tokens.size() >= 55) {
+                d.values.vd = tokens.at(22).toDouble();
+                d.values.vq = tokens.at(23).toDouble();
+
+                d.setupValTime = tokens.at(24).toInt();
+                d.setupValues.amp_hours = tokens.at(25).toDouble();
+                d.setupValues.amp_hours_charged = tokens.at(26).toDouble();
+                d.setupValues.watt_hours = tokens.at(27).toDouble();
+                d.setupValues.watt_hours_charged = tokens.at(28).toDouble();
+                d.setupValues.battery_level = tokens.at(29).toDouble();
+                d.setupValues.battery_wh = tokens.at(30).toDouble();
+                d.setupValues.current_in = tokens.at(31).toDouble();
+                d.setupValues.current_motor = tokens.at(32).toDouble();
+                d.setupValues.speed = tokens.at(33).toDouble();
+                d.setupValues.tachometer = tokens.at(34).toDouble();
+                d.setupValues.tachometer_abs = tokens.at(35).toDouble();
+                d.setupValues.num_openroads = tokens.at(36).toInt();
+
+                d.imuValTime = tokens.at(37).toInt();
+                d.imuValues.roll = tokens.at(38).toDouble();
+                d.imuValues.pitch = tokens.at(39).toDouble();
+                d.imuValues.yaw = tokens.at(40).toDouble();
+                d.imuValues.accX = tokens.at(41).toDouble();
+                d.imuValues.accY = tokens.at(42).toDouble();
+                d.imuValues.accZ = tokens.at(43).toDouble();
+                d.imuValues.gyroX = tokens.at(44).toDouble();
+                d.imuValues.gyroY = tokens.at(45).toDouble();
+                d.imuValues.gyroZ = tokens.at(46).toDouble();
+
+                d.posTime = tokens.at(47).toInt();
+                d.lat = tokens.at(48).toDouble();
+                d.lon = tokens.at(49).toDouble();
+                d.alt = tokens.at(50).toDouble();
+                d.gVel = tokens.at(51).toDouble();
+                d.vVel = tokens.at(52).toDouble();
+                d.hAcc = tokens.at(53).toDouble();
+                d.vAcc = tokens.at(54).toDouble();
             }
 
-            lineNum++;
+            data.append(d);
         }
 
-        inFile.close();
-        res = true;
-
-        emitStatusMessage(QString("Loaded %1 log entries").arg(lineNum - 1), true);
-    } else {
-        emitMessageDialog("Read Log File",
-                          "Could not open\n" +
-                          file +
-                          "\nfor reading.",
-                          false, false);
+        lineNum++;
     }
 
-    return res;
+    inFile.close();
+    return true;
 }
 
 LOG_DATA OpenroadInterface::getRtLogSample(double progress)
@@ -1639,25 +1765,30 @@ LOG_DATA OpenroadInterface::getRtLogSample(double progress)
     return d;
 }
 
+/**
+ * @brief OpenroadInterface::getRtLogSampleAtValTimeFromStart
+ * Get the first sample that is at least time ms after the start of the log.
+ *
+ * @return
+ * The sample. When time is beyond the end of the log the first sample is
+ * returned, as before the log was indexed.
+ */
 LOG_DATA OpenroadInterface::getRtLogSampleAtValTimeFromStart(int time)
 {
     LOG_DATA d;
 
-    if (mRtLogData.size() > 0) {
-        d = mRtLogData.first();
-        int startTime = d.valTime;
+    if (mRtLogData.isEmpty()) {
+        return d;
+    }
 
-        for (LOG_DATA dn: mRtLogData) {
-            int timeMs = dn.valTime - startTime;
-            if (timeMs < 0) { // Handle midnight
-                timeMs += 60 * 60 * 24;
-            }
+    int last = mRtLogData.size() - 1;
+    int ind = 0;
+    if (time <= mRtLogIndex.timeMsRange(0, last)) {
+        ind = mRtLogIndex.indexAtTime(time);
+    }
 
-            if (timeMs >= time) {
-                d = dn;
-                break;
-            }
-        }
+    if (ind >= 0 && ind < mRtLogData.size()) {
+        d = mRtLogData.at(ind);
     }
 
     return d;
@@ -2225,6 +2356,8 @@ void OpenroadInterface::scanCANbus()
     frame.setFlexibleDataRateFormat(false);
     frame.setBitrateSwitch(false);
 
+    VT_TRACE_SCOPE_CAT("OpenroadInterface::scanCANbus", "can");
+
     QEventLoop loop;
     QTimer pollTimer;
     pollTimer.start(15);
@@ -2606,6 +2739,8 @@ void OpenroadInterface::timerSlot()
         mWasConnected = isPortConnected();
 
         if (!isPortConnected()) {
+            mLinkMetrics->clearPending();
+
             if (!getSupportedFirmwarePairs().contains(Utility::configLatestSupported())) {
                 Utility::configLoadLatest(this);
             }
@@ -2622,11 +2757,14 @@ void OpenroadInterface::packetDataToSend(QByteArray &data)
 #ifdef HAS_SERIALPORT
     if (mSerialPort->isOpen()) {
         mSerialPort->write(data);
+        mLinkMetrics->txQueueDepth(mSerialPort->bytesToWrite());
     }
 #endif
 
 #ifdef HAS_CANBUS
     if (isCANbusConnected()) {
+        VT_TRACE_SCOPE_CAT("OpenroadInterface::canWrite", "can");
+
         // Sending a frame while a frame is received seems to cause problems,
         // so always delay sending a bit in case a frame that expects a reply
         // was sent just previously. TODO: Figure out what the problem is.
@@ -2732,6 +2870,7 @@ void OpenroadInterface::packetDataToSend(QByteArray &data)
 
     if (mTcpConnected && mTcpSocket->isOpen()) {
         mTcpSocket->write(data);
+        mLinkMetrics->txQueueDepth(mTcpSocket->bytesToWrite());
     }
 
 #ifdef HAS_BLUETOOTH
@@ -2743,6 +2882,7 @@ void OpenroadInterface::packetDataToSend(QByteArray &data)
 
 void OpenroadInterface::packetReceived(QByteArray &data)
 {
+    VT_TRACE_SCOPE("Commands::processPacket");
     mCommands->processPacket(data);
 }
 
@@ -2756,6 +2896,7 @@ void OpenroadInterface::fwVersionReceived(int major, int minor, QString hw, QByt
     QString uuidStr = Utility::uuid2Str(uuid, true);
     mUuidStr = uuidStr.toUpper();
     mUuidStr.replace(" ", "");
+    mUuidCanId = mCommands->getSendCan() ? mCommands->getCanSendId() : -1;
     mFwSupportsConfiguration = false;
 
 #ifdef HAS_BLUETOOTH
@@ -2982,6 +3123,16 @@ void OpenroadInterface::fwVersionReceived(int major, int minor, QString hw, QByt
         emit statusMessage(fwStr, true);
     }
 
+    // Show the configurations from the last connection until they are read
+    // again, which the pages do when they have not received them yet.
+    if (mFwVersionReceived && mFwSupportsConfiguration &&
+            !mUuidStr.isEmpty() && mUuidStr != mConfCacheUuid) {
+        mConfCacheUuid = mUuidStr;
+        if (confCacheLoad(mUuidStr)) {
+            emit statusMessage(tr("Configuration loaded from cache, reading from VESC"), true);
+        }
+    }
+
     if (major >= 0) {
         mFwTxt.sprintf("Fw: %d.%d", major, minor);
         mFwPair = qMakePair(major, minor);
@@ -3035,33 +3186,25 @@ bool OpenroadInterface::confStoreBackup(bool can, QString name)
     QStringList uuidsOk;
 
     auto storeConf = [this, &uuidsOk, &name]() {
+        QElapsedTimer nodeTime;
+        nodeTime.start();
+
         QString uuid;
-        if (!Utility::configLoadCompatible(this, uuid)) {
+        if (!Utility::configLoadCompatibleRead(this, uuid, 1500)) {
             return false;
         }
 
-        uuidsOk.append(uuid);
-
-        ConfigParams *pMc = mcConfig();
-        ConfigParams *pApp = appConfig();
-
-        commands()->getMcconf();
-        bool rxMc = Utility::waitSignal(pMc, SIGNAL(updated()), 1500);
-        commands()->getAppConf();
-        bool rxApp = Utility::waitSignal(pApp, SIGNAL(updated()), 1500);
+        CONFIG_BACKUP cfg;
+        cfg.name = name;
+        cfg.openroad_uuid = uuid;
+        cfg.mcconf_xml_compressed = mcConfig()->saveCompressed("mcconf");
+        cfg.appconf_xml_compressed = appConfig()->saveCompressed("appconf");
+        mConfBackups->add(cfg);
 
-        if (rxMc && rxApp) {
-            CONFIG_BACKUP cfg;
-            cfg.name = name;
-            cfg.openroad_uuid = uuid;
-            cfg.mcconf_xml_compressed = pMc->saveCompressed("mcconf");
-            cfg.appconf_xml_compressed = pApp->saveCompressed("appconf");
-            mConfigurationBackups.insert(uuid, cfg);
-            return true;
-        } else {
-            emitMessageDialog("Backup Configuration", "Reading configuration timed out.", false, false);
-            return false;
-        }
+        uuidsOk.append(QString("%1 (%2 ms)").arg(uuid).arg(nodeTime.elapsed()));
+        emit statusMessage(QString("Stored backup of %1 in %2 ms").
+                           arg(uuid).arg(nodeTime.elapsed()), true);
+        return true;
     };
 
     bool res = true;
@@ -3095,7 +3238,6 @@ bool OpenroadInterface::confStoreBackup(bool can, QString name)
     }
 
     if (res) {
-        storeSettings();
         emit configurationBackupsChanged();
 
         QString uuidsStr;
@@ -3111,6 +3253,45 @@ bool OpenroadInterface::confStoreBackup(bool can, QString name)
     return res;
 }
 
+/**
+ * @brief OpenroadInterface::confReloadBackups
+ * Read the index of the configuration backups again, e.g. after another
+ * instance of VESC Tool has stored backups. The interfaces of this process
+ * share the backups, so they do not have to reload them for each other.
+ */
+void OpenroadInterface::confReloadBackups()
+{
+    mConfBackups->reload();
+    confImportSettingsBackups();
+}
+
+/**
+ * @brief OpenroadInterface::confImportSettingsBackups
+ * Move configuration backups stored in the settings by older versions
+ * of VESC Tool to the backup store.
+ */
+void OpenroadInterface::confImportSettingsBackups()
+{
+    quint64 mark = mConfBackups->writeMark();
+    int size = mSettings.beginReadArray("configurationBackups");
+    for (int i = 0; i < size; ++i) {
+        CONFIG_BACKUP cfg;
+        mSettings.setArrayIndex(i);
+        cfg.openroad_uuid = mSettings.value("uuid").toString();
+        cfg.mcconf_xml_compressed = mSettings.value("mcconf").toString();
+        cfg.appconf_xml_compressed = mSettings.value("appconf").toString();
+        cfg.name = mSettings.value("name", QString("")).toString();
+        mConfBackups->add(cfg);
+    }
+    mSettings.endArray();
+
+    // Only removed once the store has them on disk, so that they are
+    // imported again next time if something goes wrong before that.
+    if (size > 0 && mConfBackups->waitForWrites(mark)) {
+        mSettings.remove("configurationBackups");
+    }
+}
+
 bool OpenroadInterface::confRestoreBackup(bool can)
 {
     if (!isPortConnected()) {
@@ -3122,38 +3303,36 @@ bool OpenroadInterface::confRestoreBackup(bool can)
     QStringList uuidsOk;
 
     auto restoreConf = [this, &missingConfigs, &uuidsOk]() {
-        QString uuid;
-        if (!Utility::configLoadCompatible(this, uuid)) {
-            return false;
-        }
+        QElapsedTimer nodeTime;
+        nodeTime.start();
 
+        QString uuid;
         ConfigParams *pMc = mcConfig();
         ConfigParams *pApp = appConfig();
 
-        commands()->getMcconf();
-        bool rxMc = Utility::waitSignal(pMc, SIGNAL(updated()), 2000);
-        commands()->getAppConf();
-        bool rxApp = Utility::waitSignal(pApp, SIGNAL(updated()), 2000);
-
-        if (rxMc && rxApp) {
-            if (mConfigurationBackups.contains(uuid)) {
-                pMc->loadCompressed(mConfigurationBackups[uuid].mcconf_xml_compressed, "mcconf");
-                pApp->loadCompressed(mConfigurationBackups[uuid].appconf_xml_compressed, "appconf");
+        if (Utility::configLoadCompatibleRead(this, uuid, 2000)) {
+            CONFIG_BACKUP cfg;
+            if (mConfBackups->backup(uuid, cfg)) {
+                pMc->loadCompressed(cfg.mcconf_xml_compressed, "mcconf");
+                pApp->loadCompressed(cfg.appconf_xml_compressed, "appconf");
 
                 // Try a few times, as BLE seems to drop the response sometimes.
+                // Only the writes that were not acked are retried.
                 bool txMc = false, txApp = false;
                 for (int i = 0;i < 2;i++) {
-                    commands()->setMcconf(false);
-                    txMc = Utility::waitSignal(commands(), SIGNAL(ackReceived(QString)), 2000);
-                    commands()->setAppConf();
-                    txApp = Utility::waitSignal(commands(), SIGNAL(ackReceived(QString)), 2000);
+                    bool okMc = true, okApp = true;
+                    Utility::writeConfs(this, !txMc, !txApp, 2000, &okMc, &okApp);
+                    txMc = txMc || okMc;
+                    txApp = txApp || okApp;
 
                     if (txApp && txMc) {
                         break;
                     }
                 }
 
-                uuidsOk.append(uuid);
+                uuidsOk.append(QString("%1 (%2 ms)").arg(uuid).arg(nodeTime.elapsed()));
+                emit statusMessage(QString("Restored backup of %1 in %2 ms").
+                                   arg(uuid).arg(nodeTime.elapsed()), true);
 
                 if (!txMc) {
                     emitMessageDialog("Restore Configuration",
@@ -3171,7 +3350,6 @@ bool OpenroadInterface::confRestoreBackup(bool can)
             }
             return true;
         } else {
-            emitMessageDialog("Restore Configuration", "Reading configuration timed out.", false, false);
             return false;
         }
     };
@@ -3207,9 +3385,6 @@ bool OpenroadInterface::confRestoreBackup(bool can)
     }
 
     if (res) {
-        storeSettings();
-        emit configurationBackupsChanged();
-
         if (!uuidsOk.isEmpty()) {
             QString uuidsStr;
             for (auto s: uuidsOk) {
@@ -3236,11 +3411,12 @@ bool OpenroadInterface::confRestoreBackup(bool can)
     return res;
 }
 
-bool OpenroadInterface::confLoadBackup(QString uuid)
+bool OpenroadInterface::confLoadBackup(QString uuid, int version)
 {
-    if (mConfigurationBackups.contains(uuid)) {
-        mMcConfig->loadCompressed(mConfigurationBackups[uuid].mcconf_xml_compressed, "mcconf");
-        mAppConfig->loadCompressed(mConfigurationBackups[uuid].appconf_xml_compressed, "appconf");
+    CONFIG_BACKUP cfg;
+    if (mConfBackups->backup(uuid, cfg, version)) {
+        mMcConfig->loadCompressed(cfg.mcconf_xml_compressed, "mcconf");
+        mAppConfig->loadCompressed(cfg.appconf_xml_compressed, "appconf");
         return true;
     } else {
         return false;
@@ -3249,32 +3425,125 @@ bool OpenroadInterface::confLoadBackup(QString uuid)
 
 QStringList OpenroadInterface::confListBackups()
 {
-    QStringList res;
-    QHashIterator<QString, CONFIG_BACKUP> i(mConfigurationBackups);
-    while (i.hasNext()) {
-        i.next();
-        res.append(i.key());
-    }
-
-    return res;
+    return mConfBackups->uuids();
 }
 
 void OpenroadInterface::confClearBackups()
 {
-    mConfigurationBackups.clear();
-    storeSettings();
+    mConfBackups->clear();
     emit configurationBackupsChanged();
 }
 
 QString OpenroadInterface::confBackupName(QString uuid)
 {
     QString res;
-    if (mConfigurationBackups.contains(uuid)) {
-        res = mConfigurationBackups[uuid].name;
+    auto history = mConfBackups->history(uuid);
+    if (!history.isEmpty()) {
+        res = history.last().name;
     }
     return res;
 }
 
+/**
+ * @brief OpenroadInterface::confBackupHistory
+ * All stored versions of the backup of a VESC, the oldest first.
+ *
+ * @param uuid
+ * UUID of the VESC.
+ *
+ * @return
+ * One map per version with its name and time, in the order used for
+ * the version argument of confLoadBackup.
+ */
+QVariantList OpenroadInterface::confBackupHistory(QString uuid)
+{
+    QVariantList res;
+    for (const auto &v: mConfBackups->history(uuid)) {
+        QVariantMap m;
+        m.insert("name", v.name);
+        m.insert("time", QDateTime::fromMSecsSinceEpoch(v.time));
+        res.append(m);
+    }
+    return res;
+}
+
+/**
+ * @brief OpenroadInterface::confCacheLoad
+ * Load the cached motor and app configurations of a VESC. A cached
+ * configuration is only used when its signature matches the parser that
+ * is loaded, so configurations from other firmwares are ignored. The
+ * updated signals are not emitted, as the configurations still have to
+ * be read from the VESC.
+ *
+ * @param uuid
+ * UUID of the VESC.
+ *
+ * @return
+ * true if at least one of the configurations was loaded.
+ */
+bool OpenroadInterface::confCacheLoad(QString uuid)
+{
+    auto load = [this, &uuid](ConfigParams *config, QString configName) {
+        QFile file(confCachePath(uuid, configName));
+        if (!file.open(QIODevice::ReadOnly)) {
+            return false;
+        }
+
+        VByteArray vb(file.readAll());
+        if (vb.size() < 4 || VByteArray(vb.left(4)).vbPopFrontUint32() != config->getSignature()) {
+            return false;
+        }
+
+        return config->deSerialize(vb);
+    };
+
+    bool mcLoaded = load(mMcConfig, "mcconf");
+    bool appLoaded = load(mAppConfig, "appconf");
+    // Writing them before they are read would send stale values. This
+    // also clears the flags left from another UUID.
+    mCommands->setConfCached(mcLoaded, appLoaded);
+
+    return mcLoaded || appLoaded;
+}
+
+/**
+ * @brief OpenroadInterface::confCacheClear
+ * Remove the cached configurations of all VESCs.
+ */
+void OpenroadInterface::confCacheClear()
+{
+    QDir(QFileInfo(confCachePath("", "")).absolutePath()).removeRecursively();
+    mConfCacheUuid.clear();
+}
+
+QString OpenroadInterface::confCachePath(QString uuid, QString configName) const
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) +
+            "/config_cache/" + uuid + "_" + configName + ".bin";
+}
+
+void OpenroadInterface::confCacheStore(ConfigParams *config, QString configName)
+{
+    // Only cache configurations of the VESC that the UUID belongs to.
+    // Backups read other VESCs on the CAN-bus without updating the UUID.
+    int canId = mCommands->getSendCan() ? mCommands->getCanSendId() : -1;
+    if (mUuidStr.isEmpty() || canId != mUuidCanId || !isPortConnected()) {
+        return;
+    }
+
+    QString path = confCachePath(mUuidStr, configName);
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    VByteArray vb;
+    config->serialize(vb);
+
+    QSaveFile file(path);
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(vb);
+        file.commit();
+    }
+}
+
 bool OpenroadInterface::deserializeFailedSinceConnected()
 {
     return mDeserialFailedMessageShown;
@@ -3284,6 +3553,13 @@ void OpenroadInterface::updateFwRx(bool fwRx)
 {
     bool change = mFwVersionReceived != fwRx;
     mFwVersionReceived = fwRx;
+
+    if (!fwRx) {
+        mConfCacheUuid.clear();
+        mCommands->forgetConfState();
+        mCommands->setConfCached(false, false);
+    }
+
     if (change) {
         emit fwRxChanged(mFwVersionReceived, mCommands->isLimitedMode());
     }
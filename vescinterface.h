@@ -43,6 +43,10 @@
 #include "commands.h"
 #include "packet.h"
 #include "tcpserversimple.h"
+#include "logindex.h"
+#include "lzologdevice.h"
+#include "linkmetrics.h"
+#include "confbackupstore.h"
 
 #ifdef HAS_BLUETOOTH
 #include "bleuart.h"
@@ -65,6 +69,7 @@ public:
     explicit OpenroadInterface(QObject *parent = nullptr);
     ~OpenroadInterface();
     Q_INVOKABLE Commands *commands() const;
+    Q_INVOKABLE LinkMetrics *linkMetrics() const;
     Q_INVOKABLE ConfigParams *mcConfig();
     Q_INVOKABLE ConfigParams *appConfig();
     Q_INVOKABLE ConfigParams *infoConfig();
@@ -130,11 +135,14 @@ public:
     Q_INVOKABLE bool isCurrentFwBootloader();
 
     // Logging
-    Q_INVOKABLE bool openRtLogFile(QString outDirectory);
+    Q_INVOKABLE bool openRtLogFile(QString outDirectory, bool compressed = false);
     Q_INVOKABLE void closeRtLogFile();
     Q_INVOKABLE bool isRtLogOpen();
     Q_INVOKABLE QVector<LOG_DATA> getRtLogData();
+    Q_INVOKABLE QVector<LOG_DATA> getRtLogDataSince(int start);
+    Q_INVOKABLE int getRtLogSize();
     Q_INVOKABLE bool loadRtLogFile(QString file);
+    static bool readRtLogFile(QString file, QVector<LOG_DATA> &data, bool *complete = nullptr);
     Q_INVOKABLE LOG_DATA getRtLogSample(double progress);
     Q_INVOKABLE LOG_DATA getRtLogSampleAtValTimeFromStart(int time);
 
@@ -189,10 +197,16 @@ public:
     // Configuration backups
     Q_INVOKABLE bool confStoreBackup(bool can, QString name = "");
     Q_INVOKABLE bool confRestoreBackup(bool can);
-    Q_INVOKABLE bool confLoadBackup(QString uuid);
+    Q_INVOKABLE void confReloadBackups();
+    Q_INVOKABLE bool confLoadBackup(QString uuid, int version = -1);
     Q_INVOKABLE QStringList confListBackups();
     Q_INVOKABLE void confClearBackups();
     Q_INVOKABLE QString confBackupName(QString uuid);
+    Q_INVOKABLE QVariantList confBackupHistory(QString uuid);
+
+    // Cache of the last read configurations of each VESC
+    Q_INVOKABLE bool confCacheLoad(QString uuid);
+    Q_INVOKABLE void confCacheClear();
 
     Q_INVOKABLE bool deserializeFailedSinceConnected();
 
@@ -212,6 +226,7 @@ signals:
     void useImperialUnitsChanged(bool useImperialUnits);
     void configurationChanged();
     void configurationBackupsChanged();
+    void rtLogDataReset();
 
 public slots:
 
@@ -255,7 +270,7 @@ private:
 
     QSettings mSettings;
     QHash<QString, QString> mBleNames;
-    QHash<QString, CONFIG_BACKUP> mConfigurationBackups;
+    QSharedPointer<ConfBackupStore> mConfBackups;
     QVariantList mProfiles;
     QStringList mPairedUuids;
     TcpServerSimple *mTcpServer;
@@ -268,6 +283,7 @@ private:
     QTimer *mTimer;
     Packet *mPacket;
     Commands *mCommands;
+    LinkMetrics *mLinkMetrics;
     bool mFwVersionReceived;
     bool mDeserialFailedMessageShown;
     int mFwRetries;
@@ -276,6 +292,8 @@ private:
     QPair<int, int> mFwPair;
     QString mHwTxt;
     QString mUuidStr;
+    int mUuidCanId;
+    QString mConfCacheUuid;
     bool mIsUploadingFw;
     bool mIsLastFwBootloader;
     bool mFwSupportsConfiguration;
@@ -330,7 +348,9 @@ private:
     bool mWakeLockActive;
 
     QFile mRtLogFile;
+    LzoLogDevice *mRtLogLzo;
     QVector<LOG_DATA> mRtLogData;
+    LogIndex mRtLogIndex;
     IMU_VALUES mLastImuValues;
     QDateTime mLastImuTime;
     SETUP_VALUES mLastSetupValues;
@@ -351,6 +371,9 @@ private:
     bool mUseWakeLock;
 
     void updateFwRx(bool fwRx);
+    QString confCachePath(QString uuid, QString configName) const;
+    void confCacheStore(ConfigParams *config, QString configName);
+    void confImportSettingsBackups();
     void setLastConnectionType(conn_t type);
 
 };
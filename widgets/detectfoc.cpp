@@ -121,6 +121,8 @@ void DetectFoc::setOpenroad(OpenroadInterface *openroad)
                 this, SLOT(motorLinkageReceived(double)));
         connect(mOpenroad->mcConfig(), SIGNAL(paramChangedDouble(QObject*,QString,double)),
                 this, SLOT(paramChangedDouble(QObject*,QString,double)));
+        connect(mOpenroad->mcConfig(), SIGNAL(paramsChanged(QObject*,QStringList)),
+                this, SLOT(paramsChanged(QObject*,QStringList)));
 
         ui->currentBox->setValue(mOpenroad->mcConfig()->getParamDouble("l_current_max") / 3.0);
     }
@@ -193,6 +195,13 @@ void DetectFoc::paramChangedDouble(QObject *src, QString name, double newParam)
     }
 }
 
+void DetectFoc::paramsChanged(QObject *src, QStringList names)
+{
+    if (names.contains("l_current_max")) {
+        paramChangedDouble(src, "l_current_max", mOpenroad->mcConfig()->getParamDouble("l_current_max"));
+    }
+}
+
 void DetectFoc::on_applyAllButton_clicked()
 {
     if (mOpenroad) {
@@ -44,6 +44,7 @@ private slots:
     void motorRLReceived(double r, double l);
     void motorLinkageReceived(double flux_linkage);
     void paramChangedDouble(QObject *src, QString name, double newParam);
+    void paramsChanged(QObject *src, QStringList names);
 
     void on_rlButton_clicked();
     void on_lambdaButton_clicked();
@@ -40,7 +40,7 @@ HelpDialog::~HelpDialog()
 
 void HelpDialog::showHelp(QWidget *parent, ConfigParams *params, QString name, bool modal)
 {
-    ConfigParam *param = params->getParam(name);
+    const ConfigParam *param = params->getParam(name);
 
     if (param) {
         HelpDialog *h = new HelpDialog(param->longName,
@@ -34,10 +34,10 @@ ParamDialog::ParamDialog(QString title,
     mConfig = *params;
 
     for (QString s: names) {
-        ConfigParam *p = mConfig.getParam(s);
-
-        if (p) {
-            p->transmittable = false; // To hide the read buttons.
+        if (mConfig.hasParam(s)) {
+            ConfigParam p = mConfig.getParamCopy(s);
+            p.transmittable = false; // To hide the read buttons.
+            mConfig.setParam(s, p);
             ui->paramTable->addParamRow(&mConfig, s);
         }
     }
@@ -38,7 +38,7 @@ void ParamEditBool::setConfig(ConfigParams *config)
 {
     mConfig = config;
 
-    ConfigParam *param = mConfig->getParam(mName);
+    const ConfigParam *param = mConfig->getParam(mName);
 
     if (param) {
         ui->readButton->setVisible(param->transmittable);
@@ -48,6 +48,8 @@ void ParamEditBool::setConfig(ConfigParams *config)
 
     connect(mConfig, SIGNAL(paramChangedBool(QObject*,QString,bool)),
             this, SLOT(paramChangedBool(QObject*,QString,bool)));
+    connect(mConfig, SIGNAL(paramsChanged(QObject*,QStringList)),
+            this, SLOT(paramsChanged(QObject*,QStringList)));
 }
 
 QString ParamEditBool::name() const
@@ -67,6 +69,13 @@ void ParamEditBool::paramChangedBool(QObject *src, QString name, bool newParam)
     }
 }
 
+void ParamEditBool::paramsChanged(QObject *src, QStringList names)
+{
+    if (names.contains(mName)) {
+        paramChangedBool(src, mName, mConfig->getParamBool(mName));
+    }
+}
+
 void ParamEditBool::on_readButton_clicked()
 {
     if (mConfig) {
@@ -63,7 +63,7 @@ void ParamEditDouble::setConfig(ConfigParams *config)
 {
     mConfig = config;
 
-    ConfigParam *param = mConfig->getParam(mName);
+    const ConfigParam *param = mConfig->getParam(mName);
 
     if (param) {
         ui->readButton->setVisible(param->transmittable);
@@ -93,6 +93,8 @@ void ParamEditDouble::setConfig(ConfigParams *config)
 
     connect(mConfig, SIGNAL(paramChangedDouble(QObject*,QString,double)),
             this, SLOT(paramChangedDouble(QObject*,QString,double)));
+    connect(mConfig, SIGNAL(paramsChanged(QObject*,QStringList)),
+            this, SLOT(paramsChanged(QObject*,QStringList)));
 }
 
 QString ParamEditDouble::name() const
@@ -135,6 +137,13 @@ void ParamEditDouble::paramChangedDouble(QObject *src, QString name, double newP
     }
 }
 
+void ParamEditDouble::paramsChanged(QObject *src, QStringList names)
+{
+    if (names.contains(mName)) {
+        paramChangedDouble(src, mName, mConfig->getParamDouble(mName));
+    }
+}
+
 void ParamEditDouble::percentageChanged(int p)
 {
     if (mParam.editAsPercentage) {
@@ -48,6 +48,7 @@ public:
 
 private slots:
     void paramChangedDouble(QObject *src, QString name, double newParam);
+    void paramsChanged(QObject *src, QStringList names);
     void percentageChanged(int p);
     void doubleChanged(double d);
 
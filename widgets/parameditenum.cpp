@@ -39,7 +39,7 @@ void ParamEditEnum::setConfig(ConfigParams *config)
 {
     mConfig = config;
 
-    ConfigParam *param = mConfig->getParam(mName);
+    const ConfigParam *param = mConfig->getParam(mName);
 
     if (param) {
         ui->readButton->setVisible(param->transmittable);
@@ -54,6 +54,8 @@ void ParamEditEnum::setConfig(ConfigParams *config)
 
     connect(mConfig, SIGNAL(paramChangedEnum(QObject*,QString,int)),
             this, SLOT(paramChangedEnum(QObject*,QString,int)));
+    connect(mConfig, SIGNAL(paramsChanged(QObject*,QStringList)),
+            this, SLOT(paramsChanged(QObject*,QStringList)));
 }
 
 QString ParamEditEnum::name() const
@@ -73,6 +75,13 @@ void ParamEditEnum::paramChangedEnum(QObject *src, QString name, int newParam)
     }
 }
 
+void ParamEditEnum::paramsChanged(QObject *src, QStringList names)
+{
+    if (names.contains(mName)) {
+        paramChangedEnum(src, mName, mConfig->getParamEnum(mName));
+    }
+}
+
 void ParamEditEnum::on_readButton_clicked()
 {
     if (mConfig) {
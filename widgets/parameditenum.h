@@ -40,6 +40,7 @@ public:
 
 private slots:
     void paramChangedEnum(QObject *src, QString name, int newParam);
+    void paramsChanged(QObject *src, QStringList names);
 
     void on_readButton_clicked();
     void on_readDefaultButton_clicked();
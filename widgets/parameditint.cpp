@@ -63,7 +63,7 @@ void ParamEditInt::setConfig(ConfigParams *config)
 {
     mConfig = config;
 
-    ConfigParam *param = mConfig->getParam(mName);
+    const ConfigParam *param = mConfig->getParam(mName);
 
     if (param) {
         ui->readButton->setVisible(param->transmittable);
@@ -93,6 +93,8 @@ void ParamEditInt::setConfig(ConfigParams *config)
 
     connect(mConfig, SIGNAL(paramChangedInt(QObject*,QString,int)),
             this, SLOT(paramChangedInt(QObject*,QString,int)));
+    connect(mConfig, SIGNAL(paramsChanged(QObject*,QStringList)),
+            this, SLOT(paramsChanged(QObject*,QStringList)));
 }
 
 QString ParamEditInt::name() const
@@ -128,6 +130,13 @@ void ParamEditInt::paramChangedInt(QObject *src, QString name, int newParam)
     }
 }
 
+void ParamEditInt::paramsChanged(QObject *src, QStringList names)
+{
+    if (names.contains(mName)) {
+        paramChangedInt(src, mName, mConfig->getParamInt(mName));
+    }
+}
+
 void ParamEditInt::percentageChanged(int p)
 {
     if (mParam.editAsPercentage) {
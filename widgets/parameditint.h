@@ -46,6 +46,7 @@ public:
 
 private slots:
     void paramChangedInt(QObject *src, QString name, int newParam);
+    void paramsChanged(QObject *src, QStringList names);
     void percentageChanged(int p);
     void intChanged(int i);
 
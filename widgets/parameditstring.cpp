@@ -37,7 +37,7 @@ void ParamEditString::setConfig(ConfigParams *config)
 {
     mConfig = config;
 
-    ConfigParam *param = mConfig->getParam(mName);
+    const ConfigParam *param = mConfig->getParam(mName);
 
     if (param) {
         ui->valueEdit->setText(param->valString);
@@ -45,6 +45,8 @@ void ParamEditString::setConfig(ConfigParams *config)
 
     connect(mConfig, SIGNAL(paramChangedQString(QObject*,QString,QString)),
             this, SLOT(paramChangedQString(QObject*,QString,QString)));
+    connect(mConfig, SIGNAL(paramsChanged(QObject*,QStringList)),
+            this, SLOT(paramsChanged(QObject*,QStringList)));
 }
 
 QString ParamEditString::name() const
@@ -64,6 +66,13 @@ void ParamEditString::paramChangedQString(QObject *src, QString name, QString ne
     }
 }
 
+void ParamEditString::paramsChanged(QObject *src, QStringList names)
+{
+    if (names.contains(mName)) {
+        paramChangedQString(src, mName, mConfig->getParamQString(mName));
+    }
+}
+
 void ParamEditString::on_helpButton_clicked()
 {
     if (mConfig) {
@@ -40,6 +40,7 @@ public:
 
 private slots:
     void paramChangedQString(QObject *src, QString name, QString newParam);
+    void paramsChanged(QObject *src, QStringList names);
 
     void on_helpButton_clicked();
     void on_valueEdit_textChanged(const QString &arg1);
@@ -48,7 +48,7 @@ void PpmMap::setOpenroad(OpenroadInterface *openroad)
     mOpenroad = openroad;
 
     if (mOpenroad) {
-        ConfigParam *p = mOpenroad->appConfig()->getParam("app_ppm_conf.ctrl_type");
+        const ConfigParam *p = mOpenroad->appConfig()->getParam("app_ppm_conf.ctrl_type");
         if (p) {
             ui->controlTypeBox->addItems(p->enumNames);
         }